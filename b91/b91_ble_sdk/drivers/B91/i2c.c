@@ -335,7 +335,7 @@ void i2c_master_read_dma(unsigned char id, unsigned char *data, unsigned char le
     reg_i2c_id = (id | FLD_I2C_WRITE_READ_BIT);  // BIT(0):R:High  W:Low
 
     dma_set_size(i2c_dma_rx_chn, len, DMA_WORD_WIDTH);
-    dma_set_address(i2c_dma_rx_chn, reg_i2c_data_buf0_addr, (unsigned int)convert_ram_addr_cpu2bus(rx_data));
+    dma_set_address(i2c_dma_rx_chn, reg_i2c_data_buf0_addr, (unsigned int)convert_ram_addr_cpu2bus(data));
     dma_chn_en(i2c_dma_rx_chn);
 
     reg_i2c_len = len;
@@ -21,20 +21,57 @@
 #include "hdf_device_desc.h"
 #include "osal.h"
 
+#include <string.h>
+
 #include <B91/gpio.h>
+#include <B91/stimer.h>
 
+#include <b91_gpio.h>
 #include <b91_irq.h>
 
+#if defined(LOSCFG_TELINK_B91_WORK)
+#include <b91_work.h>
+#endif /* LOSCFG_TELINK_B91_WORK */
+
 #define GPIO_INDEX_MAX ((sizeof(g_GpioIndexToActualPin) / sizeof(gpio_pin_e)))
 
+#define GPIO_PORT_PINS 8
+#define GPIO_PORT_NUM  6 /* 6: PA..PF */
+#define GPIO_NO_LOCAL  0xFF
+
+/*
+ * Pins listed in the optional fastPins HCS attribute get gpio2risc0/gpio2risc1 to themselves.
+ * The key scanner keeps gpio2risc1 for its row edges.
+ */
+#if defined(LOSCFG_TELINK_B91_KEYSCAN)
+#define GPIO_FAST_LANES 1
+#else /* LOSCFG_TELINK_B91_KEYSCAN */
+#define GPIO_FAST_LANES 2
+#endif /* LOSCFG_TELINK_B91_KEYSCAN */
+
+#ifndef LOSCFG_TELINK_B91_GPIO_EVENT_QUEUE_SIZE
+#define LOSCFG_TELINK_B91_GPIO_EVENT_QUEUE_SIZE 32
+#endif /* LOSCFG_TELINK_B91_GPIO_EVENT_QUEUE_SIZE */
+
+#define GPIO_EVENT_QUEUE_SIZE LOSCFG_TELINK_B91_GPIO_EVENT_QUEUE_SIZE
+#define GPIO_EVENT_PINS       8
+
+/* The hardware triggers on one edge only: the ISR flips the polarity after each edge */
+#define GPIO_IRQ_TRIGGER_BOTH (GPIO_IRQ_TRIGGER_RISING | GPIO_IRQ_TRIGGER_FALLING)
+
 struct B91GpioCntlr {
     struct GpioCntlr cntlr;
 
     uint8_t *pinReflectionMap;
 
-    struct {
-        bool irq_enabled;
-    }* config;
+    /* actual pin index -> HDF index, GPIO_NO_LOCAL for pins not exposed through HDF */
+    uint8_t localIndex[GPIO_PORT_NUM * GPIO_PORT_PINS];
+    uint8_t portMask;
+
+    uint8_t fastLocal[GPIO_FAST_LANES];
+
+    uint8_t bothEdgeMask[GPIO_PORT_NUM];
+    uint8_t levelMask[GPIO_PORT_NUM];
 
     uint8_t pinNum;
 };
@@ -141,17 +178,344 @@ struct GpioMethod g_GpioCntlrMethod = {
     .disableIrq = GpioDevDisableIrq,
 };
 
-_attribute_ram_code_ static void GpioIrqHandler(void)
+/*
+ * The hardware ORs (in ^ pol) & irq_en of all pins into one interrupt line and has no
+ * per-pin status, so the pins that fired are the ones currently in their active state.
+ * In edge mode a pulse may already be over when the handler runs; if no pin is active,
+ * every enabled pin is reported rather than losing the event.
+ */
+_attribute_ram_code_ static void GpioIrqCollect(uint8_t pending[GPIO_PORT_NUM])
+{
+    const struct B91GpioCntlr *pB91GpioCntlr = &g_B91GpioCntlr;
+    uint8_t fired = 0;
+
+    for (uint32_t port = 0; port < GPIO_PORT_NUM; ++port) {
+        if ((pB91GpioCntlr->portMask & BIT(port)) == 0) {
+            continue;
+        }
+
+        gpio_pin_e group = (gpio_pin_e)(port << 8);
+        uint8_t active = (reg_gpio_in(group) ^ reg_gpio_pol(group)) & reg_gpio_irq_en(group);
+        pending[port] |= active;
+        fired |= active;
+    }
+
+    if ((fired == 0) && !(reg_gpio_irq_risc_mask & FLD_GPIO_IRQ_LVL_GPIO)) {
+        for (uint32_t port = 0; port < GPIO_PORT_NUM; ++port) {
+            if (pB91GpioCntlr->portMask & BIT(port)) {
+                pending[port] |= reg_gpio_irq_en((gpio_pin_e)(port << 8));
+            }
+        }
+    }
+}
+
+static void GpioIrqDispatch(const uint8_t pending[GPIO_PORT_NUM])
 {
     struct B91GpioCntlr *pB91GpioCntlr = &g_B91GpioCntlr;
 
-    for (size_t i = 0; i < pB91GpioCntlr->pinNum; ++i) {
-        if (pB91GpioCntlr->config[i].irq_enabled) {
-            GpioCntlrIrqCallback(&pB91GpioCntlr->cntlr, i);
+    for (uint32_t port = 0; port < GPIO_PORT_NUM; ++port) {
+        uint32_t bits = pending[port];
+        while (bits != 0) {
+            uint32_t index = port * GPIO_PORT_PINS + __builtin_ctz(bits);
+            bits &= bits - 1;
+
+            if (pB91GpioCntlr->localIndex[index] != GPIO_NO_LOCAL) {
+                GpioCntlrIrqCallback(&pB91GpioCntlr->cntlr, pB91GpioCntlr->localIndex[index]);
+            }
+        }
+    }
+}
+
+/* Fast lanes bypass both the port scan and the deferred work task */
+_attribute_ram_code_ static void GpioRisc0IrqHandler(void)
+{
+    GpioCntlrIrqCallback(&g_B91GpioCntlr.cntlr, g_B91GpioCntlr.fastLocal[0]);
+    gpio_clr_irq_status(FLD_GPIO_IRQ_GPIO2RISC0_CLR);
+}
+
+#if !defined(LOSCFG_TELINK_B91_KEYSCAN)
+_attribute_ram_code_ static void GpioRisc1IrqHandler(void)
+{
+    GpioCntlrIrqCallback(&g_B91GpioCntlr.cntlr, g_B91GpioCntlr.fastLocal[1]);
+    gpio_clr_irq_status(FLD_GPIO_IRQ_GPIO2RISC1_CLR);
+}
+#endif /* LOSCFG_TELINK_B91_KEYSCAN */
+
+static const struct {
+    irq_source_e irq;
+    HWI_PROC_FUNC handler;
+} g_gpioFastLanes[GPIO_FAST_LANES] = {
+    {IRQ26_GPIO2RISC0, (HWI_PROC_FUNC)GpioRisc0IrqHandler},
+#if !defined(LOSCFG_TELINK_B91_KEYSCAN)
+    {IRQ27_GPIO2RISC1, (HWI_PROC_FUNC)GpioRisc1IrqHandler},
+#endif /* LOSCFG_TELINK_B91_KEYSCAN */
+};
+
+static int32_t GpioFastLaneGet(const struct B91GpioCntlr *pB91GpioCntlr, uint16_t local)
+{
+    for (int32_t lane = 0; lane < GPIO_FAST_LANES; ++lane) {
+        if (pB91GpioCntlr->fastLocal[lane] == local) {
+            return lane;
+        }
+    }
+
+    return -1;
+}
+
+struct GpioEventPin {
+    uint32_t debounceTicks;
+    uint32_t acceptTick;
+    uint32_t rawTick;
+    uint8_t local;
+    uint8_t index;
+    uint8_t stable;
+    uint8_t raw;
+};
+
+struct GpioRawEvent {
+    uint32_t tick;
+    uint8_t index;
+    uint8_t level;
+};
+
+/*
+ * Event capture for the pins listed in the eventPins HCS attribute. The ISR only stamps
+ * raw edges into the ring; debouncing runs in the reader, see B91GpioEventRead.
+ */
+static struct {
+    struct GpioRawEvent ring[GPIO_EVENT_QUEUE_SIZE];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    uint32_t lost;
+    struct GpioEventPin pins[GPIO_EVENT_PINS];
+    uint8_t pinNum;
+    uint8_t captureMask[GPIO_PORT_NUM];
+} g_gpioEvents;
+
+_attribute_ram_code_ static void GpioEventCapture(const uint8_t pending[GPIO_PORT_NUM])
+{
+    uint32_t tick = stimer_get_tick();
+
+    for (uint32_t port = 0; port < GPIO_PORT_NUM; ++port) {
+        if (pending[port] == 0) {
+            continue;
+        }
+
+        gpio_pin_e group = (gpio_pin_e)(port << 8);
+        uint8_t in = reg_gpio_in(group);
+
+        uint8_t both = pending[port] & g_B91GpioCntlr.bothEdgeMask[port];
+        if (both != 0) {
+            reg_gpio_pol(group) = (reg_gpio_pol(group) & ~both) | (in & both);
+        }
+
+        uint32_t bits = pending[port] & g_gpioEvents.captureMask[port];
+        while (bits != 0) {
+            uint32_t bit = __builtin_ctz(bits);
+            bits &= bits - 1;
+
+            uint32_t head = g_gpioEvents.head;
+            if ((head - g_gpioEvents.tail) >= GPIO_EVENT_QUEUE_SIZE) {
+                ++g_gpioEvents.lost;
+                continue;
+            }
+
+            struct GpioRawEvent *event = &g_gpioEvents.ring[head % GPIO_EVENT_QUEUE_SIZE];
+            event->tick = tick;
+            event->index = port * GPIO_PORT_PINS + bit;
+            event->level = (in >> bit) & 1;
+            g_gpioEvents.head = head + 1;
+        }
+    }
+}
+
+static struct GpioEventPin *GpioEventPinGet(uint8_t index)
+{
+    for (uint32_t i = 0; i < g_gpioEvents.pinNum; ++i) {
+        if (g_gpioEvents.pins[i].index == index) {
+            return &g_gpioEvents.pins[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* An edge is accepted if it changes the level and the pin is outside its debounce window */
+static bool GpioEventFilter(struct GpioEventPin *pin, uint8_t level, uint32_t tick)
+{
+    pin->raw = level;
+    pin->rawTick = tick;
+
+    if ((level == pin->stable) || ((tick - pin->acceptTick) < pin->debounceTicks)) {
+        return false;
+    }
+
+    pin->stable = level;
+    pin->acceptTick = tick;
+    return true;
+}
+
+static void GpioEventEmit(B91GpioEvent *event, const struct GpioEventPin *pin)
+{
+    event->tick = pin->acceptTick;
+    event->gpio = pin->local;
+    event->level = (pin->stable != 0) ? GPIO_VAL_HIGH : GPIO_VAL_LOW;
+}
+
+static void GpioEventPinReset(struct GpioEventPin *pin)
+{
+    pin->stable = gpio_get_level(g_GpioIndexToActualPin[pin->index]);
+    pin->raw = pin->stable;
+    pin->acceptTick = stimer_get_tick() - pin->debounceTicks;
+    pin->rawTick = pin->acceptTick;
+}
+
+int32_t B91GpioEventRead(B91GpioEvent *events, uint32_t max, uint32_t *num)
+{
+    uint32_t n = 0;
+
+    if ((events == NULL) || (num == NULL)) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    while ((n < max) && (g_gpioEvents.tail != g_gpioEvents.head)) {
+        const struct GpioRawEvent *raw = &g_gpioEvents.ring[g_gpioEvents.tail % GPIO_EVENT_QUEUE_SIZE];
+        struct GpioEventPin *pin = GpioEventPinGet(raw->index);
+        if ((pin != NULL) && GpioEventFilter(pin, raw->level, raw->tick)) {
+            GpioEventEmit(&events[n++], pin);
+        }
+        ++g_gpioEvents.tail;
+    }
+
+    /* Report the level a pin settled on after bouncing inside its window */
+    if (g_gpioEvents.tail == g_gpioEvents.head) {
+        uint32_t now = stimer_get_tick();
+        for (uint32_t i = 0; (i < g_gpioEvents.pinNum) && (n < max); ++i) {
+            struct GpioEventPin *pin = &g_gpioEvents.pins[i];
+            if ((pin->raw != pin->stable) && ((now - pin->acceptTick) >= pin->debounceTicks)) {
+                pin->stable = pin->raw;
+                pin->acceptTick = pin->rawTick;
+                GpioEventEmit(&events[n++], pin);
+            }
+        }
+    }
+
+    *num = n;
+    return HDF_SUCCESS;
+}
+
+uint32_t B91GpioEventLostGet(void)
+{
+    return g_gpioEvents.lost;
+}
+
+#if defined(LOSCFG_TELINK_B91_WORK)
+static uint8_t g_gpioPending[GPIO_PORT_NUM];
+/* Level triggered pins keep the line asserted, so they stay masked until their callback ran */
+static uint8_t g_gpioMasked[GPIO_PORT_NUM];
+static volatile bool g_gpioWorkPending = false;
+
+static void GpioIrqWork(UINTPTR arg)
+{
+    uint8_t pending[GPIO_PORT_NUM];
+
+    (void)arg;
+
+    UINT32 intSave = LOS_IntLock();
+    (void)memcpy(pending, g_gpioPending, sizeof(pending));
+    (void)memset(g_gpioPending, 0, sizeof(g_gpioPending));
+    g_gpioWorkPending = false;
+    LOS_IntRestore(intSave);
+
+    GpioIrqDispatch(pending);
+
+    /* A callback that disabled or reconfigured its pin dropped it from g_gpioMasked */
+    intSave = LOS_IntLock();
+    for (uint32_t port = 0; port < GPIO_PORT_NUM; ++port) {
+        uint8_t unmask = g_gpioMasked[port] & pending[port];
+        if (unmask != 0) {
+            g_gpioMasked[port] &= ~unmask;
+            reg_gpio_irq_en((gpio_pin_e)(port << 8)) |= unmask;
         }
     }
+    LOS_IntRestore(intSave);
+}
+
+/* Called with interrupts locked whenever a pin is enabled, disabled or reconfigured */
+static void GpioIrqUnmaskCancel(uint8_t index)
+{
+    g_gpioMasked[index / GPIO_PORT_PINS] &= ~BIT(index % GPIO_PORT_PINS);
+}
+
+/* Callbacks run in the deferred work task, one queued item covers any number of edges */
+_attribute_ram_code_ static void GpioIrqHandler(void)
+{
+    uint8_t pending[GPIO_PORT_NUM] = {0};
 
+    GpioIrqCollect(pending);
+    GpioEventCapture(pending);
+
+    for (uint32_t port = 0; port < GPIO_PORT_NUM; ++port) {
+        uint8_t level = pending[port] & g_B91GpioCntlr.levelMask[port];
+        if (level != 0) {
+            reg_gpio_irq_en((gpio_pin_e)(port << 8)) &= ~level;
+            g_gpioMasked[port] |= level;
+        }
+        g_gpioPending[port] |= pending[port];
+    }
     gpio_clr_irq_status(FLD_GPIO_IRQ_CLR);
+
+    if (!g_gpioWorkPending) {
+        g_gpioWorkPending = (B91WorkPost(GpioIrqWork, 0) == LOS_OK);
+    }
+}
+#else  /* LOSCFG_TELINK_B91_WORK */
+_attribute_ram_code_ static void GpioIrqHandler(void)
+{
+    uint8_t pending[GPIO_PORT_NUM] = {0};
+
+    GpioIrqCollect(pending);
+    GpioEventCapture(pending);
+    GpioIrqDispatch(pending);
+
+    gpio_clr_irq_status(FLD_GPIO_IRQ_CLR);
+}
+
+static void GpioIrqUnmaskCancel(uint8_t index)
+{
+    (void)index;
+}
+#endif /* LOSCFG_TELINK_B91_WORK */
+
+static int32_t GetGpioEventResource(struct B91GpioCntlr *cntlr, struct DeviceResourceIface *dri,
+                                    const struct DeviceResourceNode *resourceNode)
+{
+    uint32_t local;
+    uint32_t debounceUs;
+
+    (void)memset(g_gpioEvents.captureMask, 0, sizeof(g_gpioEvents.captureMask));
+    g_gpioEvents.pinNum = 0;
+
+    int32_t eventNum = dri->GetElemNum(resourceNode, "eventPins");
+    for (int32_t i = 0; (i < eventNum) && (i < GPIO_EVENT_PINS); ++i) {
+        if ((dri->GetUint32ArrayElem(resourceNode, "eventPins", i, &local, 0) != HDF_SUCCESS) ||
+            (local >= cntlr->pinNum) || (cntlr->pinReflectionMap[local] >= GPIO_INDEX_MAX)) {
+            HDF_LOGE("Failed to read eventPins!");
+            return HDF_FAILURE;
+        }
+
+        if (dri->GetUint32ArrayElem(resourceNode, "eventDebounceUs", i, &debounceUs, 0) != HDF_SUCCESS) {
+            debounceUs = 0;
+        }
+
+        struct GpioEventPin *pin = &g_gpioEvents.pins[g_gpioEvents.pinNum++];
+        pin->local = local;
+        pin->index = cntlr->pinReflectionMap[local];
+        pin->debounceTicks = debounceUs * SYSTEM_TIMER_TICK_1US;
+        g_gpioEvents.captureMask[pin->index / GPIO_PORT_PINS] |= BIT(pin->index % GPIO_PORT_PINS);
+    }
+
+    return HDF_SUCCESS;
 }
 
 static int32_t GetGpioDeviceResource(struct B91GpioCntlr *cntlr, const struct DeviceResourceNode *resourceNode)
@@ -176,11 +540,8 @@ static int32_t GetGpioDeviceResource(struct B91GpioCntlr *cntlr, const struct De
         return HDF_ERR_MALLOC_FAIL;
     }
 
-    cntlr->config = OsalMemAlloc(sizeof(cntlr->config[0]) * cntlr->pinNum);
-    if (cntlr->config == NULL) {
-        HDF_LOGE("%s: OsalMemAlloc error", __func__);
-        return HDF_ERR_MALLOC_FAIL;
-    }
+    (void)memset(cntlr->localIndex, GPIO_NO_LOCAL, sizeof(cntlr->localIndex));
+    cntlr->portMask = 0;
 
     for (uint32_t i = 0; i < cntlr->pinNum; i++) {
         if (dri->GetUint32ArrayElem(resourceNode, "pinMap", i, &pinIndex, 0) != HDF_SUCCESS) {
@@ -189,9 +550,26 @@ static int32_t GetGpioDeviceResource(struct B91GpioCntlr *cntlr, const struct De
         }
 
         cntlr->pinReflectionMap[i] = pinIndex;
+        if (pinIndex < GPIO_INDEX_MAX) {
+            cntlr->localIndex[pinIndex] = i;
+            cntlr->portMask |= BIT(pinIndex / GPIO_PORT_PINS);
+        }
     }
 
-    return HDF_SUCCESS;
+    (void)memset(cntlr->fastLocal, GPIO_NO_LOCAL, sizeof(cntlr->fastLocal));
+
+    int32_t fastNum = dri->GetElemNum(resourceNode, "fastPins");
+    for (int32_t lane = 0; (lane < fastNum) && (lane < GPIO_FAST_LANES); ++lane) {
+        if ((dri->GetUint32ArrayElem(resourceNode, "fastPins", lane, &pinIndex, 0) != HDF_SUCCESS) ||
+            (pinIndex >= cntlr->pinNum)) {
+            HDF_LOGE("Failed to read fastPins!");
+            return HDF_FAILURE;
+        }
+
+        cntlr->fastLocal[lane] = pinIndex;
+    }
+
+    return GetGpioEventResource(cntlr, dri, resourceNode);
 }
 
 static int32_t GpioDriverInit(struct HdfDeviceObject *device)
@@ -228,6 +606,13 @@ static int32_t GpioDriverInit(struct HdfDeviceObject *device)
     B91IrqRegister(IRQ25_GPIO, (HWI_PROC_FUNC)GpioIrqHandler, 0);
     plic_interrupt_enable(IRQ25_GPIO);
 
+    for (uint32_t lane = 0; lane < GPIO_FAST_LANES; ++lane) {
+        if (pB91GpioCntlr->fastLocal[lane] != GPIO_NO_LOCAL) {
+            B91IrqRegister(g_gpioFastLanes[lane].irq, g_gpioFastLanes[lane].handler, 0);
+            plic_interrupt_enable(g_gpioFastLanes[lane].irq);
+        }
+    }
+
     HDF_LOGD("%s: dev service:%s init success!", __func__, HdfDeviceGetServiceName(device));
     return ret;
 }
@@ -358,23 +743,40 @@ static int32_t GpioDevSetIrq(struct GpioCntlr *cntlr, uint16_t local, uint16_t m
     RETURN_ERR_IF_OUT_OF_RANGE(local);
 
     gpio_pin_e gpioPin = g_GpioIndexToActualPin[pB91GpioCntlr->pinReflectionMap[local]];
+    gpio_irq_trigger_type_e trigger;
+    int32_t lane = GpioFastLaneGet(pB91GpioCntlr, local);
+    uint8_t index = pB91GpioCntlr->pinReflectionMap[local];
     HDF_LOGD("%s: %d", __func__, local);
 
+    UINT32 intSave = LOS_IntLock();
+    pB91GpioCntlr->bothEdgeMask[index / GPIO_PORT_PINS] &= ~BIT(index % GPIO_PORT_PINS);
+    pB91GpioCntlr->levelMask[index / GPIO_PORT_PINS] &= ~BIT(index % GPIO_PORT_PINS);
+    GpioIrqUnmaskCancel(index);
+    LOS_IntRestore(intSave);
+
     switch (mode & 0x0F) {
         case GPIO_IRQ_TRIGGER_HIGH: {
-            gpio_set_irq(gpioPin, INTR_HIGH_LEVEL);
+            trigger = INTR_HIGH_LEVEL;
             break;
         }
         case GPIO_IRQ_TRIGGER_LOW: {
-            gpio_set_irq(gpioPin, INTR_LOW_LEVEL);
+            trigger = INTR_LOW_LEVEL;
             break;
         }
         case GPIO_IRQ_TRIGGER_RISING: {
-            gpio_set_irq(gpioPin, INTR_RISING_EDGE);
+            trigger = INTR_RISING_EDGE;
             break;
         }
         case GPIO_IRQ_TRIGGER_FALLING: {
-            gpio_set_irq(gpioPin, INTR_FALLING_EDGE);
+            trigger = INTR_FALLING_EDGE;
+            break;
+        }
+        case GPIO_IRQ_TRIGGER_BOTH: {
+            if (lane >= 0) {
+                return HDF_ERR_NOT_SUPPORT;
+            }
+            trigger = gpio_get_level(gpioPin) ? INTR_FALLING_EDGE : INTR_RISING_EDGE;
+            pB91GpioCntlr->bothEdgeMask[index / GPIO_PORT_PINS] |= BIT(index % GPIO_PORT_PINS);
             break;
         }
         default: {
@@ -382,6 +784,24 @@ static int32_t GpioDevSetIrq(struct GpioCntlr *cntlr, uint16_t local, uint16_t m
         }
     }
 
+    switch (lane) {
+        case 0: {
+            gpio_set_gpio2risc0_irq(gpioPin, trigger);
+            break;
+        }
+        case 1: {
+            gpio_set_gpio2risc1_irq(gpioPin, trigger);
+            break;
+        }
+        default: {
+            if ((trigger == INTR_HIGH_LEVEL) || (trigger == INTR_LOW_LEVEL)) {
+                pB91GpioCntlr->levelMask[index / GPIO_PORT_PINS] |= BIT(index % GPIO_PORT_PINS);
+            }
+            gpio_set_irq(gpioPin, trigger);
+            break;
+        }
+    }
+
     return HDF_SUCCESS;
 }
 
@@ -405,9 +825,29 @@ static int32_t GpioDevEnableIrq(struct GpioCntlr *cntlr, uint16_t local)
     gpio_pin_e gpioPin = g_GpioIndexToActualPin[pB91GpioCntlr->pinReflectionMap[local]];
     HDF_LOGD("%s: %d", __func__, local);
 
-    gpio_irq_en(gpioPin);
+    struct GpioEventPin *pin = GpioEventPinGet(pB91GpioCntlr->pinReflectionMap[local]);
+    if (pin != NULL) {
+        GpioEventPinReset(pin);
+    }
+
+    UINT32 intSave = LOS_IntLock();
+    GpioIrqUnmaskCancel(pB91GpioCntlr->pinReflectionMap[local]);
+    LOS_IntRestore(intSave);
 
-    pB91GpioCntlr->config[local].irq_enabled = true;
+    switch (GpioFastLaneGet(pB91GpioCntlr, local)) {
+        case 0: {
+            gpio_gpio2risc0_irq_en(gpioPin);
+            break;
+        }
+        case 1: {
+            gpio_gpio2risc1_irq_en(gpioPin);
+            break;
+        }
+        default: {
+            gpio_irq_en(gpioPin);
+            break;
+        }
+    }
 
     return HDF_SUCCESS;
 }
@@ -422,9 +862,126 @@ static int32_t GpioDevDisableIrq(struct GpioCntlr *cntlr, uint16_t local)
     gpio_pin_e gpioPin = g_GpioIndexToActualPin[pB91GpioCntlr->pinReflectionMap[local]];
     HDF_LOGD("%s: %d", __func__, local);
 
-    gpio_irq_dis(gpioPin);
+    UINT32 intSave = LOS_IntLock();
+    GpioIrqUnmaskCancel(pB91GpioCntlr->pinReflectionMap[local]);
+    LOS_IntRestore(intSave);
 
-    pB91GpioCntlr->config[local].irq_enabled = false;
+    switch (GpioFastLaneGet(pB91GpioCntlr, local)) {
+        case 0: {
+            gpio_gpio2risc0_irq_dis(gpioPin);
+            break;
+        }
+        case 1: {
+            gpio_gpio2risc1_irq_dis(gpioPin);
+            break;
+        }
+        default: {
+            gpio_irq_dis(gpioPin);
+            break;
+        }
+    }
+
+    return HDF_SUCCESS;
+}
+
+/* Split an HDF mask into per-port register masks; value bits follow the same pins */
+static int32_t GpioMaskToPorts(uint32_t mask, uint32_t value, uint8_t portBits[GPIO_PORT_NUM],
+                               uint8_t portValue[GPIO_PORT_NUM])
+{
+    const struct B91GpioCntlr *pB91GpioCntlr = &g_B91GpioCntlr;
+
+    (void)memset(portBits, 0, GPIO_PORT_NUM);
+    (void)memset(portValue, 0, GPIO_PORT_NUM);
+
+    while (mask != 0) {
+        uint32_t gpio = __builtin_ctz(mask);
+        mask &= mask - 1;
+
+        RETURN_ERR_IF_OUT_OF_RANGE(gpio);
+
+        uint8_t index = pB91GpioCntlr->pinReflectionMap[gpio];
+        uint8_t bit = BIT(index % GPIO_PORT_PINS);
+        portBits[index / GPIO_PORT_PINS] |= bit;
+        if (value & (1U << gpio)) {
+            portValue[index / GPIO_PORT_PINS] |= bit;
+        }
+    }
+
+    return HDF_SUCCESS;
+}
+
+static int32_t GpioPortsUpdate(uint32_t mask, uint32_t value, bool toggle)
+{
+    uint8_t portBits[GPIO_PORT_NUM];
+    uint8_t portValue[GPIO_PORT_NUM];
+
+    int32_t ret = GpioMaskToPorts(mask, value, portBits, portValue);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+
+    UINT32 intSave = LOS_IntLock();
+    for (uint32_t port = 0; port < GPIO_PORT_NUM; ++port) {
+        if (portBits[port] == 0) {
+            continue;
+        }
+
+        gpio_pin_e group = (gpio_pin_e)(port << 8);
+        if (toggle) {
+            reg_gpio_out(group) ^= portBits[port];
+        } else {
+            reg_gpio_out(group) = (reg_gpio_out(group) & ~portBits[port]) | portValue[port];
+        }
+    }
+    LOS_IntRestore(intSave);
+
+    return HDF_SUCCESS;
+}
+
+int32_t B91GpioWriteMask(uint32_t mask, uint32_t value)
+{
+    return GpioPortsUpdate(mask, value, false);
+}
+
+int32_t B91GpioSetMask(uint32_t mask)
+{
+    return GpioPortsUpdate(mask, mask, false);
+}
+
+int32_t B91GpioClearMask(uint32_t mask)
+{
+    return GpioPortsUpdate(mask, 0, false);
+}
+
+int32_t B91GpioToggleMask(uint32_t mask)
+{
+    return GpioPortsUpdate(mask, 0, true);
+}
+
+int32_t B91GpioReadMask(uint32_t mask, uint32_t *value)
+{
+    const struct B91GpioCntlr *pB91GpioCntlr = &g_B91GpioCntlr;
+    uint8_t levels[GPIO_PORT_NUM];
+
+    if (value == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    gpio_get_level_all(levels);
+    levels[GPIO_PORT_NUM - 1] = reg_gpio_pf_in; /* gpio_get_level_all stops at PE */
+
+    *value = 0;
+    while (mask != 0) {
+        uint32_t gpio = __builtin_ctz(mask);
+        mask &= mask - 1;
+
+        RETURN_ERR_IF_OUT_OF_RANGE(gpio);
+
+        uint8_t index = pB91GpioCntlr->pinReflectionMap[gpio];
+        if (levels[index / GPIO_PORT_PINS] & BIT(index % GPIO_PORT_PINS)) {
+            *value |= 1U << gpio;
+        }
+    }
 
     return HDF_SUCCESS;
 }
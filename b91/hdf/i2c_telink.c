@@ -0,0 +1,265 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#include "device_resource_if.h"
+#include "hdf_device_desc.h"
+#include "i2c/i2c_core.h"
+#include "i2c_if.h"
+#include "osal.h"
+
+#include <b91_i2c.h>
+
+#define GPIO_PORT_PINS  8
+#define I2C_ADDR_MAX    0x7F
+#define I2C_SPEED       100000
+#define I2C_TIMEOUT     100
+#define I2C_UNSUPPORTED (I2C_FLAG_ADDR_10BIT | I2C_FLAG_READ_NO_ACK | I2C_FLAG_IGNORE_NO_ACK)
+
+struct B91I2cDevice {
+    struct I2cCntlr cntlr;
+
+    /* pins as port * 8 + bit, the numbering of pinMap in gpio_config.hcs */
+    uint8_t sdaPin;
+    uint8_t sclPin;
+    uint32_t speed;
+    uint32_t timeoutMs;
+};
+
+static int32_t I2cDriverBind(struct HdfDeviceObject *device);
+static int32_t I2cDriverInit(struct HdfDeviceObject *device);
+static void I2cDriverRelease(struct HdfDeviceObject *device);
+
+struct HdfDriverEntry g_I2cDriverEntry = {
+    .moduleVersion = 1,
+    .moduleName = "TELINK_HDF_PLATFORM_I2C",
+    .Bind = I2cDriverBind,
+    .Init = I2cDriverInit,
+    .Release = I2cDriverRelease,
+};
+
+HDF_INIT(g_I2cDriverEntry);
+
+static int32_t I2cHostTransfer(struct I2cCntlr *cntlr, struct I2cMsg *msgs, int16_t count);
+
+/* I2cMethod Definitions */
+struct I2cMethod g_I2cHostMethod = {
+    .transfer = I2cHostTransfer,
+};
+
+#define I2C_PIN_CHOICES 4
+
+static const uint16_t g_i2cSdaPins[I2C_PIN_CHOICES] = {
+    I2C_GPIO_SDA_B3, I2C_GPIO_SDA_C2, I2C_GPIO_SDA_E2, I2C_GPIO_SDA_E3,
+};
+static const uint16_t g_i2cSclPins[I2C_PIN_CHOICES] = {
+    I2C_GPIO_SCL_B2, I2C_GPIO_SCL_C1, I2C_GPIO_SCL_E0, I2C_GPIO_SCL_E1,
+};
+
+static gpio_pin_e I2cPinGet(uint8_t pin)
+{
+    return (gpio_pin_e)(((pin / GPIO_PORT_PINS) << 8) | BIT(pin % GPIO_PORT_PINS));
+}
+
+static bool I2cPinValid(gpio_pin_e pin, const uint16_t *pins)
+{
+    for (uint32_t i = 0; i < I2C_PIN_CHOICES; ++i) {
+        if (pin == pins[i]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static int32_t I2cStatusToHdf(UINT32 status)
+{
+    switch (status) {
+        case LOS_OK:
+            return HDF_SUCCESS;
+        case B91_I2C_ERR_NACK:
+            return HDF_ERR_IO;
+        case B91_I2C_ERR_TIMEOUT:
+            return HDF_ERR_TIMEOUT;
+        default:
+            return HDF_FAILURE;
+    }
+}
+
+static int32_t I2cHostTransfer(struct I2cCntlr *cntlr, struct I2cMsg *msgs, int16_t count)
+{
+    B91I2cXfer xfer = {0};
+    B91I2cMsg *b91Msgs = NULL;
+    int32_t ret;
+
+    if ((cntlr == NULL) || (msgs == NULL) || (count <= 0)) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    for (int16_t i = 0; i < count; ++i) {
+        if ((msgs[i].flags & I2C_UNSUPPORTED) || (msgs[i].addr > I2C_ADDR_MAX)) {
+            HDF_LOGE("%s: msg %d: 10-bit address or NACK control not supported", __func__, i);
+            return HDF_ERR_NOT_SUPPORT;
+        }
+    }
+
+    b91Msgs = (B91I2cMsg *)OsalMemCalloc(sizeof(*b91Msgs) * count);
+    if (b91Msgs == NULL) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    for (int16_t i = 0; i < count; ++i) {
+        b91Msgs[i].buf = msgs[i].buf;
+        b91Msgs[i].len = msgs[i].len;
+        b91Msgs[i].addr = (uint8_t)msgs[i].addr;
+        b91Msgs[i].flags = ((msgs[i].flags & I2C_FLAG_READ) ? B91_I2C_MSG_READ : 0) |
+                           ((msgs[i].flags & I2C_FLAG_NO_START) ? B91_I2C_MSG_NOSTART : 0) |
+                           ((msgs[i].flags & I2C_FLAG_STOP) ? B91_I2C_MSG_STOP : 0);
+    }
+
+    xfer.msgs = b91Msgs;
+    xfer.num = (UINT16)count;
+
+    UINT32 status = B91I2cTransfer(&xfer);
+    if (status == LOS_OK) {
+        ret = count;
+    } else {
+        HDF_LOGE("%s: transfer failed after %u msgs: 0x%x", __func__, xfer.done, status);
+        ret = I2cStatusToHdf(status);
+    }
+
+    OsalMemFree(b91Msgs);
+
+    return ret;
+}
+
+static int32_t GetI2cDeviceResource(struct B91I2cDevice *dev, const struct DeviceResourceNode *resourceNode)
+{
+    uint16_t busId;
+    struct DeviceResourceIface *dri = NULL;
+
+    dri = DeviceResourceGetIfaceInstance(HDF_CONFIG_SOURCE);
+    if (dri == NULL) {
+        HDF_LOGE("DeviceResourceIface is invalid!");
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    if (dri->GetUint16(resourceNode, "bus", &busId, 0) != HDF_SUCCESS) {
+        HDF_LOGE("Failed to read bus!");
+        return HDF_FAILURE;
+    }
+    dev->cntlr.busId = (int16_t)busId;
+
+    if ((dri->GetUint8(resourceNode, "sdaPin", &dev->sdaPin, 0) != HDF_SUCCESS) ||
+        (dri->GetUint8(resourceNode, "sclPin", &dev->sclPin, 0) != HDF_SUCCESS)) {
+        HDF_LOGE("Failed to read sdaPin/sclPin!");
+        return HDF_FAILURE;
+    }
+
+    if (!I2cPinValid(I2cPinGet(dev->sdaPin), g_i2cSdaPins) || !I2cPinValid(I2cPinGet(dev->sclPin), g_i2cSclPins)) {
+        HDF_LOGE("sdaPin/sclPin can not be routed to I2C!");
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    (void)dri->GetUint32(resourceNode, "speed", &dev->speed, I2C_SPEED);
+    (void)dri->GetUint32(resourceNode, "timeoutMs", &dev->timeoutMs, I2C_TIMEOUT);
+
+    return HDF_SUCCESS;
+}
+
+static int32_t I2cDriverBind(struct HdfDeviceObject *device)
+{
+    HDF_LOGD("%s: Enter", __func__);
+
+    if (device == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    return HDF_SUCCESS;
+}
+
+static int32_t I2cDriverInit(struct HdfDeviceObject *device)
+{
+    int32_t ret;
+    struct B91I2cDevice *dev = NULL;
+
+    HDF_LOGD("%s: Enter", __func__);
+
+    if (device == NULL || device->property == NULL) {
+        HDF_LOGE("%s: device or property NULL!", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    dev = (struct B91I2cDevice *)OsalMemCalloc(sizeof(*dev));
+    if (dev == NULL) {
+        HDF_LOGE("%s: OsalMemCalloc error", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    ret = GetI2cDeviceResource(dev, device->property);
+    if (ret != HDF_SUCCESS) {
+        OsalMemFree(dev);
+        return ret;
+    }
+
+    B91I2cConfig config = {
+        .sda = (i2c_sda_pin_e)I2cPinGet(dev->sdaPin),
+        .scl = (i2c_scl_pin_e)I2cPinGet(dev->sclPin),
+        .speedHz = dev->speed,
+        .timeoutMs = dev->timeoutMs,
+    };
+    if (B91I2cInit(&config) != LOS_OK) {
+        HDF_LOGE("%s: B91I2cInit failed", __func__);
+        OsalMemFree(dev);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    dev->cntlr.priv = dev;
+    dev->cntlr.device = device;
+    dev->cntlr.ops = &g_I2cHostMethod;
+
+    ret = I2cCntlrAdd(&dev->cntlr);
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: I2cCntlrAdd failed: %d", __func__, ret);
+        OsalMemFree(dev);
+        return ret;
+    }
+    device->priv = dev;
+
+    HDF_LOGD("%s: dev service:%s init success!", __func__, HdfDeviceGetServiceName(device));
+    return HDF_SUCCESS;
+}
+
+static void I2cDriverRelease(struct HdfDeviceObject *device)
+{
+    struct B91I2cDevice *dev = NULL;
+
+    HDF_LOGD("%s: Enter", __func__);
+
+    if (device == NULL) {
+        HDF_LOGE("%s: device is null!", __func__);
+        return;
+    }
+
+    dev = (struct B91I2cDevice *)device->priv;
+    if (dev != NULL) {
+        I2cCntlrRemove(&dev->cntlr);
+        OsalMemFree(dev);
+        device->priv = NULL;
+    }
+}
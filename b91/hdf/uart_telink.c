@@ -0,0 +1,726 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#include "device_resource_if.h"
+#include "hdf_device_desc.h"
+#include "osal.h"
+#include "uart/uart_core.h"
+#include "uart_if.h"
+
+#include <string.h>
+
+#include <B91/clock.h>
+#include <B91/uart.h>
+
+#include <b91_dma.h>
+#include <b91_uart.h>
+#include <b91_uart_rx.h>
+
+#if defined(LOSCFG_TELINK_B91_DLM_HEAP)
+#include <b91_mem.h>
+#endif /* LOSCFG_TELINK_B91_DLM_HEAP */
+
+#if defined(LOSCFG_TELINK_B91_DVFS)
+#include <b91_dvfs.h>
+#endif /* LOSCFG_TELINK_B91_DVFS */
+
+#define UART_NUM          2
+#define UART_TX_CHUNK     256
+#define UART_TX_BUFS      2
+#define UART_PIN_NONE     0xFF
+#define GPIO_PORT_PINS    8
+#define UART_WORD_MASK    3
+#define UART_RX_BUF_SIZE  1024
+#define UART_RX_TIMEOUT   100
+#define UART_TX_TIMEOUT   1000
+#define UART_CTS_STOP_LVL 1
+
+#define HZ_IN_MHZ (1000 * 1000)
+
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+struct B91UartDevice {
+    uart_num_e num;
+    uint32_t baudrate;
+    struct UartAttribute attr;
+    uart_parity_e parity;
+    uart_stop_bit_e stopBits;
+
+    /* pins as port * 8 + bit, the numbering of pinMap in gpio_config.hcs */
+    uint8_t txPin;
+    uint8_t rxPin;
+    uint8_t ctsPin;
+    uint8_t rtsPin;
+
+    uint32_t rxBufSize;
+    uint32_t rxTimeoutMs;
+    uint32_t txTimeoutMs;
+    bool rxNonBlock;
+    bool initialized;
+    bool txDmaReady;
+    volatile bool txBusy;
+
+    uint8_t *rxBuf;
+    struct OsalSem rxSem;
+    struct OsalSem txSem;
+    struct OsalMutex txLock;
+
+    /* the UART TX DMA moves whole words: the next chunk is staged while one is sent */
+    uint8_t txBuf[UART_TX_BUFS][UART_TX_CHUNK] __attribute__((aligned(4)));
+};
+
+static const dma_chn_e g_uartTxChn[UART_NUM] = {B91_DMA_CHN_UART0_TX, B91_DMA_CHN_UART1_TX};
+
+/* initialized devices, for the clock change notifier and the PM busy check */
+static struct B91UartDevice *g_uartDevs[UART_NUM];
+
+static int32_t UartDriverBind(struct HdfDeviceObject *device);
+static int32_t UartDriverInit(struct HdfDeviceObject *device);
+static void UartDriverRelease(struct HdfDeviceObject *device);
+
+struct HdfDriverEntry g_UartDriverEntry = {
+    .moduleVersion = 1,
+    .moduleName = "TELINK_HDF_PLATFORM_UART",
+    .Bind = UartDriverBind,
+    .Init = UartDriverInit,
+    .Release = UartDriverRelease,
+};
+
+HDF_INIT(g_UartDriverEntry);
+
+static int32_t UartHostDevInit(struct UartHost *host);
+static int32_t UartHostDevDeinit(struct UartHost *host);
+static int32_t UartHostDevRead(struct UartHost *host, uint8_t *data, uint32_t size);
+static int32_t UartHostDevWrite(struct UartHost *host, uint8_t *data, uint32_t size);
+static int32_t UartHostDevGetBaud(struct UartHost *host, uint32_t *baudRate);
+static int32_t UartHostDevSetBaud(struct UartHost *host, uint32_t baudRate);
+static int32_t UartHostDevGetAttribute(struct UartHost *host, struct UartAttribute *attribute);
+static int32_t UartHostDevSetAttribute(struct UartHost *host, struct UartAttribute *attribute);
+static int32_t UartHostDevSetTransMode(struct UartHost *host, enum UartTransMode mode);
+
+/* UartHostMethod Definitions */
+struct UartHostMethod g_UartHostMethod = {
+    .Init = UartHostDevInit,
+    .Deinit = UartHostDevDeinit,
+    .Read = UartHostDevRead,
+    .Write = UartHostDevWrite,
+    .GetBaud = UartHostDevGetBaud,
+    .SetBaud = UartHostDevSetBaud,
+    .GetAttribute = UartHostDevGetAttribute,
+    .SetAttribute = UartHostDevSetAttribute,
+    .SetTransMode = UartHostDevSetTransMode,
+    .pollEvent = NULL,
+};
+
+static gpio_pin_e UartPinGet(uint8_t pin)
+{
+    return (gpio_pin_e)(((pin / GPIO_PORT_PINS) << 8) | BIT(pin % GPIO_PORT_PINS));
+}
+
+_attribute_ram_code_ static void UartRxNotify(uart_num_e uart, void *arg)
+{
+    (void)uart;
+
+    (void)OsalSemPost(&((struct B91UartDevice *)arg)->rxSem);
+}
+
+_attribute_ram_code_ static void UartTxDone(void *arg, UINT32 events)
+{
+    struct B91UartDevice *dev = (struct B91UartDevice *)arg;
+
+    (void)events;
+
+    dev->txBusy = false;
+    (void)OsalSemPost(&dev->txSem);
+}
+
+/* Kconfig keeps the DMA channels of an enabled UART away from the ADC and audio streams */
+static bool UartNumEnabled(uart_num_e num)
+{
+    switch (num) {
+#if defined(LOSCFG_TELINK_B91_HDF_UART0)
+        case UART0: {
+            return true;
+        }
+#endif /* LOSCFG_TELINK_B91_HDF_UART0 */
+#if defined(LOSCFG_TELINK_B91_HDF_UART1)
+        case UART1: {
+            return true;
+        }
+#endif /* LOSCFG_TELINK_B91_HDF_UART1 */
+        default: {
+            return false;
+        }
+    }
+}
+
+static uint8_t *UartRxBufAlloc(uint32_t size)
+{
+#if defined(LOSCFG_TELINK_B91_DLM_HEAP)
+    return (uint8_t *)B91MemAllocDma(size);
+#else  /* LOSCFG_TELINK_B91_DLM_HEAP */
+    return (uint8_t *)OsalMemAlloc(size);
+#endif /* LOSCFG_TELINK_B91_DLM_HEAP */
+}
+
+static void UartRxBufFree(uint8_t *buf)
+{
+#if defined(LOSCFG_TELINK_B91_DLM_HEAP)
+    B91MemFree(buf);
+#else  /* LOSCFG_TELINK_B91_DLM_HEAP */
+    OsalMemFree(buf);
+#endif /* LOSCFG_TELINK_B91_DLM_HEAP */
+}
+
+/* With txLock held no new DMA starts, the last bytes may still be shifting out of the FIFO */
+static void UartTxDrain(struct B91UartDevice *dev)
+{
+    while (uart_tx_is_busy(dev->num)) {
+    }
+}
+
+/* Program the divider for the current PCLK, returns the bit width the RX timeout scales with */
+static unsigned char UartClockConfig(struct B91UartDevice *dev)
+{
+    unsigned short div;
+    unsigned char bwpc;
+
+    uart_cal_div_and_bwpc(dev->baudrate, sys_clk.pclk * HZ_IN_MHZ, &div, &bwpc);
+    telink_b91_uart_init(dev->num, div, bwpc, dev->parity, dev->stopBits);
+
+    return bwpc;
+}
+
+#if defined(LOSCFG_TELINK_B91_DVFS)
+/*
+ * Writes in flight finish on the old clock and later ones wait on txLock until the new
+ * divider is set; the received bytes stay in the ring.
+ */
+static void UartClockChanged(B91DvfsEvent event, VOID *arg)
+{
+    (void)arg;
+
+    for (uint32_t i = 0; i < UART_NUM; ++i) {
+        struct B91UartDevice *dev = g_uartDevs[i];
+        if (dev == NULL) {
+            continue;
+        }
+
+        if (event == B91_DVFS_PRE_CHANGE) {
+            (void)OsalMutexLock(&dev->txLock);
+            UartTxDrain(dev);
+        } else {
+            B91UartRxBitWidthSet(dev->num, UartClockConfig(dev));
+            (void)OsalMutexUnlock(&dev->txLock);
+        }
+    }
+}
+#endif /* LOSCFG_TELINK_B91_DVFS */
+
+static int32_t UartHwConfig(struct B91UartDevice *dev)
+{
+    uart_parity_e parity;
+    uart_stop_bit_e stopBits;
+
+    if (dev->attr.dataBits != UART_ATTR_DATABIT_8) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+
+    switch (dev->attr.parity) {
+        case UART_ATTR_PARITY_NONE: {
+            parity = UART_PARITY_NONE;
+            break;
+        }
+        case UART_ATTR_PARITY_ODD: {
+            parity = UART_PARITY_ODD;
+            break;
+        }
+        case UART_ATTR_PARITY_EVEN: {
+            parity = UART_PARITY_EVEN;
+            break;
+        }
+        default: {
+            return HDF_ERR_NOT_SUPPORT;
+        }
+    }
+
+    switch (dev->attr.stopBits) {
+        case UART_ATTR_STOPBIT_1: {
+            stopBits = UART_STOP_BIT_ONE;
+            break;
+        }
+        case UART_ATTR_STOPBIT_1P5: {
+            stopBits = UART_STOP_BIT_ONE_DOT_FIVE;
+            break;
+        }
+        case UART_ATTR_STOPBIT_2: {
+            stopBits = UART_STOP_BIT_TWO;
+            break;
+        }
+        default: {
+            return HDF_ERR_NOT_SUPPORT;
+        }
+    }
+
+    B91UartRxStop(dev->num);
+
+    dev->parity = parity;
+    dev->stopBits = stopBits;
+
+    uart_set_pin((uart_tx_pin_e)UartPinGet(dev->txPin), (uart_rx_pin_e)UartPinGet(dev->rxPin));
+    uart_reset(dev->num);
+    unsigned char bwpc = UartClockConfig(dev);
+
+    if (dev->attr.cts && (dev->ctsPin != UART_PIN_NONE)) {
+        uart_cts_config(dev->num, (uart_cts_pin_e)UartPinGet(dev->ctsPin), UART_CTS_STOP_LVL);
+        uart_set_cts_en(dev->num);
+    } else {
+        uart_set_cts_dis(dev->num);
+    }
+
+    if (dev->attr.rts && (dev->rtsPin != UART_PIN_NONE)) {
+        uart_rts_config(dev->num, (uart_rts_pin_e)UartPinGet(dev->rtsPin), 0, 1);
+        uart_set_rts_en(dev->num);
+    } else {
+        uart_set_rts_dis(dev->num);
+    }
+
+    uart_set_tx_dma_config(dev->num, g_uartTxChn[dev->num]);
+
+    B91UartRxConfig rxConfig = {
+        .buf = dev->rxBuf,
+        .size = dev->rxBufSize,
+        .bwpc = bwpc,
+        .notify = UartRxNotify,
+        .arg = dev,
+    };
+
+    if (B91UartRxStart(dev->num, &rxConfig) != LOS_OK) {
+        HDF_LOGE("%s: B91UartRxStart failed", __func__);
+        return HDF_FAILURE;
+    }
+
+    return HDF_SUCCESS;
+}
+
+static int32_t UartHostDevInit(struct UartHost *host)
+{
+    int32_t ret;
+    struct B91UartDevice *dev = (struct B91UartDevice *)host->priv;
+
+    HDF_LOGD("%s: Enter", __func__);
+
+    if (dev->initialized) {
+        return HDF_SUCCESS;
+    }
+
+    dev->rxBuf = UartRxBufAlloc(dev->rxBufSize);
+    if (dev->rxBuf == NULL) {
+        HDF_LOGE("%s: rx buffer alloc error", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    if (((uintptr_t)dev->rxBuf & UART_WORD_MASK) != 0) {
+        UartRxBufFree(dev->rxBuf);
+        dev->rxBuf = NULL;
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    (void)OsalSemInit(&dev->rxSem, 0);
+    (void)OsalSemInit(&dev->txSem, 0);
+    (void)OsalMutexInit(&dev->txLock);
+
+    if (B91DmaIrqRegister(g_uartTxChn[dev->num], UartTxDone, dev) != LOS_OK) {
+        HDF_LOGE("%s: DMA channel %d is taken", __func__, g_uartTxChn[dev->num]);
+        (void)UartHostDevDeinit(host);
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    dev->txDmaReady = true;
+
+    ret = UartHwConfig(dev);
+    if (ret != HDF_SUCCESS) {
+        (void)UartHostDevDeinit(host);
+        return ret;
+    }
+
+#if defined(LOSCFG_TELINK_B91_DVFS)
+    if (B91DvfsNotifierRegister(UartClockChanged, NULL) != LOS_OK) {
+        (void)UartHostDevDeinit(host);
+        return HDF_FAILURE;
+    }
+#endif /* LOSCFG_TELINK_B91_DVFS */
+
+    g_uartDevs[dev->num] = dev;
+    dev->initialized = true;
+    return HDF_SUCCESS;
+}
+
+static int32_t UartHostDevDeinit(struct UartHost *host)
+{
+    struct B91UartDevice *dev = (struct B91UartDevice *)host->priv;
+
+    HDF_LOGD("%s: Enter", __func__);
+
+    g_uartDevs[dev->num] = NULL;
+
+    B91UartRxStop(dev->num);
+    if (dev->txDmaReady) {
+        dma_chn_dis(g_uartTxChn[dev->num]);
+        (void)B91DmaIrqRegister(g_uartTxChn[dev->num], NULL, NULL);
+        dev->txDmaReady = false;
+        dev->txBusy = false;
+    }
+
+    (void)OsalSemDestroy(&dev->rxSem);
+    (void)OsalSemDestroy(&dev->txSem);
+    (void)OsalMutexDestroy(&dev->txLock);
+
+    if (dev->rxBuf != NULL) {
+        UartRxBufFree(dev->rxBuf);
+        dev->rxBuf = NULL;
+    }
+
+    dev->initialized = false;
+    return HDF_SUCCESS;
+}
+
+/* Blocking reads wait for data up to rxTimeoutMs; they are woken at the end of each frame */
+static int32_t UartHostDevRead(struct UartHost *host, uint8_t *data, uint32_t size)
+{
+    struct B91UartDevice *dev = (struct B91UartDevice *)host->priv;
+
+    if (!dev->initialized || (data == NULL)) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    uint32_t len = B91UartRxRead(dev->num, data, size);
+    while ((len == 0) && !dev->rxNonBlock) {
+        if (OsalSemWait(&dev->rxSem, dev->rxTimeoutMs) != HDF_SUCCESS) {
+            break;
+        }
+        len = B91UartRxRead(dev->num, data, size);
+    }
+
+    return (int32_t)len;
+}
+
+static int32_t UartHostDevWrite(struct UartHost *host, uint8_t *data, uint32_t size)
+{
+    int32_t ret = HDF_SUCCESS;
+    uint32_t done = 0;
+    bool inFlight = false;
+    struct B91UartDevice *dev = (struct B91UartDevice *)host->priv;
+
+    if (!dev->initialized || (data == NULL)) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    (void)OsalMutexLock(&dev->txLock);
+
+    /* A completion that came in after an earlier write timed out must not count for this one */
+    while (OsalSemWait(&dev->txSem, 0) == HDF_SUCCESS) {
+    }
+
+    for (uint32_t i = 0; done < size; ++i) {
+        uint8_t *buf = dev->txBuf[i % UART_TX_BUFS];
+        uint32_t len = MIN(size - done, UART_TX_CHUNK);
+
+        (void)memcpy(buf, &data[done], len);
+
+        if (inFlight && (OsalSemWait(&dev->txSem, dev->txTimeoutMs) != HDF_SUCCESS)) {
+            inFlight = false;
+            ret = HDF_ERR_TIMEOUT;
+            break;
+        }
+
+        dev->txBusy = true;
+        (void)uart_send_dma(dev->num, buf, len);
+        inFlight = true;
+        done += len;
+    }
+
+    if (inFlight && (OsalSemWait(&dev->txSem, dev->txTimeoutMs) != HDF_SUCCESS)) {
+        ret = HDF_ERR_TIMEOUT;
+    }
+
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s: uart%d tx timeout", __func__, dev->num);
+        dma_chn_dis(g_uartTxChn[dev->num]);
+        dev->txBusy = false;
+    }
+
+    (void)OsalMutexUnlock(&dev->txLock);
+
+    return ret;
+}
+
+static int32_t UartHostDevGetBaud(struct UartHost *host, uint32_t *baudRate)
+{
+    struct B91UartDevice *dev = (struct B91UartDevice *)host->priv;
+
+    if (baudRate == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    *baudRate = dev->baudrate;
+    return HDF_SUCCESS;
+}
+
+static int32_t UartHostDevSetBaud(struct UartHost *host, uint32_t baudRate)
+{
+    struct B91UartDevice *dev = (struct B91UartDevice *)host->priv;
+
+    if (baudRate == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    (void)OsalMutexLock(&dev->txLock);
+
+    dev->baudrate = baudRate;
+    int32_t ret = HDF_SUCCESS;
+    if (dev->initialized) {
+        UartTxDrain(dev);
+        ret = UartHwConfig(dev);
+    }
+
+    (void)OsalMutexUnlock(&dev->txLock);
+
+    return ret;
+}
+
+static int32_t UartHostDevGetAttribute(struct UartHost *host, struct UartAttribute *attribute)
+{
+    struct B91UartDevice *dev = (struct B91UartDevice *)host->priv;
+
+    if (attribute == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    *attribute = dev->attr;
+    return HDF_SUCCESS;
+}
+
+static int32_t UartHostDevSetAttribute(struct UartHost *host, struct UartAttribute *attribute)
+{
+    struct B91UartDevice *dev = (struct B91UartDevice *)host->priv;
+
+    if (attribute == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    (void)OsalMutexLock(&dev->txLock);
+
+    struct UartAttribute old = dev->attr;
+    dev->attr = *attribute;
+
+    int32_t ret = HDF_SUCCESS;
+    if (dev->initialized) {
+        UartTxDrain(dev);
+        ret = UartHwConfig(dev);
+    }
+    if (ret == HDF_ERR_NOT_SUPPORT) {
+        dev->attr = old;
+    }
+
+    (void)OsalMutexUnlock(&dev->txLock);
+
+    return ret;
+}
+
+static int32_t UartHostDevSetTransMode(struct UartHost *host, enum UartTransMode mode)
+{
+    struct B91UartDevice *dev = (struct B91UartDevice *)host->priv;
+
+    switch (mode) {
+        case UART_MODE_RD_BLOCK: {
+            dev->rxNonBlock = false;
+            break;
+        }
+        case UART_MODE_RD_NONBLOCK: {
+            dev->rxNonBlock = true;
+            break;
+        }
+        case UART_MODE_DMA_RX_EN:
+        case UART_MODE_DMA_TX_EN: {
+            break;
+        }
+        default: {
+            /* both directions always use DMA */
+            return HDF_ERR_NOT_SUPPORT;
+        }
+    }
+
+    return HDF_SUCCESS;
+}
+
+static int32_t GetUartDeviceResource(struct B91UartDevice *dev, const struct DeviceResourceNode *resourceNode)
+{
+    uint32_t num;
+    uint8_t flowControl;
+    struct DeviceResourceIface *dri = NULL;
+
+    dri = DeviceResourceGetIfaceInstance(HDF_CONFIG_SOURCE);
+    if (dri == NULL) {
+        HDF_LOGE("DeviceResourceIface is invalid!");
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    if ((dri->GetUint32(resourceNode, "num", &num, 0) != HDF_SUCCESS) || (num >= UART_NUM)) {
+        HDF_LOGE("Failed to read num!");
+        return HDF_FAILURE;
+    }
+    dev->num = (uart_num_e)num;
+
+    if ((dri->GetUint32(resourceNode, "baudrate", &dev->baudrate, 0) != HDF_SUCCESS) || (dev->baudrate == 0)) {
+        HDF_LOGE("Failed to read baudrate!");
+        return HDF_FAILURE;
+    }
+
+    if ((dri->GetUint8(resourceNode, "txPin", &dev->txPin, 0) != HDF_SUCCESS) ||
+        (dri->GetUint8(resourceNode, "rxPin", &dev->rxPin, 0) != HDF_SUCCESS)) {
+        HDF_LOGE("Failed to read txPin/rxPin!");
+        return HDF_FAILURE;
+    }
+
+    (void)dri->GetUint8(resourceNode, "ctsPin", &dev->ctsPin, UART_PIN_NONE);
+    (void)dri->GetUint8(resourceNode, "rtsPin", &dev->rtsPin, UART_PIN_NONE);
+    (void)dri->GetUint8(resourceNode, "flowControl", &flowControl, 0);
+    (void)dri->GetUint32(resourceNode, "rxBufSize", &dev->rxBufSize, UART_RX_BUF_SIZE);
+    (void)dri->GetUint32(resourceNode, "rxTimeoutMs", &dev->rxTimeoutMs, UART_RX_TIMEOUT);
+    (void)dri->GetUint32(resourceNode, "txTimeoutMs", &dev->txTimeoutMs, UART_TX_TIMEOUT);
+
+    dev->attr.dataBits = UART_ATTR_DATABIT_8;
+    dev->attr.parity = UART_ATTR_PARITY_NONE;
+    dev->attr.stopBits = UART_ATTR_STOPBIT_1;
+    dev->attr.cts = (flowControl != 0) ? UART_ATTR_CTS_EN : 0;
+    dev->attr.rts = (flowControl != 0) ? UART_ATTR_RTS_EN : 0;
+
+    return HDF_SUCCESS;
+}
+
+static int32_t UartDriverBind(struct HdfDeviceObject *device)
+{
+    struct UartHost *host = NULL;
+
+    HDF_LOGD("%s: Enter", __func__);
+
+    if (device == NULL) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    host = UartHostCreate(device);
+    if (host == NULL) {
+        HDF_LOGE("%s: UartHostCreate failed", __func__);
+        return HDF_FAILURE;
+    }
+
+    return HDF_SUCCESS;
+}
+
+static int32_t UartDriverInit(struct HdfDeviceObject *device)
+{
+    int32_t ret;
+    struct UartHost *host = NULL;
+    struct B91UartDevice *dev = NULL;
+
+    HDF_LOGD("%s: Enter", __func__);
+
+    if (device == NULL || device->property == NULL) {
+        HDF_LOGE("%s: device or property NULL!", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    host = UartHostFromDevice(device);
+    if (host == NULL) {
+        HDF_LOGE("%s: host is NULL", __func__);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    dev = (struct B91UartDevice *)OsalMemCalloc(sizeof(*dev));
+    if (dev == NULL) {
+        HDF_LOGE("%s: OsalMemCalloc error", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+
+    ret = GetUartDeviceResource(dev, device->property);
+    if (ret != HDF_SUCCESS) {
+        OsalMemFree(dev);
+        return ret;
+    }
+
+    if (!UartNumEnabled(dev->num)) {
+        HDF_LOGE("%s: uart%d is not enabled in Kconfig", __func__, dev->num);
+        OsalMemFree(dev);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+
+    if ((dev->rxBufSize & (dev->rxBufSize - 1)) != 0) {
+        HDF_LOGE("%s: rxBufSize must be a power of two", __func__);
+        OsalMemFree(dev);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    host->num = dev->num;
+    host->priv = dev;
+    host->method = &g_UartHostMethod;
+
+    HDF_LOGD("%s: dev service:%s init success!", __func__, HdfDeviceGetServiceName(device));
+    return HDF_SUCCESS;
+}
+
+static void UartDriverRelease(struct HdfDeviceObject *device)
+{
+    struct UartHost *host = NULL;
+
+    HDF_LOGD("%s: Enter", __func__);
+
+    if (device == NULL) {
+        HDF_LOGE("%s: device is null!", __func__);
+        return;
+    }
+
+    host = UartHostFromDevice(device);
+    if (host == NULL) {
+        HDF_LOGE("%s: host is null!", __func__);
+        return;
+    }
+
+    if (host->priv != NULL) {
+        struct B91UartDevice *dev = (struct B91UartDevice *)host->priv;
+        if (dev->initialized) {
+            (void)UartHostDevDeinit(host);
+        }
+        OsalMemFree(dev);
+        host->priv = NULL;
+    }
+
+    UartHostDestroy(host);
+}
+
+bool B91UartTxBusy(void)
+{
+    for (uint32_t i = 0; i < UART_NUM; ++i) {
+        struct B91UartDevice *dev = g_uartDevs[i];
+        if ((dev != NULL) && (dev->txBusy || uart_tx_is_busy(dev->num))) {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,64 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#ifndef _B91_ADC_H
+#define _B91_ADC_H
+
+#include <los_compiler.h>
+
+/* Called from the DMA interrupt with the millivolt outputs decimated from one half buffer */
+typedef VOID (*B91AdcStreamNotify)(const UINT16 *mv, UINT32 num, VOID *arg);
+
+typedef struct {
+    UINT16 *buf;         /* word aligned DMA ring of 2 * halfSamples raw codes */
+    UINT16 *out;         /* halfSamples / decimation + 1 outputs */
+    UINT16 halfSamples;  /* even, a notification per half */
+    UINT16 decimation;   /* raw samples averaged into one output, 1 to 256 */
+    BOOL median;         /* take the median of three neighbouring samples before averaging */
+    INT16 offsetMv;      /* calibration offset added to every output */
+    B91AdcStreamNotify notify;
+    VOID *arg;
+} B91AdcStreamConfig;
+
+typedef struct {
+    UINT32 halves;   /* half buffers processed */
+    UINT32 overrun;  /* half buffers lost because the interrupt was served too late */
+} B91AdcStreamStats;
+
+/**
+ * @brief Sample continuously by DMA on an ADC set up with the SDK adc_*_sample_init
+ *        functions. The DMA loops over two half buffers on B91_DMA_CHN_ADC, each
+ *        completed half is filtered and converted with the current ADC calibration.
+ * @return LOS_OK or LOS_NOK on invalid configuration
+ */
+UINT32 B91AdcStreamStart(const B91AdcStreamConfig *config);
+
+/**
+ * @brief Stop sampling and power the ADC down
+ */
+VOID B91AdcStreamStop(VOID);
+
+UINT32 B91AdcStreamStatsGet(B91AdcStreamStats *stats);
+
+/**
+ * @brief Check if the stream is running, the ADC clocks stop in suspend
+ */
+BOOL B91AdcStreamBusy(VOID);
+
+#endif /* _B91_ADC_H */
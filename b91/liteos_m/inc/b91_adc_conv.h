@@ -0,0 +1,61 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#ifndef _B91_ADC_CONV_H
+#define _B91_ADC_CONV_H
+
+#include <los_compiler.h>
+
+/*
+ * Batch conversion of raw 14 bit ADC codes, BIT(13) being the sign of a differential
+ * input. Kept free of hardware accesses so it builds for the host as well, where the
+ * scalar code is the reference for the packed SIMD code used with the Andes DSP extension.
+ */
+
+typedef struct {
+    UINT16 gain;     /* millivolts per code << 13 */
+    INT16 offsetMv;  /* added after scaling, e.g. from a two point calibration */
+} B91AdcCal;
+
+/**
+ * @brief Set up a calibration from the SDK ADC settings
+ * @param vrefMv g_adc_vref
+ * @param preScale g_adc_pre_scale
+ * @param vbatDivider g_adc_vbat_divider
+ * @param offsetMv offset added to every result
+ * @return LOS_OK or LOS_NOK if the gain does not fit 16 bits
+ */
+UINT32 B91AdcCalInit(B91AdcCal *cal, UINT32 vrefMv, UINT32 preScale, UINT32 vbatDivider, INT16 offsetMv);
+
+/**
+ * @brief Clear the codes of negative inputs and strip the sign bit, in place
+ */
+VOID B91AdcCodesMask(UINT16 *codes, UINT32 num);
+
+/**
+ * @brief Convert raw codes to millivolts, saturated to 0..65535. mv may alias codes.
+ */
+VOID B91AdcCodesToMv(const B91AdcCal *cal, const UINT16 *codes, UINT16 *mv, UINT32 num);
+
+/**
+ * @brief Convert raw temperature sensor codes (Vref 1.2 V, pre-scale 1) to degrees Celsius
+ */
+VOID B91AdcCodesToTemp(const UINT16 *codes, INT16 *celsius, UINT32 num);
+
+#endif /* _B91_ADC_CONV_H */
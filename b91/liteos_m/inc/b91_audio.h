@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef _B91_AUDIO_H
+#define _B91_AUDIO_H
+
+#include <los_compiler.h>
+
+#define B91_AUDIO_PERIODS_MAX 8
+
+typedef enum {
+    B91_AUDIO_RX, /* audio FIFO0 to memory on B91_DMA_CHN_AUDIO_RX */
+    B91_AUDIO_TX, /* memory to audio FIFO0 on B91_DMA_CHN_AUDIO_TX */
+    B91_AUDIO_DIR_NUM,
+} B91AudioDir;
+
+/*
+ * Called from the DMA interrupt once per completed period, oldest first. The period then
+ * belongs to the application until B91AudioStreamRelease: RX periods hold fresh samples
+ * to consume, TX periods have been played and are to be refilled. A period completing
+ * while the application holds periods - 1 is not delivered and counted as overrun or
+ * underrun, so every callback is matched by one release.
+ */
+typedef VOID (*B91AudioPeriodCallback)(UINT16 *period, UINT32 samples, VOID *arg);
+
+typedef struct {
+    UINT16 *buf;            /* word aligned ring of periods * periodSamples samples, TX prefilled */
+    UINT16 periodSamples;   /* even, 16-bit samples per period */
+    UINT16 periods;         /* 2 to B91_AUDIO_PERIODS_MAX */
+    B91AudioPeriodCallback callback;
+    VOID *arg;
+} B91AudioStreamConfig;
+
+typedef struct {
+    UINT32 periods;   /* periods handed to the callback */
+    UINT32 overrun;   /* RX periods dropped because none was released in time */
+    UINT32 underrun;  /* TX periods replayed because none was released in time */
+} B91AudioStreamStats;
+
+/**
+ * @brief Start a DMA ring of periods linked descriptors on an audio path set up with the
+ *        SDK audio_init* functions. Each descriptor raises a terminal count interrupt, so
+ *        periods are delivered even when the interrupt is served several periods late.
+ * @return LOS_OK or LOS_NOK on invalid configuration
+ */
+UINT32 B91AudioStreamStart(B91AudioDir dir, const B91AudioStreamConfig *config);
+
+VOID B91AudioStreamStop(B91AudioDir dir);
+
+/**
+ * @brief Hand the oldest delivered period back to the DMA. Can be called from the callback
+ *        or later from a task, up to periods - 1 periods may be held at a time.
+ */
+VOID B91AudioStreamRelease(B91AudioDir dir);
+
+UINT32 B91AudioStreamStatsGet(B91AudioDir dir, B91AudioStreamStats *stats);
+
+/**
+ * @brief Check if a stream is running, the audio clocks stop in suspend
+ */
+BOOL B91AudioStreamBusy(VOID);
+
+#endif /* _B91_AUDIO_H */
@@ -0,0 +1,57 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef _B91_AUDIO_RING_H
+#define _B91_AUDIO_RING_H
+
+#include <los_compiler.h>
+
+/*
+ * Period accounting of the audio DMA ring, free of hardware accesses so it builds for
+ * the host as well. Every period handed to the application is counted until it is
+ * released; a period completing while the application already holds all but the one
+ * the DMA is in is dropped instead, so each delivery is matched by exactly one release.
+ */
+
+typedef enum {
+    B91_AUDIO_RING_IDLE,    /* caught up with the DMA */
+    B91_AUDIO_RING_DELIVER, /* hand the period to the application */
+    B91_AUDIO_RING_DROP,    /* overrun (RX) or underrun (TX), the period is not delivered */
+} B91AudioRingEvent;
+
+typedef struct {
+    UINT32 periods;
+    UINT32 next;  /* period expected to complete next */
+    UINT32 owned; /* periods delivered and not released yet */
+} B91AudioRing;
+
+VOID B91AudioRingInit(B91AudioRing *ring, UINT32 periods);
+
+/**
+ * @brief Take the oldest completed period, call until B91_AUDIO_RING_IDLE
+ * @param cur period the DMA is in, every period before it has completed
+ * @param period set to the completed period unless B91_AUDIO_RING_IDLE is returned
+ */
+B91AudioRingEvent B91AudioRingNext(B91AudioRing *ring, UINT32 cur, UINT32 *period);
+
+/**
+ * @brief Give back the oldest delivered period, ignored when none is held
+ */
+VOID B91AudioRingRelease(B91AudioRing *ring);
+
+#endif /* _B91_AUDIO_RING_H */
@@ -0,0 +1,53 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef _B91_BINLOG_H
+#define _B91_BINLOG_H
+
+#include <los_compiler.h>
+
+#include <hiview_log.h>
+
+/*
+ * Binary HiLog record as sent on the console UART. Multi-byte fields are little endian.
+ *
+ *   u8  sync0     B91_BINLOG_SYNC0
+ *   u8  sync1     B91_BINLOG_SYNC1
+ *   u8  len       number of bytes following, checksum included
+ *   u8  module
+ *   u8  level     level in bits 0..3, argument count in bits 4..7
+ *   u8  task
+ *   u16 milli
+ *   u32 time      seconds
+ *   u32 fmt       address of the format string in the ELF image
+ *   u32 values[]  raw arguments
+ *   u8  checksum  sum of bytes from module to the last argument, modulo 256
+ *
+ * util/hilog_decoder.py reassembles the text from the ELF string table on the host.
+ */
+#define B91_BINLOG_SYNC0 0xA5
+#define B91_BINLOG_SYNC1 0x91
+
+/**
+ * @brief Serialize a HiLog record without formatting it and queue it on the console
+ * @param content record provided by the HiLog framework
+ * @return number of bytes queued
+ */
+UINT32 B91BinLogWrite(const HiLogContent *content);
+
+#endif /* _B91_BINLOG_H */
@@ -0,0 +1,91 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef _B91_CONSOLE_H
+#define _B91_CONSOLE_H
+
+#include <los_compiler.h>
+
+#include <B91/uart.h>
+
+#if defined(LOSCFG_TELINK_B91_PBUF)
+#include <b91_pbuf.h>
+#endif /* LOSCFG_TELINK_B91_PBUF */
+
+typedef enum {
+    B91_CONSOLE_OVERFLOW_DROP,  /* discard what does not fit and count it */
+    B91_CONSOLE_OVERFLOW_BLOCK, /* wait for the DMA to free space */
+} B91ConsoleOverflowPolicy;
+
+/**
+ * @brief Attach the console ring buffer to an already initialized UART
+ * @param uart UART used for output
+ * @return LOS_OK, LOS_NOK if the DMA channel is taken; output stays polled then
+ */
+UINT32 B91ConsoleInit(uart_num_e uart);
+
+/**
+ * @brief Queue data for asynchronous transmission
+ * @param data data to send
+ * @param size number of bytes
+ * @return number of bytes queued
+ */
+UINT32 B91ConsoleWrite(const CHAR *data, UINT32 size);
+
+#if defined(LOSCFG_TELINK_B91_PBUF)
+/**
+ * @brief Queue a packet for transmission without copying it. The console takes its own
+ *        reference and sends the buffers by DMA straight from their payload once the text
+ *        written before it has gone out, so packets and text keep their write order.
+ *        The overflow policy applies to the packet queue as well.
+ * @return LOS_OK or LOS_NOK when the packet was dropped
+ */
+UINT32 B91ConsoleWritePbuf(B91Pbuf *p);
+#endif /* LOSCFG_TELINK_B91_PBUF */
+
+VOID B91ConsoleSetOverflowPolicy(B91ConsoleOverflowPolicy policy);
+
+/**
+ * @brief Get number of bytes discarded because the ring buffer was full
+ */
+UINT32 B91ConsoleDroppedGet(VOID);
+
+/**
+ * @brief Check whether queued data or a chunk in flight still needs the UART clocks
+ */
+BOOL B91ConsoleBusy(VOID);
+
+/**
+ * @brief Stop starting new chunks and wait until the chunk in flight has left the UART,
+ *        e.g. around a UART clock change. Queued data stays queued; writers that would
+ *        block on a full ring sleep meanwhile, or drop when they cannot sleep.
+ */
+VOID B91ConsoleHold(VOID);
+
+/**
+ * @brief Undo B91ConsoleHold and send what was queued meanwhile
+ */
+VOID B91ConsoleResume(VOID);
+
+/**
+ * @brief Synchronously drain everything queued so far. Interrupts stay disabled on return,
+ *        so this is only meant for fatal error paths.
+ */
+VOID B91ConsolePanicFlush(VOID);
+
+#endif /* _B91_CONSOLE_H */
@@ -0,0 +1,57 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef _B91_DMA_H
+#define _B91_DMA_H
+
+#include <los_compiler.h>
+
+#include <B91/dma.h>
+
+/*
+ * DMA channel allocation of the port.
+ * DMA0 and DMA1 are owned by the BLE controller (RF RX/TX).
+ */
+#define B91_DMA_CHN_CONSOLE_TX DMA2
+#define B91_DMA_CHN_UART0_RX   DMA3
+#define B91_DMA_CHN_UART1_RX   DMA4
+#define B91_DMA_CHN_AUDIO_RX   DMA4 /* audio and UART1 exclude each other */
+#define B91_DMA_CHN_UART0_TX   DMA5
+#define B91_DMA_CHN_ADC        DMA5 /* UART0 is the console, which transmits on CONSOLE_TX */
+#define B91_DMA_CHN_UART1_TX   DMA6
+#define B91_DMA_CHN_AUDIO_TX   DMA6
+#define B91_DMA_CHN_SPI        DMA7
+#define B91_DMA_CHN_I2C        DMA7 /* only used when the SPI engine is not built */
+
+#define B91_DMA_EVENT_TC  BIT(0)
+#define B91_DMA_EVENT_ERR BIT(1)
+#define B91_DMA_EVENT_ABT BIT(2)
+
+typedef VOID (*B91DmaCallback)(VOID *arg, UINT32 events);
+
+/**
+ * @brief Attach a completion handler to a DMA channel and unmask its terminal count interrupt.
+ *        All channels share IRQ5_DMA, the dispatcher demultiplexes them by status bits.
+ * @param chn DMA channel
+ * @param callback handler called from interrupt context, NULL to detach
+ * @param arg user argument passed to the handler
+ * @return LOS_OK, LOS_NOK if the channel already has another handler
+ */
+UINT32 B91DmaIrqRegister(dma_chn_e chn, B91DmaCallback callback, VOID *arg);
+
+#endif /* _B91_DMA_H */
@@ -0,0 +1,72 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef _B91_DVFS_H
+#define _B91_DVFS_H
+
+#include <los_compiler.h>
+
+typedef enum {
+    B91_DVFS_CLIENT_SYSTEM,
+    B91_DVFS_CLIENT_BLE,
+    B91_DVFS_CLIENT_CRYPTO,
+    B91_DVFS_CLIENT_AUDIO,
+    B91_DVFS_CLIENT_SENSOR,
+    B91_DVFS_CLIENT_APP,
+    B91_DVFS_CLIENT_NUM,
+} B91DvfsClient;
+
+typedef enum {
+    B91_DVFS_PRE_CHANGE,  /* old clocks still running: hold new transfers, drain the ones in flight */
+    B91_DVFS_POST_CHANGE, /* sys_clk holds the new clocks: reprogram dividers, resume transfers */
+} B91DvfsEvent;
+
+/* Called around every switch from the requesting task, with interrupts enabled */
+typedef VOID (*B91DvfsNotifier)(B91DvfsEvent event, VOID *arg);
+
+/**
+ * @brief Create the lock serializing switches. Call after LOS_KernelInit.
+ * @return LOS_OK or the LOS_MuxCreate error
+ */
+UINT32 B91DvfsInit(VOID);
+
+/**
+ * @brief Set the minimum CPU clock a client needs and switch to the slowest clock_init
+ *        preset satisfying all clients. Interrupts are locked for the switch only; the
+ *        kernel tick clock is measured again afterwards. Until the first request the CPU
+ *        keeps running at LOSCFG_TELINK_B91_CPU_FREQ. Not from interrupts.
+ * @param client voting client
+ * @param minHz minimum CPU clock in Hz, 0 withdraws the vote
+ * @return LOS_OK, LOS_NOK on invalid client or failed switch, or the LOS_MuxPend error
+ */
+UINT32 B91DvfsRequest(B91DvfsClient client, UINT32 minHz);
+
+/**
+ * @brief Register a callback for peripherals clocked from HCLK/PCLK. Registering the
+ *        same callback and argument again is a no-op.
+ * @return LOS_OK or LOS_NOK when all notifier slots are taken; the peripheral would keep
+ *         dividers for the old clock then, so callers must not ignore it
+ */
+UINT32 B91DvfsNotifierRegister(B91DvfsNotifier notifier, VOID *arg);
+
+/**
+ * @brief Get current CPU clock in Hz
+ */
+UINT32 B91DvfsFreqGet(VOID);
+
+#endif /* _B91_DVFS_H */
@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#ifndef _B91_GPIO_H
+#define _B91_GPIO_H
+
+#include <stdint.h>
+
+/*
+ * Port-wide operations on the HDF GPIO controller. Bit i of a mask is HDF GPIO index i
+ * (the pinMap order in gpio_config.hcs), so only the first 32 indexes can be addressed.
+ * Each port touched costs one read-modify-write of its output register, and all ports are
+ * updated with interrupts locked. Pins must already be configured as outputs (or inputs
+ * for B91GpioReadMask) through the regular HDF GPIO API.
+ * All functions return HDF_SUCCESS, or HDF_ERR_INVALID_PARAM if the mask names a pin
+ * the controller does not expose.
+ */
+
+/**
+ * @brief Drive the pins in mask to the matching bits of value in one step
+ */
+int32_t B91GpioWriteMask(uint32_t mask, uint32_t value);
+
+int32_t B91GpioSetMask(uint32_t mask);
+int32_t B91GpioClearMask(uint32_t mask);
+int32_t B91GpioToggleMask(uint32_t mask);
+
+/**
+ * @brief Sample the input level of all ports at once and return the pins in mask
+ */
+int32_t B91GpioReadMask(uint32_t mask, uint32_t *value);
+
+typedef struct {
+    uint32_t tick;  /* stimer tick of the edge, SYSTEM_TIMER_TICK_1US ticks per microsecond */
+    uint16_t gpio;  /* HDF GPIO index */
+    uint16_t level; /* GPIO_VAL_HIGH after a rising edge, GPIO_VAL_LOW after a falling one */
+} B91GpioEvent;
+
+/**
+ * @brief Drain debounced edges of the pins listed in the eventPins HCS attribute
+ *
+ * The interrupt handler stamps every edge of those pins into a ring; this call runs the
+ * per-pin eventDebounceUs filter over them in the caller's context. An edge is dropped if
+ * it does not change the level or falls inside the window opened by the previous accepted
+ * edge, so a short glitch disappears entirely. When a pin ends up on a different level
+ * after bouncing, that level is reported by the first call after the window has closed.
+ * The regular HDF callback still runs for event pins and can be used to wake the reader.
+ * Use GPIO_IRQ_TRIGGER_RISING | GPIO_IRQ_TRIGGER_FALLING to capture both edges.
+ * Single reader only.
+ *
+ * @param events output array
+ * @param max capacity of events
+ * @param num number of events written
+ */
+int32_t B91GpioEventRead(B91GpioEvent *events, uint32_t max, uint32_t *num);
+
+/**
+ * @brief Number of raw edges dropped because the capture ring was full
+ */
+uint32_t B91GpioEventLostGet(void);
+
+#endif /* _B91_GPIO_H */
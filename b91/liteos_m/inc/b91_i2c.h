@@ -0,0 +1,95 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#ifndef _B91_I2C_H
+#define _B91_I2C_H
+
+#include <los_compiler.h>
+
+#include <B91/i2c.h>
+
+#define B91_I2C_MSG_READ    BIT(0)
+#define B91_I2C_MSG_NOSTART BIT(1) /* continue the previous message without a repeated start */
+#define B91_I2C_MSG_STOP    BIT(2) /* stop after this message, the last one always stops */
+
+#define B91_I2C_ERR_NACK    0x100
+#define B91_I2C_ERR_TIMEOUT 0x101
+
+typedef struct {
+    UINT8 *buf;
+    UINT16 len; /* 1 to 65535 bytes */
+    UINT8 addr; /* 7-bit address */
+    UINT8 flags;
+} B91I2cMsg;
+
+typedef struct B91I2cXfer B91I2cXfer;
+
+/*
+ * Called from interrupt or software timer context once the transaction ended.
+ * NACKs are seen at the end of write frames and after the address of a read.
+ */
+typedef VOID (*B91I2cCallback)(B91I2cXfer *xfer, VOID *arg);
+
+/*
+ * A run of messages separated by repeated starts, e.g. a register address write followed
+ * by a read. Messages longer than the FIFO use DMA when their buffer is word aligned.
+ */
+struct B91I2cXfer {
+    B91I2cXfer *next; /* owned by the engine while queued */
+    B91I2cMsg *msgs;
+    UINT16 num;
+    UINT16 done; /* messages completed */
+    B91I2cCallback callback;
+    VOID *arg;
+    UINT32 status; /* LOS_OK, B91_I2C_ERR_NACK, B91_I2C_ERR_TIMEOUT or LOS_NOK on DMA error */
+};
+
+typedef struct {
+    i2c_sda_pin_e sda;
+    i2c_scl_pin_e scl;
+    UINT32 speedHz;
+    UINT32 timeoutMs; /* per transaction, from its start on the bus */
+} B91I2cConfig;
+
+/**
+ * @brief Set up the I2C controller as a master for the transaction engine
+ * @return LOS_OK or LOS_NOK on invalid configuration
+ */
+UINT32 B91I2cInit(const B91I2cConfig *config);
+
+/**
+ * @brief Queue a transaction, it starts right away if the bus is idle.
+ *        May be called from interrupts and from completion callbacks.
+ * @return LOS_OK or LOS_NOK on invalid transaction
+ */
+UINT32 B91I2cSubmit(B91I2cXfer *xfer);
+
+/**
+ * @brief Submit a transaction and wait until it ended, not from interrupts.
+ *        xfer->callback and xfer->arg are overwritten.
+ * @return xfer->status or the submission error
+ */
+UINT32 B91I2cTransfer(B91I2cXfer *xfer);
+
+/**
+ * @brief Check if transactions are queued or running
+ */
+BOOL B91I2cBusy(VOID);
+
+#endif /* _B91_I2C_H */
@@ -0,0 +1,107 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#ifndef _B91_KEYMATRIX_H
+#define _B91_KEYMATRIX_H
+
+#include <los_compiler.h>
+
+/*
+ * Key matrix scan engine. Lines are reached through B91KeymatrixIo only, so the engine
+ * builds for the host and can be driven by a GPIO model there. Keys are addressed by the
+ * driven column and the sensed row; each column keeps one bit per row.
+ */
+
+#define B91_KEYMATRIX_MAX_COLS   16
+#define B91_KEYMATRIX_MAX_ROWS   16
+#define B91_KEYMATRIX_EVENTS     16
+#define B91_KEYMATRIX_COL_NONE   0xFF /* release all columns */
+#define B91_KEYMATRIX_COL_ALL    0xFE /* drive all columns at once */
+
+typedef struct {
+    /* drive one column (or none/all) active, the others are released */
+    VOID (*colSelect)(VOID *arg, UINT32 col);
+    /* bitmap of the rows that see an active column */
+    UINT32 (*rowRead)(VOID *arg);
+    /* enable or disable wakeup on an active level of the rows in the bitmap, may be NULL */
+    VOID (*rowWakeSet)(VOID *arg, UINT32 rows, BOOL enable);
+    VOID *arg;
+} B91KeymatrixIo;
+
+typedef struct {
+    UINT32 tick;  /* caller's time base, passed to B91KeymatrixScan */
+    UINT8 col;
+    UINT8 row;
+    UINT8 pressed;
+} B91KeyEvent;
+
+typedef struct {
+    const B91KeymatrixIo *io;
+    UINT8 cols;
+    UINT8 rows;
+
+    /* debounced state and two-bit vertical counters, one bit per row */
+    UINT16 stable[B91_KEYMATRIX_MAX_COLS];
+    UINT16 ct0[B91_KEYMATRIX_MAX_COLS];
+    UINT16 ct1[B91_KEYMATRIX_MAX_COLS];
+
+    B91KeyEvent events[B91_KEYMATRIX_EVENTS];
+    volatile UINT32 head;
+    volatile UINT32 tail;
+
+    UINT32 lost;
+    UINT32 ghosts;
+} B91Keymatrix;
+
+/**
+ * @brief Reset the matrix state
+ * @return LOS_OK or LOS_NOK on invalid dimensions
+ */
+UINT32 B91KeymatrixInit(B91Keymatrix *km, const B91KeymatrixIo *io, UINT32 cols, UINT32 rows);
+
+/**
+ * @brief Scan the matrix once and queue the debounced key changes
+ *
+ * A key changes state after four consecutive scans agree. While all keys are up and
+ * settled, a scan costs a single read with all columns driven. Columns sharing two or
+ * more pressed rows make the fourth corner of the rectangle ambiguous (ghosting): those
+ * columns keep their previous state until the ambiguity is gone.
+ *
+ * @param tick time stamp for the queued events
+ * @return TRUE while any key is down or still being debounced
+ */
+BOOL B91KeymatrixScan(B91Keymatrix *km, UINT32 tick);
+
+/**
+ * @brief Take the oldest queued key event, single consumer
+ * @return LOS_OK or LOS_NOK if the queue is empty
+ */
+UINT32 B91KeymatrixEventGet(B91Keymatrix *km, B91KeyEvent *event);
+
+/**
+ * @brief Drive all columns and arm the row wakeup, so any key press ends a suspend
+ */
+VOID B91KeymatrixWakeArm(B91Keymatrix *km);
+
+/**
+ * @brief Undo B91KeymatrixWakeArm; the key that caused the wakeup shows up in the next scans
+ */
+VOID B91KeymatrixWakeDisarm(B91Keymatrix *km);
+
+#endif /* _B91_KEYMATRIX_H */
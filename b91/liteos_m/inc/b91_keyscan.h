@@ -0,0 +1,66 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#ifndef _B91_KEYSCAN_H
+#define _B91_KEYSCAN_H
+
+#include <los_compiler.h>
+
+#include <B91/gpio.h>
+
+#include <b91_keymatrix.h>
+
+typedef struct {
+    const gpio_pin_e *cols; /* driven low one at a time, high impedance otherwise */
+    const gpio_pin_e *rows; /* sensed with pull-ups, also the suspend wakeup pads */
+    UINT8 colNum;
+    UINT8 rowNum;
+} B91KeyscanConfig;
+
+/**
+ * @brief Configure the matrix lines and start scanning from a TIMER0 interrupt
+ *        at LOSCFG_TELINK_B91_KEYSCAN_HZ. The timer stops while all keys are up and a
+ *        row edge on gpio2risc1 starts it again.
+ * @param config pin lists, must stay valid while scanning
+ * @return LOS_OK or LOS_NOK on invalid configuration
+ */
+UINT32 B91KeyscanInit(const B91KeyscanConfig *config);
+
+/**
+ * @brief Wait for the next debounced key change
+ * @param event key event
+ * @param timeout kernel ticks to wait, LOS_WAIT_FOREVER or 0
+ * @return LOS_OK or LOS_NOK if no event arrived in time
+ */
+UINT32 B91KeyscanEventGet(B91KeyEvent *event, UINT32 timeout);
+
+/**
+ * @brief A key is down or still being debounced, so suspend would lose key changes
+ */
+BOOL B91KeyscanBusy(VOID);
+
+/**
+ * @brief Drive all columns and arm the rows as low level wakeup pads before suspend,
+ *        so any key press ends it. B91KeyscanWakeDisarm restores the scan state.
+ */
+VOID B91KeyscanWakeArm(VOID);
+
+VOID B91KeyscanWakeDisarm(VOID);
+
+#endif /* _B91_KEYSCAN_H */
@@ -0,0 +1,72 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef _B91_MEM_H
+#define _B91_MEM_H
+
+#include <los_compiler.h>
+
+typedef enum {
+    B91_MEM_ILM, /* kernel system pool: the ILM heap with most of the free DLM tail added */
+    B91_MEM_DLM, /* DMA pool at the start of the DLM tail, kept for DMA buffers */
+    B91_MEM_REGION_NUM,
+} B91MemRegion;
+
+typedef struct {
+    UINT32 totalSize;
+    UINT32 usedSize;
+    UINT32 freeSize;
+    UINT32 maxFreeBlock;  /* largest contiguous allocation still possible */
+    UINT32 fragmentation; /* 0..100, 100 - maxFreeBlock * 100 / freeSize */
+} B91MemStats;
+
+/**
+ * @brief Add the free DLM tail to the system pool, so malloc and LOS_MemAlloc span both
+ *        RAMs, and set up the DLM DMA pool and the small object pools. Must be called
+ *        after LOS_KernelInit and before the system pool is used from other tasks.
+ */
+VOID B91MemInit(VOID);
+
+/**
+ * @brief Allocate memory from the system pool, or for B91_MEM_DLM from the size class
+ *        pools or the DMA pool first, falling back to the system pool.
+ * @param region preferred region
+ * @param size number of bytes
+ * @return pointer to memory aligned to at least 4 bytes or NULL
+ */
+VOID *B91MemAlloc(B91MemRegion region, UINT32 size);
+
+/**
+ * @brief Allocate a word aligned DMA buffer from the DLM DMA pool, falling back to the
+ *        system pool
+ */
+VOID *B91MemAllocDma(UINT32 size);
+
+/**
+ * @brief Free memory returned by B91MemAlloc or B91MemAllocDma
+ */
+VOID B91MemFree(VOID *ptr);
+
+UINT32 B91MemStatsGet(B91MemRegion region, B91MemStats *stats);
+
+/**
+ * @brief Print statistics of both regions and of the size class pools
+ */
+VOID B91MemDump(VOID);
+
+#endif /* _B91_MEM_H */
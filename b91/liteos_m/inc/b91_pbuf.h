@@ -0,0 +1,111 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef _B91_PBUF_H
+#define _B91_PBUF_H
+
+#include <los_compiler.h>
+
+#include <b91_mem.h>
+
+/*
+ * Fixed size, reference counted buffers that can be chained into packets larger than
+ * one block. payload is word aligned, so it can be handed to the DMA as is.
+ */
+typedef struct B91Pbuf {
+    struct B91Pbuf *next; /* next buffer of the same packet */
+    UINT8 *payload;
+    UINT16 len;    /* bytes in this buffer */
+    UINT16 totLen; /* bytes in this and all following buffers */
+    UINT8 ref;
+    UINT8 region;
+    UINT16 reserved;
+} B91Pbuf;
+
+/**
+ * @brief Set up the block pools. Must be called after LOS_KernelInit.
+ */
+VOID B91PbufInit(VOID);
+
+/**
+ * @brief Allocate a packet of size bytes, chaining as many blocks as needed.
+ *        Falls back to the other region when the preferred one is exhausted.
+ *        May be called from interrupts.
+ * @param region preferred region
+ * @param size packet length
+ * @return packet with a reference count of one, or NULL
+ */
+B91Pbuf *B91PbufAlloc(B91MemRegion region, UINT32 size);
+
+/**
+ * @brief Take an additional reference on a buffer and thereby on the rest of its chain
+ */
+VOID B91PbufRef(B91Pbuf *p);
+
+/**
+ * @brief Drop a reference. Buffers reaching zero are returned to their pool and the
+ *        reference they held on the next buffer of the chain is dropped too.
+ *        May be called from interrupts.
+ */
+VOID B91PbufFree(B91Pbuf *p);
+
+/**
+ * @brief Append tail to head. The reference the caller held on tail moves to head.
+ * @return LOS_OK, or LOS_NOK without touching either packet if the result would be
+ *         longer than totLen can hold
+ */
+UINT32 B91PbufCat(B91Pbuf *head, B91Pbuf *tail);
+
+/**
+ * @brief Append tail to head, the caller keeps its own reference on tail
+ * @return LOS_OK or LOS_NOK as B91PbufCat
+ */
+UINT32 B91PbufChain(B91Pbuf *head, B91Pbuf *tail);
+
+/**
+ * @brief Shrink a packet, e.g. to the length a DMA transfer actually received.
+ *        Buffers no longer needed are freed.
+ */
+VOID B91PbufTrim(B91Pbuf *p, UINT32 len);
+
+/**
+ * @brief Copy part of a packet into a flat buffer
+ * @return number of bytes copied
+ */
+UINT32 B91PbufCopyOut(const B91Pbuf *p, VOID *dst, UINT32 len, UINT32 offset);
+
+/**
+ * @brief Copy a flat buffer into part of a packet
+ * @return number of bytes copied, less than len if the packet is shorter
+ */
+UINT32 B91PbufCopyIn(B91Pbuf *p, const VOID *src, UINT32 len, UINT32 offset);
+
+/**
+ * @brief Send a packet as a GATT notification. A single buffer goes to the stack
+ *        without an intermediate copy, chains are flattened first.
+ * @return ble_sts_t status of blc_gatt_pushHandleValueNotify
+ */
+UINT32 B91PbufGattNotify(UINT16 connHandle, UINT16 attHandle, const B91Pbuf *p);
+
+/**
+ * @brief Write a packet to a file opened with HalFileOpen, one write per buffer
+ * @return number of bytes written or -1
+ */
+INT32 B91PbufFileWrite(INT32 fd, const B91Pbuf *p);
+
+#endif /* _B91_PBUF_H */
@@ -0,0 +1,39 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef _B91_PM_H
+#define _B91_PM_H
+
+#include <los_compiler.h>
+
+/**
+ * @brief Register the stimer based tick timer and the suspend hooks with the kernel
+ *        PM framework and switch the idle task to light sleep. Call after LOS_KernelInit.
+ * @return LOS_OK or the LOS_PmRegister/LOS_PmModeSet error
+ */
+UINT32 B91PmInit(VOID);
+
+/**
+ * @brief Keep the idle task out of suspend, e.g. while a peripheral transfer is in progress.
+ *        Calls nest and may be made from interrupts.
+ */
+VOID B91PmWakeLock(VOID);
+
+VOID B91PmWakeUnlock(VOID);
+
+#endif /* _B91_PM_H */
@@ -0,0 +1,40 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef _B91_PROFILER_H
+#define _B91_PROFILER_H
+
+#include <los_compiler.h>
+
+/**
+ * @brief Start sampling the interrupted PC and the running task from a TIMER1 interrupt.
+ *        With DVFS the timer period is recomputed on every clock switch.
+ * @param hz sampling frequency
+ * @return LOS_OK, or LOS_NOK on invalid frequency or no free DVFS notifier slot
+ */
+UINT32 B91ProfilerStart(UINT32 hz);
+
+VOID B91ProfilerStop(VOID);
+
+/**
+ * @brief Print the task table and drain the collected samples to the console
+ *        in the text format util/profile_report.py reads
+ */
+VOID B91ProfilerDump(VOID);
+
+#endif /* _B91_PROFILER_H */
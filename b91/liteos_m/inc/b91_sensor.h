@@ -0,0 +1,70 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#ifndef _B91_SENSOR_H
+#define _B91_SENSOR_H
+
+#include <los_compiler.h>
+
+typedef struct B91Sensor B91Sensor;
+
+/* Runs in the scheduler task, may block on B91I2cTransfer/B91SpiTransfer */
+typedef VOID (*B91SensorRead)(B91Sensor *sensor, VOID *arg);
+
+/*
+ * A periodically polled sensor. A read is due every periodUs; it may run up to slackUs
+ * early so that it shares a wakeup with other due reads or with a BLE connection event.
+ */
+struct B91Sensor {
+    B91Sensor *next; /* owned by the scheduler */
+    B91SensorRead read;
+    VOID *arg;
+    UINT32 periodUs;
+    UINT32 slackUs;
+    UINT32 durationUs; /* worst case bus time of one read, to fit it between radio events */
+    UINT32 due;        /* stimer tick, owned by the scheduler */
+};
+
+typedef struct {
+    UINT32 batches; /* wakeups of the scheduler that ran reads */
+    UINT32 reads;
+    UINT32 late;    /* reads run after their due tick because the radio was busy */
+} B91SensorStats;
+
+/**
+ * @brief Create the sensor scheduler task. Call after LOS_KernelInit.
+ * @return LOS_OK or the LOS_BinarySemCreate/LOS_MuxCreate/LOS_TaskCreate error
+ */
+UINT32 B91SensorSchedInit(VOID);
+
+/**
+ * @brief Start polling a sensor, the first read is due one period from now
+ * @return LOS_OK or LOS_NOK on invalid sensor or if it is already added
+ */
+UINT32 B91SensorAdd(B91Sensor *sensor);
+
+/**
+ * @brief Stop polling a sensor. A read in progress completes first.
+ * @return LOS_OK or LOS_NOK if the sensor is not added
+ */
+UINT32 B91SensorRemove(B91Sensor *sensor);
+
+VOID B91SensorStatsGet(B91SensorStats *stats);
+
+#endif /* _B91_SENSOR_H */
@@ -0,0 +1,60 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef _B91_SLEEP_POLICY_H
+#define _B91_SLEEP_POLICY_H
+
+#include <los_compiler.h>
+
+/*
+ * The sleep decision is kept free of hardware accesses so it builds for the host as well,
+ * test/host/sleep_policy_test.c covers it.
+ */
+
+#define B91_SLEEP_RADIO_IDLE 0xFFFFFFFFU /* no advertising or connection events to keep clear of */
+
+typedef enum {
+    B91_SLEEP_NONE,    /* a timer is already due */
+    B91_SLEEP_WFI,     /* clocks keep running, woken by the kernel tick */
+    B91_SLEEP_SUSPEND, /* clocks stopped, woken by the stimer */
+} B91SleepMode;
+
+typedef struct {
+    UINT32 minSuspendTicks;   /* shorter idle periods cost more to enter and leave suspend than they save */
+    UINT32 wakeupMarginTicks; /* suspend exit latency, the stimer wakeup is moved earlier by this much */
+    UINT32 maxSleepTicks;     /* longest stimer wakeup the SDK supports */
+} B91SleepPolicy;
+
+typedef struct {
+    UINT32 idleTicks;  /* stimer ticks until the next kernel timer expiry */
+    UINT32 radioTicks; /* stimer ticks until the BLE stack needs the CPU, or B91_SLEEP_RADIO_IDLE */
+    UINT32 wakeLocks;  /* B91PmWakeLock holders */
+    BOOL busy;         /* a peripheral transfer would be cut by suspend */
+} B91SleepState;
+
+/**
+ * @brief Choose how to spend an idle period. Suspend ends before whichever comes first,
+ *        the next kernel timer or the next radio event.
+ * @param policy thresholds, in stimer ticks
+ * @param state what the idle period is bounded and blocked by
+ * @param wakeTicks stimer ticks from now to program the wakeup to, set for B91_SLEEP_SUSPEND only
+ * @return chosen sleep mode
+ */
+B91SleepMode B91SleepDecide(const B91SleepPolicy *policy, const B91SleepState *state, UINT32 *wakeTicks);
+
+#endif /* _B91_SLEEP_POLICY_H */
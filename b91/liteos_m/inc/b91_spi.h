@@ -0,0 +1,101 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#ifndef _B91_SPI_H
+#define _B91_SPI_H
+
+#include <los_compiler.h>
+
+#include <B91/spi.h>
+
+/* Bytes a transaction may write before its DMA read: they go through the TX FIFO */
+#define B91_SPI_HEADER_MAX 8
+
+#define B91_SPI_XFER_CMD  BIT(0) /* send cmd in a command phase */
+#define B91_SPI_XFER_ADDR BIT(1) /* HSPI only: send addr in an address phase of addrLen bytes */
+#define B91_SPI_XFER_WIDE BIT(2) /* HSPI only: command and address phases use ioMode too */
+
+typedef struct B91SpiXfer B91SpiXfer;
+
+/* Called from interrupt context once the transaction ended, the next one is already running */
+typedef VOID (*B91SpiCallback)(B91SpiXfer *xfer, VOID *arg);
+
+/*
+ * One chip select cycle: [cmd] [addr] [tx] [dummy] [rx]. A transaction with both tx and
+ * rx writes a short header of at most B91_SPI_HEADER_MAX bytes then reads by DMA; without
+ * a command phase it must carry data. DMA buffers must be word aligned.
+ */
+struct B91SpiXfer {
+    B91SpiXfer *next; /* owned by the engine while queued */
+    spi_sel_e spi;
+    UINT32 csPin; /* hspi_csn_pin_def_e or pspi_csn_pin_def_e */
+    spi_mode_type_e mode;
+    spi_io_mode_e ioMode;
+    UINT8 flags;
+    UINT8 cmd;
+    UINT8 addrLen;
+    UINT8 dummy; /* dummy cycles before rx, or before tx for a write only transaction */
+    UINT32 addr;
+    const UINT8 *tx;
+    UINT32 txLen;
+    UINT8 *rx;
+    UINT32 rxLen;
+    B91SpiCallback done;
+    VOID *arg;
+    UINT32 status; /* LOS_OK, or LOS_NOK when the DMA reported an error */
+};
+
+/**
+ * @brief Set up an SPI module as a master for the transaction engine. The pins are muxed
+ *        by the caller with hspi_set_pin or pspi_set_pin. Both modules share
+ *        B91_DMA_CHN_SPI, so transactions run one at a time in submission order.
+ *        A transaction not over within LOSCFG_TELINK_B91_SPI_TIMEOUT_MS is aborted with
+ *        LOS_NOK and the module is reset.
+ * @param clkDiv spi clock = module clock (hclk for HSPI, pclk for PSPI) / ((clkDiv + 1) * 2).
+ *        With DVFS the divider is picked again on every switch so the clock never exceeds
+ *        the one set up here, see B91SpiClockGet.
+ * @return LOS_OK, LOS_NOK on invalid module or the LOS_SwtmrCreate error
+ */
+UINT32 B91SpiInit(spi_sel_e spi, UINT8 clkDiv);
+
+/**
+ * @brief Queue a transaction, it starts right away if the engine is idle.
+ *        May be called from interrupts and from completion callbacks.
+ * @return LOS_OK or LOS_NOK on invalid descriptor
+ */
+UINT32 B91SpiSubmit(B91SpiXfer *xfer);
+
+/**
+ * @brief Submit a transaction and wait until it ended, not from interrupts.
+ *        xfer->done and xfer->arg are overwritten.
+ * @return xfer->status or the submission error
+ */
+UINT32 B91SpiTransfer(B91SpiXfer *xfer);
+
+/**
+ * @brief Check if transactions are queued or running
+ */
+BOOL B91SpiBusy(VOID);
+
+/**
+ * @brief Get the current clock of a bus in Hz, 0 if it is not set up
+ */
+UINT32 B91SpiClockGet(spi_sel_e spi);
+
+#endif /* _B91_SPI_H */
@@ -0,0 +1,67 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef _B91_STACK_MONITOR_H
+#define _B91_STACK_MONITOR_H
+
+#include <los_compiler.h>
+
+/* Pattern BoardConfig paints the interrupt stacks with before first use */
+#define B91_INT_STACK_MAGIC UINT32_C(0xDEADBEEF)
+
+typedef enum {
+    B91_INT_STACK_START_AND_IRQ,
+    B91_INT_STACK_EXCEPTION,
+    B91_INT_STACK_NMI,
+    B91_INT_STACK_NUM,
+} B91IntStackId;
+
+typedef struct {
+    UINT32 size;     /* bytes */
+    UINT32 peakUsed; /* high watermark in bytes */
+} B91StackUsage;
+
+/**
+ * @brief Measure the high watermark of one of the interrupt stacks
+ * @param id interrupt stack
+ * @param usage result
+ * @return LOS_OK or LOS_NOK on invalid parameters
+ */
+UINT32 B91IntStackUsageGet(B91IntStackId id, B91StackUsage *usage);
+
+/**
+ * @brief Measure the high watermark of a task stack
+ * @param taskID LiteOS task ID
+ * @param usage result
+ * @return LOS_OK or the error of LOS_TaskInfoGet
+ */
+UINT32 B91TaskStackUsageGet(UINT32 taskID, B91StackUsage *usage);
+
+/**
+ * @brief Print the watermark of the interrupt stacks and of every created task
+ */
+VOID B91StackMonitorDump(VOID);
+
+/**
+ * @brief Start a low priority task which calls B91StackMonitorDump periodically
+ * @param periodMs report period
+ * @return LOS_OK or the error of LOS_TaskCreate
+ */
+UINT32 B91StackMonitorStart(UINT32 periodMs);
+
+#endif /* _B91_STACK_MONITOR_H */
@@ -0,0 +1,35 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#ifndef _B91_UART_H
+#define _B91_UART_H
+
+#include <stdbool.h>
+
+/*
+ * Extensions of the HDF UART controller. Only UARTs enabled with
+ * LOSCFG_TELINK_B91_HDF_UART0/LOSCFG_TELINK_B91_HDF_UART1 are probed.
+ */
+
+/**
+ * @brief Check if a write is still being sent on any HDF UART, the UART clocks stop in suspend
+ */
+bool B91UartTxBusy(void);
+
+#endif /* _B91_UART_H */
@@ -0,0 +1,104 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#ifndef _B91_UART_RX_H
+#define _B91_UART_RX_H
+
+#include <los_compiler.h>
+
+#include <B91/uart.h>
+
+#if defined(LOSCFG_TELINK_B91_PBUF)
+#include <b91_pbuf.h>
+#endif /* LOSCFG_TELINK_B91_PBUF */
+
+/* Called from the UART interrupt after the line went idle, i.e. at the end of a frame */
+typedef VOID (*B91UartRxNotify)(uart_num_e uart, VOID *arg);
+
+typedef struct {
+    UINT8 *buf;   /* word aligned ring, owned by the receiver until B91UartRxStop */
+    UINT32 size;  /* power of two, at least 64 bytes */
+    UINT8 bwpc;   /* bit width from uart_cal_div_and_bwpc, scales the idle timeout */
+    B91UartRxNotify notify;
+    VOID *arg;
+} B91UartRxConfig;
+
+typedef struct {
+    UINT32 frames;   /* idle gaps seen */
+    UINT32 overrun;  /* bytes discarded because the reader fell a full ring behind */
+    UINT32 errors;   /* parity/framing errors */
+} B91UartRxStats;
+
+/**
+ * @brief Receive continuously by DMA into a ring on an already initialized UART.
+ *        The channel is B91_DMA_CHN_UART0_RX or B91_DMA_CHN_UART1_RX; the UART interrupt
+ *        is taken for the idle timeout, which closes the frame being received.
+ * @return LOS_OK or LOS_NOK on invalid configuration
+ */
+UINT32 B91UartRxStart(uart_num_e uart, const B91UartRxConfig *config);
+
+VOID B91UartRxStop(uart_num_e uart);
+
+/**
+ * @brief Get the unread data in place without copying
+ * @param data set to the oldest unread byte
+ * @param frameEnd set to TRUE if the returned span runs up to the end of a frame
+ * @return number of contiguous bytes at data, less than the total when the ring wraps
+ *         or a frame ends
+ */
+UINT32 B91UartRxPeek(uart_num_e uart, const UINT8 **data, BOOL *frameEnd);
+
+/**
+ * @brief Release bytes returned by B91UartRxPeek, at most the span it returned
+ */
+VOID B91UartRxConsume(uart_num_e uart, UINT32 len);
+
+/**
+ * @brief Copy out up to size bytes, across frame boundaries
+ * @return number of bytes copied
+ */
+UINT32 B91UartRxRead(uart_num_e uart, UINT8 *buf, UINT32 size);
+
+#if defined(LOSCFG_TELINK_B91_PBUF)
+/**
+ * @brief Move the unread bytes of the oldest frame, at most size, out of the ring into a
+ *        new packet that can be passed on to B91ConsoleWritePbuf, B91PbufGattNotify or
+ *        B91PbufFileWrite as is. The rest of a longer frame stays for the next call.
+ * @param region preferred region of the packet, see B91PbufAlloc
+ * @return the packet, or NULL if nothing is unread or no buffers are free; the data is
+ *         left in the ring in that case
+ */
+B91Pbuf *B91UartRxReadPbuf(uart_num_e uart, B91MemRegion region, UINT32 size);
+#endif /* LOSCFG_TELINK_B91_PBUF */
+
+UINT32 B91UartRxStatsGet(uart_num_e uart, B91UartRxStats *stats);
+
+/**
+ * @brief Rescale the idle timeout after the UART divider was reprogrammed, e.g. on a clock switch
+ * @param bwpc new bit width from uart_cal_div_and_bwpc
+ */
+VOID B91UartRxBitWidthSet(uart_num_e uart, UINT8 bwpc);
+
+/**
+ * @brief Check if a running receiver holds unread bytes or is in the middle of a frame,
+ *        the UART clocks stop in suspend
+ */
+BOOL B91UartRxBusy(VOID);
+
+#endif /* _B91_UART_RX_H */
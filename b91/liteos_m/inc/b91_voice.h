@@ -0,0 +1,71 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef _B91_VOICE_H
+#define _B91_VOICE_H
+
+#include <los_compiler.h>
+
+#include <B91/audio.h>
+
+#include <b91_voice_codec.h>
+
+/* Called from the voice task after a frame was queued, to wake the task running the BLE stack */
+typedef VOID (*B91VoiceReady)(VOID *arg);
+
+typedef struct {
+    dmic_pin_group_e dmicPins;
+    UINT16 connHandle;
+    UINT16 attHandle;  /* value handle of the characteristic the frames are notified on */
+    B91VoiceCodecConfig codec;
+    B91VoiceReady ready; /* may be NULL when the BLE task polls on its own */
+    VOID *arg;
+} B91VoiceConfig;
+
+typedef struct {
+    UINT32 frames;   /* 16 ms frames encoded */
+    UINT32 dropped;  /* frames dropped because notifications could not keep up */
+    UINT32 overrun;  /* audio periods overwritten before they were encoded */
+} B91VoiceStats;
+
+/**
+ * @brief Capture a DMIC at 16 kHz through the audio period ring and encode every period
+ *        into a B91VoiceEncode frame in a task. The frames are queued for B91VoicePoll.
+ *        When the link falls behind, frames are dropped whole, so the stream stays frame
+ *        aligned.
+ * @return LOS_OK, LOS_NOK on invalid configuration or if already running
+ */
+UINT32 B91VoiceStart(const B91VoiceConfig *config);
+
+VOID B91VoiceStop(VOID);
+
+/**
+ * @brief Send the queued frames as notifications of up to ATT MTU - 3 bytes. The BLE
+ *        stack is not thread safe: call this only from the task running blt_sdk_main_loop,
+ *        e.g. after every loop and whenever the ready callback woke it.
+ */
+VOID B91VoicePoll(VOID);
+
+/**
+ * @brief Set the effective ATT MTU, from GAP_EVT_ATT_EXCHANGE_MTU. 23 until called.
+ */
+VOID B91VoiceMtuSet(UINT16 mtu);
+
+UINT32 B91VoiceStatsGet(B91VoiceStats *stats);
+
+#endif /* _B91_VOICE_H */
@@ -0,0 +1,95 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef _B91_VOICE_CODEC_H
+#define _B91_VOICE_CODEC_H
+
+#include <los_compiler.h>
+
+/*
+ * Voice encoder: DC blocking high-pass, automatic gain control and IMA ADPCM on 16-bit
+ * mono PCM. Kept free of hardware accesses so it builds for the host as well, where
+ * test/host/voice_wav runs WAV files through it; the decoder mirrors the encoder bit exactly.
+ *
+ * A frame is a 4 byte header (sequence number, predictor low and high byte, step index,
+ * i.e. the encoder state before the frame) followed by two samples per byte, the first
+ * one in the low nibble. Every frame decodes on its own, a lost frame does not desync
+ * the receiver.
+ */
+
+#define B91_VOICE_FRAME_HDR 4
+#define B91_VOICE_FRAME_SIZE(samples) (B91_VOICE_FRAME_HDR + (((samples) + 1) / 2))
+
+typedef struct {
+    UINT16 hpfCoef;        /* Q15 pole of the high-pass, 0 bypasses it; 31506 is 100 Hz at 16 kHz */
+    UINT16 agcTarget;      /* peak level the AGC aims for, 0 bypasses it */
+    UINT16 agcMaxGain;     /* Q8, at least 256 */
+    UINT16 agcNoiseFloor;  /* below this peak envelope the gain is held, so noise is not pumped up */
+} B91VoiceCodecConfig;
+
+typedef struct {
+    INT16 predictor;
+    UINT8 index;
+} B91AdpcmState;
+
+typedef struct {
+    B91VoiceCodecConfig config;
+    INT32 hpfX;      /* previous input */
+    INT32 hpfY;      /* previous output, 8 fractional bits */
+    UINT32 agcEnv;   /* peak envelope */
+    UINT32 agcGain;  /* Q16 */
+    B91AdpcmState adpcm;
+    UINT8 seq;
+} B91VoiceEncoder;
+
+/**
+ * @brief Reset the filter, gain and ADPCM state
+ * @return LOS_OK or LOS_NOK on invalid configuration
+ */
+UINT32 B91VoiceEncoderInit(B91VoiceEncoder *enc, const B91VoiceCodecConfig *config);
+
+VOID B91VoiceHpf(B91VoiceEncoder *enc, INT16 *pcm, UINT32 samples);
+
+/**
+ * @brief Scale a block towards the target peak level. The gain drops at once on a louder
+ *        block and rises over the block once the envelope has decayed.
+ */
+VOID B91VoiceAgc(B91VoiceEncoder *enc, INT16 *pcm, UINT32 samples);
+
+/**
+ * @return bytes written, (samples + 1) / 2
+ */
+UINT32 B91AdpcmEncode(B91AdpcmState *state, const INT16 *pcm, UINT32 samples, UINT8 *out);
+
+VOID B91AdpcmDecode(B91AdpcmState *state, const UINT8 *in, UINT32 samples, INT16 *pcm);
+
+/**
+ * @brief High-pass filter, gain and encode a block in place into one frame
+ * @param out B91_VOICE_FRAME_SIZE(samples) bytes
+ * @return frame length
+ */
+UINT32 B91VoiceEncode(B91VoiceEncoder *enc, INT16 *pcm, UINT32 samples, UINT8 *out);
+
+/**
+ * @brief Decode one frame
+ * @param pcm (len - B91_VOICE_FRAME_HDR) * 2 samples
+ * @return samples decoded, 0 if the frame is too short
+ */
+UINT32 B91VoiceFrameDecode(const UINT8 *frame, UINT32 len, INT16 *pcm);
+
+#endif /* _B91_VOICE_CODEC_H */
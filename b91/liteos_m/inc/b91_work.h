@@ -0,0 +1,51 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef _B91_WORK_H
+#define _B91_WORK_H
+
+#include <los_compiler.h>
+
+typedef VOID (*B91WorkFunc)(UINTPTR arg);
+
+typedef struct {
+    UINT32 executed;
+    UINT32 dropped;      /* posts rejected because the queue was full */
+    UINT32 maxDepth;     /* most items seen pending at once */
+    UINT32 maxLatencyUs; /* longest time from post to execution */
+    UINT32 avgLatencyUs;
+} B91WorkStats;
+
+/**
+ * @brief Create the deferred work task. Call after LOS_KernelInit.
+ * @return LOS_OK or the LOS_BinarySemCreate/LOS_TaskCreate error
+ */
+UINT32 B91WorkInit(VOID);
+
+/**
+ * @brief Queue a function to run in the deferred work task. Lock-free, may be called
+ *        from interrupts and tasks alike. Items run in posting order.
+ * @param func function to run
+ * @param arg argument passed to func
+ * @return LOS_OK or LOS_NOK when the queue is full
+ */
+UINT32 B91WorkPost(B91WorkFunc func, UINTPTR arg);
+
+VOID B91WorkStatsGet(B91WorkStats *stats);
+
+#endif /* _B91_WORK_H */
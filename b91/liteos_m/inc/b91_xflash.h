@@ -0,0 +1,61 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#ifndef _B91_XFLASH_H
+#define _B91_XFLASH_H
+
+#include <los_compiler.h>
+
+#define B91_XFLASH_SECTOR_SIZE 4096
+
+struct lfs_config;
+
+/**
+ * @brief Bring up the external quad SPI NOR flash or PSRAM on HSPI: mux the pins, reset
+ *        the device and switch it to quad mode. HSPI is set up by B91SpiInit with
+ *        LOSCFG_TELINK_B91_XFLASH_CLK_DIV, other devices on the bus share that clock.
+ * @return LOS_OK, or LOS_NOK if no device answers
+ */
+UINT32 B91XflashInit(VOID);
+
+/**
+ * @brief Read with quad output, split into DMA transactions
+ * @return LOS_OK or LOS_NOK on out of range access or bus error
+ */
+UINT32 B91XflashRead(UINT32 addr, VOID *buf, UINT32 size);
+
+/**
+ * @brief Quad page program, NOR bits can only be cleared: erase the sector first
+ * @return LOS_OK or LOS_NOK on out of range access, bus error or program timeout
+ */
+UINT32 B91XflashWrite(UINT32 addr, const VOID *buf, UINT32 size);
+
+/**
+ * @brief Erase the B91_XFLASH_SECTOR_SIZE sector containing addr, nothing to do on PSRAM
+ */
+UINT32 B91XflashErase(UINT32 addr);
+
+UINT32 B91XflashSizeGet(VOID);
+
+/**
+ * @brief Get the littlefs configuration covering the whole device, for mount()
+ */
+struct lfs_config *B91XflashLfsConfigGet(VOID);
+
+#endif /* _B91_XFLASH_H */
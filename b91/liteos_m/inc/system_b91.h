@@ -23,4 +23,12 @@
 
 VOID SystemInit(VOID);
 
+/**
+ * @brief Switch to one of the clock_init presets and update sys_clk. The caller is
+ *        responsible for everything clocked from CCLK/PCLK, see b91_dvfs.h
+ * @param cclk CPU clock in Hz: 16, 24, 32, 48, 64 or 96 MHz
+ * @return LOS_OK or LOS_NOK for a frequency without preset
+ */
+UINT32 SystemClockSet(UINT32 cclk);
+
 #endif /* _SYSTEM_B91_H */
@@ -0,0 +1,215 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#include <string.h>
+
+#include <los_interrupt.h>
+
+#include <B91/adc.h>
+#include <B91/dma.h>
+
+#include <b91_adc.h>
+#include <b91_adc_conv.h>
+#include <b91_dma.h>
+
+#define ADC_CHN              B91_DMA_CHN_ADC
+#define ADC_DECIMATION_MAX   256
+#define ADC_WORD_MASK        3
+#define ADC_HALVES           2
+#define ADC_CODE_SHIFT       13
+#define ADC_MEDIAN_TAPS      3
+#define ADC_MV_MAX           0xFFFF
+
+extern unsigned short g_adc_vref;
+extern volatile unsigned char g_adc_pre_scale;
+extern volatile unsigned char g_adc_vbat_divider;
+
+/*
+ * Two descriptors linked into a loop, each covering one half of the ring, so the DMA
+ * never stops and raises a terminal count per half. The filter state carries over from
+ * one half to the next, outputs do not have to line up with the halves.
+ */
+STATIC struct {
+    dma_chain_config_t desc[ADC_HALVES] __attribute__((aligned(4)));
+    B91AdcStreamConfig config;
+    UINT32 busBuf;   /* bus address of buf, what the DMA destination register counts from */
+    UINT32 next;     /* half expected to complete next */
+    B91AdcCal cal;
+    UINT16 hist[ADC_MEDIAN_TAPS - 1];
+    UINT32 histNum;
+    UINT32 acc;
+    UINT32 accNum;
+    B91AdcStreamStats stats;
+    BOOL running;
+} g_adc;
+
+_attribute_ram_code_ STATIC UINT16 AdcMedian(UINT16 a, UINT16 b, UINT16 c)
+{
+    UINT16 lo = (a < b) ? a : b;
+    UINT16 hi = (a < b) ? b : a;
+
+    return (c < lo) ? lo : ((c > hi) ? hi : c);
+}
+
+_attribute_ram_code_ STATIC UINT32 AdcHalfProcess(UINT16 *codes)
+{
+    UINT32 num = 0;
+    UINT32 decimation = g_adc.config.decimation;
+
+    B91AdcCodesMask(codes, g_adc.config.halfSamples);
+
+    for (UINT32 i = 0; i < g_adc.config.halfSamples; ++i) {
+        UINT16 code = codes[i];
+
+        if (g_adc.config.median) {
+            UINT16 prev = g_adc.hist[0];
+            UINT16 last = g_adc.hist[1];
+            g_adc.hist[0] = last;
+            g_adc.hist[1] = code;
+            if (g_adc.histNum < (ADC_MEDIAN_TAPS - 1)) {
+                ++g_adc.histNum;
+                continue;
+            }
+            code = AdcMedian(prev, last, code);
+        }
+
+        g_adc.acc += code;
+        if (++g_adc.accNum == decimation) {
+            /* Rounded mean of the sum, scaled in one step to keep the fraction of the average */
+            UINT64 den = (UINT64)decimation << ADC_CODE_SHIFT;
+            INT32 mv = (INT32)((((UINT64)g_adc.acc * g_adc.cal.gain) + (den / 2)) / den) + g_adc.cal.offsetMv;
+            g_adc.config.out[num++] = (mv < 0) ? 0 : ((mv > ADC_MV_MAX) ? ADC_MV_MAX : (UINT16)mv);
+            g_adc.acc = 0;
+            g_adc.accNum = 0;
+        }
+    }
+
+    return num;
+}
+
+_attribute_ram_code_ STATIC VOID AdcDmaDone(VOID *arg, UINT32 events)
+{
+    (VOID)arg;
+
+    if (!g_adc.running || !(events & B91_DMA_EVENT_TC)) {
+        return;
+    }
+
+    /* The half the DMA is not writing is complete, anything else means a half was lost */
+    UINT32 halfBytes = g_adc.config.halfSamples * sizeof(UINT16);
+    UINT32 offset = reg_dma_dst_addr(ADC_CHN) - g_adc.busBuf;
+    UINT32 done = ((offset / halfBytes) % ADC_HALVES) ^ 1;
+    if (done != g_adc.next) {
+        ++g_adc.stats.overrun;
+    }
+    g_adc.next = done ^ 1;
+
+    UINT32 num = AdcHalfProcess(&g_adc.config.buf[done * g_adc.config.halfSamples]);
+    ++g_adc.stats.halves;
+
+    if ((num != 0) && (g_adc.config.notify != NULL)) {
+        g_adc.config.notify(g_adc.config.out, num, g_adc.config.arg);
+    }
+}
+
+STATIC VOID AdcDescInit(UINT32 half)
+{
+    dma_chain_config_t *desc = &g_adc.desc[half];
+    UINT32 halfBytes = g_adc.config.halfSamples * sizeof(UINT16);
+
+    desc->dma_chain_ctl = reg_dma_ctrl(ADC_CHN) | FLD_DMA_CHANNEL_ENABLE;
+    desc->dma_chain_src_addr = reg_fifo_buf_adr(1);
+    desc->dma_chain_dst_addr = g_adc.busBuf + half * halfBytes;
+    desc->dma_chain_data_len = dma_cal_size(halfBytes, DMA_WORD_WIDTH);
+    desc->dma_chain_llp_ptr = (unsigned int)convert_ram_addr_cpu2bus(&g_adc.desc[half ^ 1]);
+}
+
+UINT32 B91AdcStreamStart(const B91AdcStreamConfig *config)
+{
+    if ((config == NULL) || (config->buf == NULL) || (((UINTPTR)config->buf & ADC_WORD_MASK) != 0) ||
+        (config->out == NULL) || (config->halfSamples == 0) || ((config->halfSamples & 1) != 0) ||
+        (config->decimation == 0) || (config->decimation > ADC_DECIMATION_MAX)) {
+        return LOS_NOK;
+    }
+
+    B91AdcStreamStop();
+
+    (VOID)memset(&g_adc, 0, sizeof(g_adc));
+    if (B91AdcCalInit(&g_adc.cal, g_adc_vref, g_adc_pre_scale, g_adc_vbat_divider, config->offsetMv) != LOS_OK) {
+        return LOS_NOK;
+    }
+    g_adc.config = *config;
+    g_adc.busBuf = (UINT32)convert_ram_addr_cpu2bus(config->buf);
+
+    if (B91DmaIrqRegister(ADC_CHN, AdcDmaDone, NULL) != LOS_OK) {
+        return LOS_NOK;
+    }
+
+    adc_set_dma_config(ADC_CHN);
+
+    AdcDescInit(0);
+    AdcDescInit(1);
+
+    dma_chn_dis(ADC_CHN);
+    dma_clr_tc_irq_status(BIT(ADC_CHN));
+    dma_set_address(ADC_CHN, reg_fifo_buf_adr(1), g_adc.busBuf);
+    dma_set_size(ADC_CHN, config->halfSamples * sizeof(UINT16), DMA_WORD_WIDTH);
+    reg_dma_llp(ADC_CHN) = (unsigned int)convert_ram_addr_cpu2bus(&g_adc.desc[1]);
+
+    g_adc.running = TRUE;
+
+    dma_chn_en(ADC_CHN);
+    adc_power_on();
+    adc_fifo_enable();
+
+    return LOS_OK;
+}
+
+VOID B91AdcStreamStop(VOID)
+{
+    if (!g_adc.running) {
+        return;
+    }
+
+    adc_fifo_disable();
+    adc_power_off();
+    dma_chn_dis(ADC_CHN);
+    (VOID)B91DmaIrqRegister(ADC_CHN, NULL, NULL);
+    dma_clr_tc_irq_status(BIT(ADC_CHN));
+
+    g_adc.running = FALSE;
+}
+
+UINT32 B91AdcStreamStatsGet(B91AdcStreamStats *stats)
+{
+    if (stats == NULL) {
+        return LOS_NOK;
+    }
+
+    UINT32 intSave = LOS_IntLock();
+    *stats = g_adc.stats;
+    LOS_IntRestore(intSave);
+
+    return LOS_OK;
+}
+
+BOOL B91AdcStreamBusy(VOID)
+{
+    return g_adc.running;
+}
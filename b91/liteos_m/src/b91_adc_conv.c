@@ -0,0 +1,160 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#if defined(__riscv_dsp)
+#include <nds_intrinsic.h>
+#endif /* __riscv_dsp */
+
+#include <b91_adc_conv.h>
+
+#define ADC_CODE_SIGN  0x2000
+#define ADC_CODE_MASK  0x1FFF
+#define ADC_CODE_SHIFT 13
+#define ADC_GAIN_MAX   0xFFFF
+#define ADC_MV_MAX     0xFFFF
+
+/* adc_calculate_temperature: Temp = 564 - ((code * 819) >> 13) */
+#define ADC_TEMP_BASE  564
+#define ADC_TEMP_SLOPE 819
+
+STATIC INLINE UINT16 AdcCodeMask(UINT16 code)
+{
+    return (code & ADC_CODE_SIGN) ? 0 : (code & ADC_CODE_MASK);
+}
+
+STATIC INLINE UINT16 AdcCodeToMv(const B91AdcCal *cal, UINT16 code)
+{
+    INT32 mv = (INT32)(((UINT32)AdcCodeMask(code) * cal->gain) >> ADC_CODE_SHIFT) + cal->offsetMv;
+
+    return (mv < 0) ? 0 : ((mv > ADC_MV_MAX) ? ADC_MV_MAX : (UINT16)mv);
+}
+
+STATIC INLINE INT16 AdcCodeToTemp(UINT16 code)
+{
+    return (INT16)(ADC_TEMP_BASE - (INT32)(((UINT32)AdcCodeMask(code) * ADC_TEMP_SLOPE) >> ADC_CODE_SHIFT));
+}
+
+#if defined(__riscv_dsp)
+/*
+ * Two codes per 32 bit word, lane 0 being the first. Products of 13 bit codes and
+ * 16 bit factors need 29 bits, so umul16 widens them into a register pair.
+ */
+#define ADC_LANES      0x00010001U
+#define ADC_PAIR_SIGN  (ADC_CODE_SIGN * ADC_LANES)
+#define ADC_PAIR_MASK  (ADC_CODE_MASK * ADC_LANES)
+#define ADC_LANE_BITS  16
+#define ADC_LANE_ONES  0xFFFFU
+#define ADC_WORD_MASK  3
+
+STATIC INLINE UINT32 AdcPairMask(UINT32 pair)
+{
+    /* 0xFFFF in each negative lane, the per lane products cannot carry */
+    UINT32 neg = ((pair & ADC_PAIR_SIGN) >> ADC_CODE_SHIFT) * ADC_LANE_ONES;
+
+    return pair & ADC_PAIR_MASK & ~neg;
+}
+
+STATIC INLINE UINT32 AdcPairScale(UINT32 pair, UINT32 factors)
+{
+    unsigned long long prod = __nds__umul16(pair, factors);
+
+    return ((UINT32)(prod >> 32) >> ADC_CODE_SHIFT << ADC_LANE_BITS) | ((UINT32)prod >> ADC_CODE_SHIFT);
+}
+
+STATIC INLINE BOOL AdcPairAligned(const VOID *a, const VOID *b)
+{
+    return ((((UINTPTR)a) | ((UINTPTR)b)) & ADC_WORD_MASK) == 0;
+}
+#endif /* __riscv_dsp */
+
+UINT32 B91AdcCalInit(B91AdcCal *cal, UINT32 vrefMv, UINT32 preScale, UINT32 vbatDivider, INT16 offsetMv)
+{
+    UINT32 gain = vrefMv * preScale * vbatDivider;
+
+    if ((cal == NULL) || (gain == 0) || (gain > ADC_GAIN_MAX)) {
+        return LOS_NOK;
+    }
+
+    cal->gain = (UINT16)gain;
+    cal->offsetMv = offsetMv;
+
+    return LOS_OK;
+}
+
+VOID B91AdcCodesMask(UINT16 *codes, UINT32 num)
+{
+    UINT32 i = 0;
+
+#if defined(__riscv_dsp)
+    if (AdcPairAligned(codes, codes)) {
+        UINT32 *pairs = (UINT32 *)codes;
+        for (; (i + 1) < num; i += 2) {
+            pairs[i / 2] = AdcPairMask(pairs[i / 2]);
+        }
+    }
+#endif /* __riscv_dsp */
+
+    for (; i < num; ++i) {
+        codes[i] = AdcCodeMask(codes[i]);
+    }
+}
+
+VOID B91AdcCodesToMv(const B91AdcCal *cal, const UINT16 *codes, UINT16 *mv, UINT32 num)
+{
+    UINT32 i = 0;
+
+#if defined(__riscv_dsp)
+    if (AdcPairAligned(codes, mv)) {
+        const UINT32 *in = (const UINT32 *)codes;
+        UINT32 *out = (UINT32 *)mv;
+        UINT32 gain = cal->gain * ADC_LANES;
+        UINT32 offset = (UINT16)((cal->offsetMv < 0) ? -cal->offsetMv : cal->offsetMv) * ADC_LANES;
+
+        for (; (i + 1) < num; i += 2) {
+            UINT32 pair = AdcPairScale(AdcPairMask(in[i / 2]), gain);
+            out[i / 2] = (cal->offsetMv < 0) ? __nds__uksub16(pair, offset) : __nds__ukadd16(pair, offset);
+        }
+    }
+#endif /* __riscv_dsp */
+
+    for (; i < num; ++i) {
+        mv[i] = AdcCodeToMv(cal, codes[i]);
+    }
+}
+
+VOID B91AdcCodesToTemp(const UINT16 *codes, INT16 *celsius, UINT32 num)
+{
+    UINT32 i = 0;
+
+#if defined(__riscv_dsp)
+    if (AdcPairAligned(codes, celsius)) {
+        const UINT32 *in = (const UINT32 *)codes;
+        UINT32 *out = (UINT32 *)celsius;
+
+        for (; (i + 1) < num; i += 2) {
+            UINT32 pair = AdcPairScale(AdcPairMask(in[i / 2]), ADC_TEMP_SLOPE * ADC_LANES);
+            out[i / 2] = __nds__sub16(ADC_TEMP_BASE * ADC_LANES, pair);
+        }
+    }
+#endif /* __riscv_dsp */
+
+    for (; i < num; ++i) {
+        celsius[i] = AdcCodeToTemp(codes[i]);
+    }
+}
@@ -0,0 +1,180 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <string.h>
+
+#include <los_interrupt.h>
+
+#include <B91/audio.h>
+#include <B91/dma.h>
+
+#include <b91_audio.h>
+#include <b91_audio_ring.h>
+#include <b91_dma.h>
+
+#define AUDIO_WORD_MASK      3
+#define AUDIO_PERIODS_MIN    2
+#define AUDIO_RING_BYTES_MAX 0xFFFC /* audio_set_rx_buff_len/audio_set_tx_buff_len take 16 bits */
+
+/*
+ * One descriptor per period linked into a ring, each raising a terminal count. The
+ * periods the application holds are counted by the ring, a period completing while
+ * it holds all the others is an overrun (RX) or underrun (TX).
+ */
+typedef struct {
+    dma_chain_config_t desc[B91_AUDIO_PERIODS_MAX] __attribute__((aligned(4)));
+    B91AudioStreamConfig config;
+    UINT32 busBuf; /* bus address of buf, what the DMA address registers count from */
+    B91AudioRing ring;
+    B91AudioStreamStats stats;
+    BOOL running;
+} AudioStream;
+
+STATIC AudioStream g_audio[B91_AUDIO_DIR_NUM];
+
+STATIC const dma_chn_e g_audioChn[B91_AUDIO_DIR_NUM] = {B91_DMA_CHN_AUDIO_RX, B91_DMA_CHN_AUDIO_TX};
+
+_attribute_ram_code_ STATIC VOID AudioDmaDone(VOID *arg, UINT32 events)
+{
+    UINT32 dir = (UINT32)(UINTPTR)arg;
+    AudioStream *stream = &g_audio[dir];
+
+    if (!stream->running || !(events & B91_DMA_EVENT_TC)) {
+        return;
+    }
+
+    dma_chn_e chn = g_audioChn[dir];
+    UINT32 addr = (dir == B91_AUDIO_RX) ? reg_dma_dst_addr(chn) : reg_dma_src_addr(chn);
+    UINT32 periodBytes = stream->config.periodSamples * sizeof(UINT16);
+    UINT32 cur = ((addr - stream->busBuf) / periodBytes) % stream->config.periods;
+    UINT32 period;
+    B91AudioRingEvent event;
+
+    /* Every period before the one the DMA is in has completed, a late interrupt delivers several */
+    while ((event = B91AudioRingNext(&stream->ring, cur, &period)) != B91_AUDIO_RING_IDLE) {
+        if (event == B91_AUDIO_RING_DROP) {
+            if (dir == B91_AUDIO_RX) {
+                ++stream->stats.overrun;
+            } else {
+                ++stream->stats.underrun;
+            }
+            continue;
+        }
+
+        ++stream->stats.periods;
+        stream->config.callback(&stream->config.buf[period * stream->config.periodSamples],
+                                stream->config.periodSamples, stream->config.arg);
+    }
+}
+
+UINT32 B91AudioStreamStart(B91AudioDir dir, const B91AudioStreamConfig *config)
+{
+    if ((dir >= B91_AUDIO_DIR_NUM) || (config == NULL) || (config->buf == NULL) ||
+        (((UINTPTR)config->buf & AUDIO_WORD_MASK) != 0) || (config->periodSamples == 0) ||
+        ((config->periodSamples & 1) != 0) || (config->periods < AUDIO_PERIODS_MIN) ||
+        (config->periods > B91_AUDIO_PERIODS_MAX) || (config->callback == NULL) ||
+        (((UINT32)config->periodSamples * config->periods * sizeof(UINT16)) > AUDIO_RING_BYTES_MAX)) {
+        return LOS_NOK;
+    }
+
+    B91AudioStreamStop(dir);
+
+    AudioStream *stream = &g_audio[dir];
+    dma_chn_e chn = g_audioChn[dir];
+    UINT32 periodBytes = config->periodSamples * sizeof(UINT16);
+    UINT32 ringBytes = periodBytes * config->periods;
+
+    (VOID)memset(stream, 0, sizeof(*stream));
+    stream->config = *config;
+    stream->busBuf = (UINT32)convert_ram_addr_cpu2bus(config->buf);
+    B91AudioRingInit(&stream->ring, config->periods);
+
+    if (B91DmaIrqRegister(chn, AudioDmaDone, (VOID *)(UINTPTR)dir) != LOS_OK) {
+        return LOS_NOK;
+    }
+
+    /* The SDK sets up the channel and the audio buffer length, the first period runs from the channel registers */
+    if (dir == B91_AUDIO_RX) {
+        audio_rx_dma_config(chn, config->buf, ringBytes, &stream->desc[1]);
+    } else {
+        audio_tx_dma_config(chn, config->buf, ringBytes, &stream->desc[1]);
+    }
+
+    for (UINT32 i = 0; i < config->periods; ++i) {
+        UINT16 *period = &config->buf[i * config->periodSamples];
+        dma_chain_config_t *llp = &stream->desc[(i + 1) % config->periods];
+        if (dir == B91_AUDIO_RX) {
+            audio_rx_dma_add_list_element(&stream->desc[i], llp, period, periodBytes);
+        } else {
+            audio_tx_dma_add_list_element(&stream->desc[i], llp, period, periodBytes);
+        }
+    }
+
+    dma_chn_dis(chn);
+    dma_clr_tc_irq_status(BIT(chn));
+    dma_set_size(chn, periodBytes, DMA_WORD_WIDTH);
+
+    stream->running = TRUE;
+
+    dma_chn_en(chn);
+
+    return LOS_OK;
+}
+
+VOID B91AudioStreamStop(B91AudioDir dir)
+{
+    if ((dir >= B91_AUDIO_DIR_NUM) || !g_audio[dir].running) {
+        return;
+    }
+
+    dma_chn_e chn = g_audioChn[dir];
+    dma_chn_dis(chn);
+    (VOID)B91DmaIrqRegister(chn, NULL, NULL);
+    dma_clr_tc_irq_status(BIT(chn));
+
+    g_audio[dir].running = FALSE;
+}
+
+VOID B91AudioStreamRelease(B91AudioDir dir)
+{
+    if (dir >= B91_AUDIO_DIR_NUM) {
+        return;
+    }
+
+    UINT32 intSave = LOS_IntLock();
+    B91AudioRingRelease(&g_audio[dir].ring);
+    LOS_IntRestore(intSave);
+}
+
+UINT32 B91AudioStreamStatsGet(B91AudioDir dir, B91AudioStreamStats *stats)
+{
+    if ((dir >= B91_AUDIO_DIR_NUM) || (stats == NULL)) {
+        return LOS_NOK;
+    }
+
+    UINT32 intSave = LOS_IntLock();
+    *stats = g_audio[dir].stats;
+    LOS_IntRestore(intSave);
+
+    return LOS_OK;
+}
+
+BOOL B91AudioStreamBusy(VOID)
+{
+    return g_audio[B91_AUDIO_RX].running || g_audio[B91_AUDIO_TX].running;
+}
@@ -0,0 +1,50 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <b91_audio_ring.h>
+
+VOID B91AudioRingInit(B91AudioRing *ring, UINT32 periods)
+{
+    ring->periods = periods;
+    ring->next = 0;
+    ring->owned = 0;
+}
+
+B91AudioRingEvent B91AudioRingNext(B91AudioRing *ring, UINT32 cur, UINT32 *period)
+{
+    if (ring->next == cur) {
+        return B91_AUDIO_RING_IDLE;
+    }
+
+    *period = ring->next;
+    ring->next = (ring->next + 1) % ring->periods;
+
+    if (ring->owned == (ring->periods - 1U)) {
+        return B91_AUDIO_RING_DROP;
+    }
+
+    ++ring->owned;
+    return B91_AUDIO_RING_DELIVER;
+}
+
+VOID B91AudioRingRelease(B91AudioRing *ring)
+{
+    if (ring->owned != 0) {
+        --ring->owned;
+    }
+}
@@ -0,0 +1,91 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <unistd.h>
+
+#include <b91_binlog.h>
+
+#if defined(LOSCFG_TELINK_B91_CONSOLE_DMA)
+#include <b91_console.h>
+#endif /* LOSCFG_TELINK_B91_CONSOLE_DMA */
+
+#define BINLOG_HEADER_SIZE  3
+#define BINLOG_FIXED_SIZE   13
+#define BINLOG_RECORD_MAX   (BINLOG_HEADER_SIZE + BINLOG_FIXED_SIZE + (LOG_MULTI_PARA_MAX * 4) + 1)
+#define LEVEL_MASK          0x0F
+#define VALUE_NUMBER_OFFSET 4
+
+int _write(int handle, char *data, int size);
+
+STATIC INLINE UINT8 *PutU16(UINT8 *p, UINT16 value)
+{
+    *p++ = (UINT8)value;
+    *p++ = (UINT8)(value >> 8);  /* 8: second byte */
+    return p;
+}
+
+STATIC INLINE UINT8 *PutU32(UINT8 *p, UINT32 value)
+{
+    *p++ = (UINT8)value;
+    *p++ = (UINT8)(value >> 8);  /* 8: second byte */
+    *p++ = (UINT8)(value >> 16); /* 16: third byte */
+    *p++ = (UINT8)(value >> 24); /* 24: fourth byte */
+    return p;
+}
+
+UINT32 B91BinLogWrite(const HiLogContent *content)
+{
+    UINT8 record[BINLOG_RECORD_MAX];
+    const HiLogCommon *common = &content->commonContent;
+    UINT32 valueNumber = common->valueNumber;
+
+    if (valueNumber > LOG_MULTI_PARA_MAX) {
+        valueNumber = LOG_MULTI_PARA_MAX;
+    }
+
+    UINT8 *p = record;
+    *p++ = B91_BINLOG_SYNC0;
+    *p++ = B91_BINLOG_SYNC1;
+    p++; /* length, filled in below */
+
+    UINT8 *payload = p;
+    *p++ = common->module;
+    *p++ = (UINT8)((common->level & LEVEL_MASK) | (valueNumber << VALUE_NUMBER_OFFSET));
+    *p++ = common->task;
+    p = PutU16(p, common->milli);
+    p = PutU32(p, common->time);
+    p = PutU32(p, (UINT32)(UINTPTR)common->fmt);
+    for (UINT32 i = 0; i < valueNumber; ++i) {
+        p = PutU32(p, content->values[i]);
+    }
+
+    UINT8 sum = 0;
+    for (const UINT8 *q = payload; q < p; ++q) {
+        sum += *q;
+    }
+    *p++ = sum;
+
+    record[BINLOG_HEADER_SIZE - 1] = (UINT8)(p - payload);
+
+    UINT32 size = (UINT32)(p - record);
+#if defined(LOSCFG_TELINK_B91_CONSOLE_DMA)
+    return B91ConsoleWrite((const CHAR *)record, size);
+#else  /* LOSCFG_TELINK_B91_CONSOLE_DMA */
+    return (UINT32)_write(STDOUT_FILENO, (char *)record, (int)size);
+#endif /* LOSCFG_TELINK_B91_CONSOLE_DMA */
+}
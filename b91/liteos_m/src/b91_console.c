@@ -0,0 +1,393 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <string.h>
+
+#include <los_interrupt.h>
+#include <los_task.h>
+
+#include <b91_console.h>
+#include <b91_dma.h>
+
+#ifndef LOSCFG_TELINK_B91_CONSOLE_BUF_SIZE
+#define LOSCFG_TELINK_B91_CONSOLE_BUF_SIZE 2048
+#endif /* LOSCFG_TELINK_B91_CONSOLE_BUF_SIZE */
+
+#define CONSOLE_BUF_SIZE  LOSCFG_TELINK_B91_CONSOLE_BUF_SIZE
+#define CONSOLE_BUF_MASK  (CONSOLE_BUF_SIZE - 1)
+#define CONSOLE_DMA_CHUNK 128
+#define CONSOLE_DMA_CHN   B91_DMA_CHN_CONSOLE_TX
+#define CONSOLE_PKT_QUEUE 8
+#define CONSOLE_PKT_MASK  (CONSOLE_PKT_QUEUE - 1)
+
+#if (CONSOLE_BUF_SIZE & CONSOLE_BUF_MASK) != 0
+#error LOSCFG_TELINK_B91_CONSOLE_BUF_SIZE must be a power of two
+#endif
+
+#if defined(LOSCFG_TELINK_B91_CONSOLE_OVERFLOW_BLOCK)
+#define CONSOLE_DEFAULT_POLICY B91_CONSOLE_OVERFLOW_BLOCK
+#else /* defined(LOSCFG_TELINK_B91_CONSOLE_OVERFLOW_BLOCK) */
+#define CONSOLE_DEFAULT_POLICY B91_CONSOLE_OVERFLOW_DROP
+#endif /* defined(LOSCFG_TELINK_B91_CONSOLE_OVERFLOW_BLOCK) */
+
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+/*
+ * head and tail are free running indexes. Producers append at head with interrupts locked
+ * for the duration of the copy only, at most CONSOLE_DMA_CHUNK bytes at a time, so longer
+ * writes from different contexts may interleave at chunk boundaries. The DMA completion
+ * interrupt is the single consumer.
+ * The UART TX DMA moves whole words, so data is staged in an aligned bounce buffer
+ * instead of pointing the DMA into the ring at an arbitrary byte offset.
+ */
+STATIC struct {
+    UINT8 buf[CONSOLE_BUF_SIZE];
+    volatile UINT32 head;
+    volatile UINT32 tail;
+    volatile BOOL busy;
+    volatile BOOL held;
+    BOOL ready;
+    uart_num_e uart;
+    B91ConsoleOverflowPolicy policy;
+    UINT32 dropped;
+#if defined(LOSCFG_TELINK_B91_PBUF)
+    B91Pbuf *pkts[CONSOLE_PKT_QUEUE];
+    UINT32 pktMarks[CONSOLE_PKT_QUEUE]; /* ring head when pkts[] was queued */
+    volatile UINT32 pktHead;
+    volatile UINT32 pktTail;
+    B91Pbuf *pktSeg; /* next buffer of pkts[pktTail] to send, NULL for its first one */
+    BOOL pktSending;
+#endif /* LOSCFG_TELINK_B91_PBUF */
+} g_console = {
+    .policy = CONSOLE_DEFAULT_POLICY,
+};
+
+STATIC UINT8 g_consoleDmaBuf[CONSOLE_DMA_CHUNK] __attribute__((aligned(4)));
+
+#if defined(LOSCFG_TELINK_B91_PBUF)
+/*
+ * Packets are sent straight from their word aligned payload once the text written before
+ * them has left the ring. Text written after a packet waits behind its mark.
+ */
+_attribute_ram_code_ STATIC BOOL ConsoleKickPbuf(VOID)
+{
+    while (g_console.pktTail != g_console.pktHead) {
+        UINT32 idx = g_console.pktTail & CONSOLE_PKT_MASK;
+        if (g_console.pktMarks[idx] != g_console.tail) {
+            return FALSE;
+        }
+
+        B91Pbuf *seg = g_console.pktSeg;
+        if (seg == NULL) {
+            seg = g_console.pkts[idx];
+        }
+
+        while ((seg != NULL) && (seg->len == 0)) {
+            seg = seg->next;
+        }
+
+        if (seg == NULL) {
+            B91PbufFree(g_console.pkts[idx]);
+            ++g_console.pktTail;
+            g_console.pktSeg = NULL;
+            continue;
+        }
+
+        g_console.pktSeg = seg;
+        g_console.pktSending = TRUE;
+        g_console.busy = TRUE;
+        uart_send_dma(g_console.uart, seg->payload, seg->len);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+#endif /* LOSCFG_TELINK_B91_PBUF */
+
+_attribute_ram_code_ STATIC VOID ConsoleKick(VOID)
+{
+    if (g_console.busy || g_console.held) {
+        return;
+    }
+
+    UINT32 pending = g_console.head - g_console.tail;
+#if defined(LOSCFG_TELINK_B91_PBUF)
+    if (ConsoleKickPbuf()) {
+        return;
+    }
+
+    if (g_console.pktTail != g_console.pktHead) {
+        pending = g_console.pktMarks[g_console.pktTail & CONSOLE_PKT_MASK] - g_console.tail;
+    }
+#endif /* LOSCFG_TELINK_B91_PBUF */
+
+    if (pending == 0) {
+        return;
+    }
+
+    UINT32 len = MIN(pending, CONSOLE_DMA_CHUNK);
+    UINT32 offset = g_console.tail & CONSOLE_BUF_MASK;
+    UINT32 first = MIN(len, CONSOLE_BUF_SIZE - offset);
+
+    (VOID)memcpy(g_consoleDmaBuf, &g_console.buf[offset], first);
+    (VOID)memcpy(&g_consoleDmaBuf[first], g_console.buf, len - first);
+    g_console.tail += len;
+
+    g_console.busy = TRUE;
+    uart_send_dma(g_console.uart, g_consoleDmaBuf, len);
+}
+
+_attribute_ram_code_ STATIC VOID ConsoleTxComplete(VOID)
+{
+    g_console.busy = FALSE;
+
+#if defined(LOSCFG_TELINK_B91_PBUF)
+    if (g_console.pktSending) {
+        g_console.pktSending = FALSE;
+        g_console.pktSeg = g_console.pktSeg->next;
+        if (g_console.pktSeg == NULL) {
+            B91PbufFree(g_console.pkts[g_console.pktTail & CONSOLE_PKT_MASK]);
+            ++g_console.pktTail;
+        }
+    }
+#endif /* LOSCFG_TELINK_B91_PBUF */
+
+    ConsoleKick();
+}
+
+_attribute_ram_code_ STATIC VOID ConsoleTxDone(VOID *arg, UINT32 events)
+{
+    (VOID)arg;
+    (VOID)events;
+
+    ConsoleTxComplete();
+}
+
+STATIC BOOL ConsolePending(VOID)
+{
+#if defined(LOSCFG_TELINK_B91_PBUF)
+    if (g_console.pktHead != g_console.pktTail) {
+        return TRUE;
+    }
+#endif /* LOSCFG_TELINK_B91_PBUF */
+
+    return g_console.busy || (g_console.head != g_console.tail);
+}
+
+/*
+ * Progress the transmission without relying on the DMA interrupt being serviced,
+ * e.g. before B91IrqInit, with interrupts locked or from the panic path.
+ */
+STATIC VOID ConsolePoll(VOID)
+{
+    UINT32 intSave = LOS_IntLock();
+
+    if (g_console.busy && dma_get_tc_irq_status(BIT(CONSOLE_DMA_CHN))) {
+        dma_clr_tc_irq_status(BIT(CONSOLE_DMA_CHN));
+        ConsoleTxComplete();
+    } else {
+        ConsoleKick();
+    }
+
+    LOS_IntRestore(intSave);
+}
+
+STATIC UINT32 ConsoleEnqueue(const CHAR *data, UINT32 size)
+{
+    UINT32 intSave = LOS_IntLock();
+
+    UINT32 space = CONSOLE_BUF_SIZE - (g_console.head - g_console.tail);
+    UINT32 len = MIN(MIN(space, size), CONSOLE_DMA_CHUNK);
+    UINT32 offset = g_console.head & CONSOLE_BUF_MASK;
+    UINT32 first = MIN(len, CONSOLE_BUF_SIZE - offset);
+
+    (VOID)memcpy(&g_console.buf[offset], data, first);
+    (VOID)memcpy(g_console.buf, &data[first], len - first);
+    g_console.head += len;
+
+    ConsoleKick();
+
+    LOS_IntRestore(intSave);
+
+    return len;
+}
+
+/* A held console frees no space by polling, the holder needs the CPU to resume it */
+STATIC BOOL ConsoleWaitSpace(VOID)
+{
+    if (g_console.held) {
+        return (LOS_TaskDelay(1) == LOS_OK);
+    }
+
+    ConsolePoll();
+    return TRUE;
+}
+
+UINT32 B91ConsoleInit(uart_num_e uart)
+{
+    g_console.uart = uart;
+
+    if (B91DmaIrqRegister(CONSOLE_DMA_CHN, ConsoleTxDone, NULL) != LOS_OK) {
+        return LOS_NOK;
+    }
+
+    uart_set_tx_dma_config(uart, CONSOLE_DMA_CHN);
+    dma_clr_tc_irq_status(BIT(CONSOLE_DMA_CHN));
+
+    g_console.ready = TRUE;
+
+    return LOS_OK;
+}
+
+UINT32 B91ConsoleWrite(const CHAR *data, UINT32 size)
+{
+    UINT32 done = 0;
+
+    if (!g_console.ready) {
+        for (UINT32 i = 0; i < size; ++i) {
+            uart_send_byte(g_console.uart, (unsigned char)data[i]);
+        }
+        return size;
+    }
+
+    while (done < size) {
+        UINT32 len = ConsoleEnqueue(&data[done], size - done);
+        done += len;
+        if (len != 0) {
+            continue;
+        }
+
+        if ((g_console.policy == B91_CONSOLE_OVERFLOW_DROP) || !ConsoleWaitSpace()) {
+            UINT32 intSave = LOS_IntLock();
+            g_console.dropped += size - done;
+            LOS_IntRestore(intSave);
+            break;
+        }
+    }
+
+    return done;
+}
+
+#if defined(LOSCFG_TELINK_B91_PBUF)
+UINT32 B91ConsoleWritePbuf(B91Pbuf *p)
+{
+    if (p == NULL) {
+        return LOS_NOK;
+    }
+
+    if (!g_console.ready) {
+        for (const B91Pbuf *seg = p; seg != NULL; seg = seg->next) {
+            (VOID)B91ConsoleWrite((const CHAR *)seg->payload, seg->len);
+        }
+        return LOS_OK;
+    }
+
+    while (1) {
+        UINT32 intSave = LOS_IntLock();
+
+        if ((g_console.pktHead - g_console.pktTail) < CONSOLE_PKT_QUEUE) {
+            B91PbufRef(p);
+            g_console.pkts[g_console.pktHead & CONSOLE_PKT_MASK] = p;
+            g_console.pktMarks[g_console.pktHead & CONSOLE_PKT_MASK] = g_console.head;
+            ++g_console.pktHead;
+            ConsoleKick();
+            LOS_IntRestore(intSave);
+            return LOS_OK;
+        }
+
+        if (g_console.policy == B91_CONSOLE_OVERFLOW_DROP) {
+            g_console.dropped += p->totLen;
+            LOS_IntRestore(intSave);
+            return LOS_NOK;
+        }
+
+        LOS_IntRestore(intSave);
+        if (!ConsoleWaitSpace()) {
+            intSave = LOS_IntLock();
+            g_console.dropped += p->totLen;
+            LOS_IntRestore(intSave);
+            return LOS_NOK;
+        }
+    }
+}
+#endif /* LOSCFG_TELINK_B91_PBUF */
+
+VOID B91ConsoleSetOverflowPolicy(B91ConsoleOverflowPolicy policy)
+{
+    g_console.policy = policy;
+}
+
+UINT32 B91ConsoleDroppedGet(VOID)
+{
+    return g_console.dropped;
+}
+
+BOOL B91ConsoleBusy(VOID)
+{
+    if (!g_console.ready) {
+        return FALSE;
+    }
+
+    return ConsolePending() || uart_tx_is_busy(g_console.uart);
+}
+
+VOID B91ConsoleHold(VOID)
+{
+    if (!g_console.ready) {
+        return;
+    }
+
+    g_console.held = TRUE;
+
+    /* Completes the chunk in flight even if the DMA interrupt is not served yet */
+    while (g_console.busy) {
+        ConsolePoll();
+    }
+
+    while (uart_tx_is_busy(g_console.uart)) {
+    }
+}
+
+VOID B91ConsoleResume(VOID)
+{
+    if (!g_console.ready) {
+        return;
+    }
+
+    UINT32 intSave = LOS_IntLock();
+    g_console.held = FALSE;
+    ConsoleKick();
+    LOS_IntRestore(intSave);
+}
+
+VOID B91ConsolePanicFlush(VOID)
+{
+    (VOID)LOS_IntLock();
+
+    if (!g_console.ready) {
+        return;
+    }
+
+    g_console.held = FALSE;
+    while (ConsolePending()) {
+        ConsolePoll();
+    }
+
+    while (uart_tx_is_busy(g_console.uart)) {
+    }
+}
@@ -0,0 +1,100 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <los_interrupt.h>
+
+#include <B91/plic.h>
+
+#include <b91_dma.h>
+#include <b91_irq.h>
+
+#define DMA_CHN_NUM 8
+
+typedef struct {
+    B91DmaCallback callback;
+    VOID *arg;
+} DmaHandler;
+
+STATIC DmaHandler g_dmaHandlers[DMA_CHN_NUM];
+STATIC UINT8 g_dmaUsedMask;
+
+_attribute_ram_code_ STATIC VOID DmaIrqHandler(VOID)
+{
+    UINT32 tc = reg_dma_tc_isr & g_dmaUsedMask;
+    UINT32 err = reg_dma_err_isr & g_dmaUsedMask;
+    UINT32 abt = reg_dma_abt_isr & g_dmaUsedMask;
+
+    reg_dma_tc_isr = tc;
+    reg_dma_err_isr = err;
+    reg_dma_abt_isr = abt;
+
+    UINT32 pending = tc | err | abt;
+    while (pending != 0) {
+        UINT32 chn = __builtin_ctz(pending);
+        UINT32 mask = BIT(chn);
+        pending &= ~mask;
+
+        UINT32 events = 0;
+        events |= (tc & mask) ? B91_DMA_EVENT_TC : 0;
+        events |= (err & mask) ? B91_DMA_EVENT_ERR : 0;
+        events |= (abt & mask) ? B91_DMA_EVENT_ABT : 0;
+
+        DmaHandler *handler = &g_dmaHandlers[chn];
+        if (handler->callback != NULL) {
+            handler->callback(handler->arg, events);
+        }
+    }
+}
+
+UINT32 B91DmaIrqRegister(dma_chn_e chn, B91DmaCallback callback, VOID *arg)
+{
+    if (chn >= DMA_CHN_NUM) {
+        return LOS_NOK;
+    }
+
+    UINT32 intSave = LOS_IntLock();
+
+    /* Channels are shared between drivers that exclude each other, never take one over */
+    if ((callback != NULL) && (g_dmaHandlers[chn].callback != NULL) && (g_dmaHandlers[chn].callback != callback)) {
+        LOS_IntRestore(intSave);
+        return LOS_NOK;
+    }
+
+    g_dmaHandlers[chn].callback = callback;
+    g_dmaHandlers[chn].arg = arg;
+
+    if (callback != NULL) {
+        if (g_dmaUsedMask == 0) {
+            B91IrqRegister(IRQ5_DMA, (HWI_PROC_FUNC)DmaIrqHandler, 0);
+            plic_interrupt_enable(IRQ5_DMA);
+        }
+        g_dmaUsedMask |= BIT(chn);
+        dma_set_irq_mask(chn, TC_MASK | ERR_MASK | ABT_MASK);
+    } else {
+        g_dmaUsedMask &= ~BIT(chn);
+        dma_clr_irq_mask(chn, TC_MASK | ERR_MASK | ABT_MASK);
+        if (g_dmaUsedMask == 0) {
+            plic_interrupt_disable(IRQ5_DMA);
+            B91IrqRegister(IRQ5_DMA, NULL, 0);
+        }
+    }
+
+    LOS_IntRestore(intSave);
+
+    return LOS_OK;
+}
@@ -0,0 +1,193 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <stdio.h>
+
+#include <los_interrupt.h>
+#include <los_mux.h>
+#include <los_tick.h>
+
+#include <B91/clock.h>
+#include <B91/stimer.h>
+
+#include <b91_dvfs.h>
+#include <system_b91.h>
+
+#ifndef LOSCFG_TELINK_B91_DVFS_MIN_FREQ
+#define LOSCFG_TELINK_B91_DVFS_MIN_FREQ 16000000
+#endif /* LOSCFG_TELINK_B91_DVFS_MIN_FREQ */
+
+/* console UART, I2C, keyscan and the HDF UARTs, with room for application drivers */
+#define DVFS_NOTIFIER_MAX 8
+
+#define HZ_IN_MHZ (1000 * 1000)
+
+#define DVFS_TICK_PROBE_US 100
+
+STATIC const UINT32 g_dvfsPresets[] = {
+    16000000, 24000000, 32000000, 48000000, 64000000, 96000000,
+};
+
+#define DVFS_PRESET_NUM (sizeof(g_dvfsPresets) / sizeof(g_dvfsPresets[0]))
+
+STATIC struct {
+    UINT32 votes[B91_DVFS_CLIENT_NUM];
+    struct {
+        B91DvfsNotifier notifier;
+        VOID *arg;
+    } notifiers[DVFS_NOTIFIER_MAX];
+    UINT32 notifierNum;
+    UINT32 mutex;
+} g_dvfs;
+
+STATIC VOID DvfsNotify(B91DvfsEvent event)
+{
+    for (UINT32 i = 0; i < g_dvfs.notifierNum; ++i) {
+        g_dvfs.notifiers[i].notifier(event, g_dvfs.notifiers[i].arg);
+    }
+}
+
+/*
+ * The kernel tick timer is not expected to run from CCLK, but instead of relying on that
+ * its rate is measured against the 16 MHz stimer after every switch, and the kernel is
+ * told the new clock if it moved. Presets are whole MHz, so is the result.
+ */
+STATIC UINT32 DvfsTickClockMeasure(VOID)
+{
+    UINT32 intSave = LOS_IntLock();
+    UINT32 start = stimer_get_tick();
+    UINT64 cycles = LOS_SysCycleGet();
+    UINT32 ticks;
+
+    do {
+        ticks = stimer_get_tick() - start;
+    } while (ticks < (DVFS_TICK_PROBE_US * SYSTEM_TIMER_TICK_1US));
+    cycles = LOS_SysCycleGet() - cycles;
+
+    LOS_IntRestore(intSave);
+
+    UINT64 hz = cycles * SYSTEM_TIMER_TICK_1S / ticks;
+    return (UINT32)((hz + (HZ_IN_MHZ / 2)) / HZ_IN_MHZ) * HZ_IN_MHZ;
+}
+
+STATIC UINT32 DvfsTickClockGet(UINTPTR hz)
+{
+    return (UINT32)hz;
+}
+
+STATIC VOID DvfsTickUpdate(VOID)
+{
+    UINT32 hz = DvfsTickClockMeasure();
+
+    if ((hz != 0) && (hz != LOS_SysClockGet())) {
+        (VOID)LOS_SysTickClockFreqAdjust(DvfsTickClockGet, hz);
+    }
+}
+
+STATIC UINT32 DvfsPresetSelect(VOID)
+{
+    UINT32 target = LOSCFG_TELINK_B91_DVFS_MIN_FREQ;
+
+    for (UINT32 i = 0; i < B91_DVFS_CLIENT_NUM; ++i) {
+        if (g_dvfs.votes[i] > target) {
+            target = g_dvfs.votes[i];
+        }
+    }
+
+    for (UINT32 i = 0; i < DVFS_PRESET_NUM; ++i) {
+        if (g_dvfsPresets[i] >= target) {
+            return g_dvfsPresets[i];
+        }
+    }
+
+    return g_dvfsPresets[DVFS_PRESET_NUM - 1];
+}
+
+UINT32 B91DvfsInit(VOID)
+{
+    return LOS_MuxCreate(&g_dvfs.mutex);
+}
+
+UINT32 B91DvfsRequest(B91DvfsClient client, UINT32 minHz)
+{
+    if (client >= B91_DVFS_CLIENT_NUM) {
+        return LOS_NOK;
+    }
+
+    UINT32 ret = LOS_MuxPend(g_dvfs.mutex, LOS_WAIT_FOREVER);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    g_dvfs.votes[client] = minHz;
+
+    /* Drivers drain their transfers with interrupts enabled, only the switch is atomic */
+    UINT32 cclk = DvfsPresetSelect();
+    if (cclk != B91DvfsFreqGet()) {
+        DvfsNotify(B91_DVFS_PRE_CHANGE);
+
+        UINT32 intSave = LOS_IntLock();
+        ret = SystemClockSet(cclk);
+        LOS_IntRestore(intSave);
+
+        DvfsNotify(B91_DVFS_POST_CHANGE);
+        DvfsTickUpdate();
+    }
+
+    (VOID)LOS_MuxPost(g_dvfs.mutex);
+
+    return ret;
+}
+
+UINT32 B91DvfsNotifierRegister(B91DvfsNotifier notifier, VOID *arg)
+{
+    UINT32 ret = LOS_NOK;
+
+    if (notifier == NULL) {
+        return LOS_NOK;
+    }
+
+    UINT32 intSave = LOS_IntLock();
+
+    for (UINT32 i = 0; i < g_dvfs.notifierNum; ++i) {
+        if ((g_dvfs.notifiers[i].notifier == notifier) && (g_dvfs.notifiers[i].arg == arg)) {
+            LOS_IntRestore(intSave);
+            return LOS_OK;
+        }
+    }
+
+    if (g_dvfs.notifierNum < DVFS_NOTIFIER_MAX) {
+        g_dvfs.notifiers[g_dvfs.notifierNum].notifier = notifier;
+        g_dvfs.notifiers[g_dvfs.notifierNum].arg = arg;
+        ++g_dvfs.notifierNum;
+        ret = LOS_OK;
+    }
+
+    LOS_IntRestore(intSave);
+
+    if (ret != LOS_OK) {
+        printf("B91DvfsNotifierRegister failed: all %u slots taken\r\n", DVFS_NOTIFIER_MAX);
+    }
+
+    return ret;
+}
+
+UINT32 B91DvfsFreqGet(VOID)
+{
+    return sys_clk.cclk * HZ_IN_MHZ;
+}
@@ -0,0 +1,540 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#include <los_interrupt.h>
+#include <los_sem.h>
+#include <los_swtmr.h>
+#include <los_tick.h>
+
+#include <B91/clock.h>
+#include <B91/plic.h>
+
+#include <b91_dma.h>
+#include <b91_i2c.h>
+#include <b91_irq.h>
+
+#if defined(LOSCFG_TELINK_B91_DVFS)
+#include <b91_dvfs.h>
+#endif /* LOSCFG_TELINK_B91_DVFS */
+
+/* DMA7 belongs to the SPI engine when it is built, long messages then go through the FIFO */
+#if !defined(LOSCFG_TELINK_B91_SPI)
+#define I2C_DMA_CHN B91_DMA_CHN_I2C
+#endif /* LOSCFG_TELINK_B91_SPI */
+
+#define I2C_FIFO_SIZE  8
+#define I2C_FIFO_REGS  4
+#define I2C_FRAME_MAX  255 /* reg_i2c_len is 8 bits wide */
+#define I2C_RX_TRIG    4
+#define I2C_TX_TRIG    4
+#define I2C_WORD_MASK  3
+#define I2C_DIV_MAX    0xFF
+#define I2C_CLK_CYCLES 4 /* i2c clock = pclk / (4 * div) */
+
+#define I2C_IRQ_MASKS (FLD_I2C_RX_BUF_MASK | FLD_I2C_TX_BUF_MASK | FLD_I2C_TX_DONE_MASK | FLD_I2C_RX_DONE_MASK)
+
+#define HZ_IN_MHZ (1000 * 1000)
+
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+/*
+ * Messages are cut into frames of at most 255 bytes, only the first frame of a message
+ * carries the start and address and only the last frame of a stopping message the stop.
+ * Read frames that do not end a message ACK every byte, the last one NAKs.
+ * A write frame ends with its TX done interrupt. A read frame ends once its last byte
+ * was drained from the FIFO or landed by DMA, so the RX done status is never used.
+ */
+STATIC struct {
+    B91I2cConfig config;
+    B91I2cXfer *head;
+    B91I2cXfer *tail;
+    UINT32 offset;   /* in the current message */
+    UINT32 frameLen;
+    UINT32 fifoIdx;  /* bytes of the frame moved through the FIFO */
+    BOOL read;
+    BOOL stop;       /* the frame ends with a stop */
+    BOOL dma;
+    UINT64 startTick;
+    UINT32 timeoutTicks;
+    UINT32 timerID;
+    BOOL ready;
+} g_i2c;
+
+STATIC VOID I2cXferStart(B91I2cXfer *xfer);
+STATIC VOID I2cFrameDone(VOID);
+STATIC VOID I2cXferComplete(UINT32 status);
+
+STATIC VOID I2cClockSet(VOID)
+{
+    UINT32 clk = sys_clk.pclk * HZ_IN_MHZ;
+    UINT32 div = (clk + (I2C_CLK_CYCLES * g_i2c.config.speedHz) - 1) / (I2C_CLK_CYCLES * g_i2c.config.speedHz);
+
+    i2c_set_master_clk((unsigned char)MIN(div, I2C_DIV_MAX));
+}
+
+STATIC VOID I2cHwInit(VOID)
+{
+    i2c_master_init();
+    I2cClockSet();
+    reg_i2c_trig = (I2C_TX_TRIG << 4) | I2C_RX_TRIG;
+    reg_i2c_sct0 &= ~I2C_IRQ_MASKS;
+}
+
+_attribute_ram_code_ STATIC BOOL I2cMsgStops(const B91I2cXfer *xfer, UINT32 idx)
+{
+    return ((idx + 1) == xfer->num) || (xfer->msgs[idx].flags & B91_I2C_MSG_STOP);
+}
+
+_attribute_ram_code_ STATIC BOOL I2cMsgContinues(const B91I2cXfer *xfer, UINT32 idx)
+{
+    return ((idx + 1) < xfer->num) && (xfer->msgs[idx + 1].flags & B91_I2C_MSG_NOSTART);
+}
+
+_attribute_ram_code_ STATIC UINT8 *I2cFrameBuf(VOID)
+{
+    return g_i2c.head->msgs[g_i2c.head->done].buf + g_i2c.offset;
+}
+
+/* Between frames the previous ACK or stop is still on the wire for about a bit time */
+_attribute_ram_code_ STATIC VOID I2cBusWait(VOID)
+{
+    while (i2c_master_busy()) {
+    }
+}
+
+_attribute_ram_code_ STATIC VOID I2cTxFill(VOID)
+{
+    const UINT8 *buf = I2cFrameBuf();
+
+    while ((g_i2c.fifoIdx < g_i2c.frameLen) && (i2c_get_tx_buf_cnt() < I2C_FIFO_SIZE)) {
+        reg_i2c_data_buf(g_i2c.fifoIdx % I2C_FIFO_REGS) = buf[g_i2c.fifoIdx];
+        ++g_i2c.fifoIdx;
+    }
+
+    if (g_i2c.fifoIdx == g_i2c.frameLen) {
+        i2c_clr_irq_mask(I2C_TX_BUF_MASK);
+    }
+}
+
+_attribute_ram_code_ STATIC VOID I2cRxDrain(VOID)
+{
+    UINT8 *buf = I2cFrameBuf();
+    UINT32 avail = i2c_get_rx_buf_cnt();
+
+    while ((avail != 0) && (g_i2c.fifoIdx < g_i2c.frameLen)) {
+        buf[g_i2c.fifoIdx] = reg_i2c_data_buf(g_i2c.fifoIdx % I2C_FIFO_REGS);
+        ++g_i2c.fifoIdx;
+        --avail;
+    }
+
+    UINT32 left = g_i2c.frameLen - g_i2c.fifoIdx;
+    if (left == 0) {
+        i2c_clr_irq_mask(I2C_RX_BUF_MASK);
+        I2cFrameDone();
+    } else if (left < I2C_RX_TRIG) {
+        i2c_rx_irq_trig_cnt(left);
+    }
+}
+
+_attribute_ram_code_ STATIC VOID I2cFrameStart(VOID)
+{
+    B91I2cXfer *xfer = g_i2c.head;
+    const B91I2cMsg *msg = &xfer->msgs[xfer->done];
+    UINT32 len = MIN(msg->len - g_i2c.offset, I2C_FRAME_MAX);
+    BOOL first = (g_i2c.offset == 0) && !(msg->flags & B91_I2C_MSG_NOSTART);
+    BOOL msgEnd = ((g_i2c.offset + len) == msg->len);
+    UINT8 cmd;
+
+    g_i2c.read = ((msg->flags & B91_I2C_MSG_READ) != 0);
+    g_i2c.stop = msgEnd && I2cMsgStops(xfer, xfer->done);
+    g_i2c.frameLen = len;
+    g_i2c.fifoIdx = 0;
+#if defined(I2C_DMA_CHN)
+    UINT8 *buf = I2cFrameBuf();
+    g_i2c.dma = (len > I2C_FIFO_SIZE) && (((UINTPTR)buf & I2C_WORD_MASK) == 0);
+#else  /* I2C_DMA_CHN */
+    g_i2c.dma = FALSE;
+#endif /* I2C_DMA_CHN */
+
+    I2cBusWait();
+
+    reg_i2c_sct0 &= ~I2C_IRQ_MASKS;
+    BM_SET(reg_i2c_status, FLD_I2C_TX_CLR | FLD_I2C_RX_CLR);
+    i2c_clr_irq_status(I2C_TX_DONE_CLR);
+
+    if (g_i2c.read) {
+        cmd = FLD_I2C_LS_DATAR | FLD_I2C_LS_ID_R;
+        if (msgEnd && !I2cMsgContinues(xfer, xfer->done)) {
+            reg_i2c_sct0 |= FLD_I2C_RNCK_EN;
+        } else {
+            reg_i2c_sct0 &= ~FLD_I2C_RNCK_EN;
+        }
+    } else {
+        cmd = FLD_I2C_LS_DATAW;
+    }
+
+    if (first) {
+        reg_i2c_id = (UINT8)(msg->addr << 1) | (g_i2c.read ? FLD_I2C_WRITE_READ_BIT : 0);
+        cmd |= FLD_I2C_LS_ID | FLD_I2C_LS_START;
+    }
+
+    /*
+     * A read frame never ends without its data, so an unacknowledged address would only
+     * show up as a timeout. The address phase of a read runs on its own, about nine bit
+     * times, and its ACK is checked before the data phase is launched.
+     */
+    if (first && g_i2c.read) {
+        reg_i2c_sct1 = FLD_I2C_LS_ID | FLD_I2C_LS_START;
+        I2cBusWait();
+        if (reg_i2c_mst & FLD_I2C_ACK_IN) {
+            reg_i2c_sct1 = FLD_I2C_LS_STOP;
+            I2cBusWait();
+            I2cXferComplete(B91_I2C_ERR_NACK);
+            return;
+        }
+        cmd &= ~(FLD_I2C_LS_ID | FLD_I2C_LS_START);
+    }
+
+    if (g_i2c.stop) {
+        cmd |= FLD_I2C_LS_STOP;
+    }
+
+#if defined(I2C_DMA_CHN)
+    if (g_i2c.dma) {
+        dma_chn_dis(I2C_DMA_CHN);
+        dma_clr_tc_irq_status(BIT(I2C_DMA_CHN));
+        if (g_i2c.read) {
+            i2c_set_rx_dma_config(I2C_DMA_CHN);
+            dma_set_address(I2C_DMA_CHN, reg_i2c_data_buf0_addr, convert_ram_addr_cpu2bus(buf));
+        } else {
+            i2c_set_tx_dma_config(I2C_DMA_CHN);
+            dma_set_address(I2C_DMA_CHN, convert_ram_addr_cpu2bus(buf), reg_i2c_data_buf0_addr);
+        }
+        dma_set_size(I2C_DMA_CHN, len, DMA_WORD_WIDTH);
+        dma_chn_en(I2C_DMA_CHN);
+    }
+#endif /* I2C_DMA_CHN */
+
+    reg_i2c_len = (UINT8)len;
+
+    if (g_i2c.read) {
+        if (!g_i2c.dma) {
+            i2c_rx_irq_trig_cnt(MIN(len, I2C_RX_TRIG));
+            i2c_set_irq_mask(I2C_RX_BUF_MASK);
+        }
+    } else {
+        if (!g_i2c.dma) {
+            I2cTxFill();
+            if (g_i2c.fifoIdx < len) {
+                i2c_set_irq_mask(I2C_TX_BUF_MASK);
+            }
+        }
+        i2c_set_irq_mask(I2C_TX_DONE_MASK);
+    }
+
+    reg_i2c_sct1 = cmd;
+}
+
+_attribute_ram_code_ STATIC VOID I2cXferComplete(UINT32 status)
+{
+    B91I2cXfer *xfer = g_i2c.head;
+
+    reg_i2c_sct0 &= ~I2C_IRQ_MASKS;
+    (VOID)LOS_SwtmrStop(g_i2c.timerID);
+
+    g_i2c.head = xfer->next;
+    if (g_i2c.head != NULL) {
+        I2cXferStart(g_i2c.head);
+    } else {
+        g_i2c.tail = NULL;
+    }
+
+    xfer->next = NULL;
+    xfer->status = status;
+    if (xfer->callback != NULL) {
+        xfer->callback(xfer, xfer->arg);
+    }
+}
+
+_attribute_ram_code_ STATIC VOID I2cXferStart(B91I2cXfer *xfer)
+{
+    xfer->done = 0;
+    g_i2c.offset = 0;
+    g_i2c.startTick = LOS_TickCountGet();
+    (VOID)LOS_SwtmrStart(g_i2c.timerID);
+
+    I2cFrameStart();
+}
+
+_attribute_ram_code_ STATIC VOID I2cFrameDone(VOID)
+{
+    B91I2cXfer *xfer = g_i2c.head;
+
+    /* The address or a written byte was not acknowledged: release the bus */
+    if (reg_i2c_mst & FLD_I2C_ACK_IN) {
+        if (!g_i2c.stop) {
+            I2cBusWait();
+            reg_i2c_sct1 = FLD_I2C_LS_STOP;
+        }
+        I2cXferComplete(B91_I2C_ERR_NACK);
+        return;
+    }
+
+    g_i2c.offset += g_i2c.frameLen;
+    if (g_i2c.offset == xfer->msgs[xfer->done].len) {
+        g_i2c.offset = 0;
+        ++xfer->done;
+    }
+
+    if (xfer->done == xfer->num) {
+        I2cXferComplete(LOS_OK);
+    } else {
+        I2cFrameStart();
+    }
+}
+
+/* A slave stretching the clock forever or a DMA fault: only a reset gets the master back */
+_attribute_ram_code_ STATIC VOID I2cXferAbort(UINT32 status)
+{
+#if defined(I2C_DMA_CHN)
+    dma_chn_dis(I2C_DMA_CHN);
+#endif /* I2C_DMA_CHN */
+    reg_rst0 &= ~FLD_RST0_I2C;
+    reg_rst0 |= FLD_RST0_I2C;
+    I2cHwInit();
+
+    I2cXferComplete(status);
+}
+
+_attribute_ram_code_ STATIC VOID I2cIrqHandler(VOID)
+{
+    if (g_i2c.head == NULL) {
+        reg_i2c_sct0 &= ~I2C_IRQ_MASKS;
+        return;
+    }
+
+    if (g_i2c.read) {
+        if (!g_i2c.dma && i2c_get_irq_status(I2C_RX_BUF_STATUS)) {
+            I2cRxDrain();
+        }
+        return;
+    }
+
+    if (!g_i2c.dma && i2c_get_irq_status(I2C_TX_BUF_STATUS)) {
+        I2cTxFill();
+    }
+
+    if (i2c_get_irq_status(I2C_TXDONE_STATUS)) {
+        i2c_clr_irq_status(I2C_TX_DONE_CLR);
+        I2cFrameDone();
+    }
+}
+
+#if defined(I2C_DMA_CHN)
+_attribute_ram_code_ STATIC VOID I2cDmaIrq(VOID *arg, UINT32 events)
+{
+    (VOID)arg;
+
+    if ((g_i2c.head == NULL) || !g_i2c.dma) {
+        return;
+    }
+
+    if (events & (B91_DMA_EVENT_ERR | B91_DMA_EVENT_ABT)) {
+        I2cXferAbort(LOS_NOK);
+        return;
+    }
+
+    /* The terminal count of a write comes before TX done and is not waited for */
+    if ((events & B91_DMA_EVENT_TC) && g_i2c.read) {
+        I2cFrameDone();
+    }
+}
+#endif /* I2C_DMA_CHN */
+
+/* Software timer context: a transaction that started after the timer fired is left alone */
+STATIC VOID I2cTimeout(UINT32 arg)
+{
+    (VOID)arg;
+
+    UINT32 intSave = LOS_IntLock();
+
+    if ((g_i2c.head != NULL) && ((LOS_TickCountGet() - g_i2c.startTick) >= g_i2c.timeoutTicks)) {
+        I2cXferAbort(B91_I2C_ERR_TIMEOUT);
+    }
+
+    LOS_IntRestore(intSave);
+}
+
+#if defined(LOSCFG_TELINK_B91_DVFS)
+STATIC VOID I2cClockChanged(B91DvfsEvent event, VOID *arg)
+{
+    (VOID)arg;
+
+    if (event == B91_DVFS_POST_CHANGE) {
+        I2cClockSet();
+    }
+}
+#endif /* LOSCFG_TELINK_B91_DVFS */
+
+UINT32 B91I2cInit(const B91I2cConfig *config)
+{
+    UINT32 timerID;
+
+    if ((config == NULL) || (config->speedHz == 0) || (config->timeoutMs == 0)) {
+        return LOS_NOK;
+    }
+
+    if (B91I2cBusy()) {
+        return LOS_NOK;
+    }
+
+    /* The timer interval is fixed at creation, a new timeout needs a new timer */
+#if (LOSCFG_BASE_CORE_SWTMR_ALIGN == 1)
+    UINT32 ret = LOS_SwtmrCreate(LOS_MS2Tick(config->timeoutMs), LOS_SWTMR_MODE_ONCE, I2cTimeout, &timerID, 0,
+                                 OS_SWTMR_ROUSES_ALLOW, OS_SWTMR_ALIGN_INSENSITIVE);
+#else  /* LOSCFG_BASE_CORE_SWTMR_ALIGN */
+    UINT32 ret = LOS_SwtmrCreate(LOS_MS2Tick(config->timeoutMs), LOS_SWTMR_MODE_ONCE, I2cTimeout, &timerID, 0);
+#endif /* LOSCFG_BASE_CORE_SWTMR_ALIGN */
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    if (g_i2c.ready) {
+        (VOID)LOS_SwtmrDelete(g_i2c.timerID);
+    } else {
+#if defined(I2C_DMA_CHN)
+        if (B91DmaIrqRegister(I2C_DMA_CHN, I2cDmaIrq, NULL) != LOS_OK) {
+            (VOID)LOS_SwtmrDelete(timerID);
+            return LOS_NOK;
+        }
+#endif /* I2C_DMA_CHN */
+#if defined(LOSCFG_TELINK_B91_DVFS)
+        if (B91DvfsNotifierRegister(I2cClockChanged, NULL) != LOS_OK) {
+            (VOID)LOS_SwtmrDelete(timerID);
+            return LOS_NOK;
+        }
+#endif /* LOSCFG_TELINK_B91_DVFS */
+    }
+
+    UINT32 intSave = LOS_IntLock();
+
+    g_i2c.config = *config;
+    g_i2c.timerID = timerID;
+    g_i2c.timeoutTicks = LOS_MS2Tick(config->timeoutMs);
+
+    i2c_set_pin(config->sda, config->scl);
+    I2cHwInit();
+    B91IrqRegister(IRQ21_I2C, (HWI_PROC_FUNC)I2cIrqHandler, 0);
+    plic_interrupt_enable(IRQ21_I2C);
+    g_i2c.ready = TRUE;
+
+    LOS_IntRestore(intSave);
+
+    return LOS_OK;
+}
+
+STATIC BOOL I2cXferValid(const B91I2cXfer *xfer)
+{
+    if (!g_i2c.ready || (xfer->msgs == NULL) || (xfer->num == 0) ||
+        (xfer->msgs[0].flags & B91_I2C_MSG_NOSTART)) {
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < xfer->num; ++i) {
+        const B91I2cMsg *msg = &xfer->msgs[i];
+        if ((msg->buf == NULL) || (msg->len == 0)) {
+            return FALSE;
+        }
+
+        /* A continuation only appends bytes to the previous message */
+        if ((i != 0) && (msg->flags & B91_I2C_MSG_NOSTART)) {
+            const B91I2cMsg *prev = &xfer->msgs[i - 1];
+            if ((prev->flags & B91_I2C_MSG_STOP) || (prev->addr != msg->addr) ||
+                ((prev->flags ^ msg->flags) & B91_I2C_MSG_READ)) {
+                return FALSE;
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+UINT32 B91I2cSubmit(B91I2cXfer *xfer)
+{
+    if ((xfer == NULL) || !I2cXferValid(xfer)) {
+        return LOS_NOK;
+    }
+
+    xfer->next = NULL;
+    xfer->done = 0;
+    xfer->status = LOS_OK;
+
+    UINT32 intSave = LOS_IntLock();
+
+    if (g_i2c.tail == NULL) {
+        g_i2c.head = xfer;
+        g_i2c.tail = xfer;
+        I2cXferStart(xfer);
+    } else {
+        g_i2c.tail->next = xfer;
+        g_i2c.tail = xfer;
+    }
+
+    LOS_IntRestore(intSave);
+
+    return LOS_OK;
+}
+
+STATIC VOID I2cTransferDone(B91I2cXfer *xfer, VOID *arg)
+{
+    (VOID)xfer;
+    (VOID)LOS_SemPost((UINT32)(UINTPTR)arg);
+}
+
+UINT32 B91I2cTransfer(B91I2cXfer *xfer)
+{
+    UINT32 semID;
+
+    if (xfer == NULL) {
+        return LOS_NOK;
+    }
+
+    UINT32 ret = LOS_BinarySemCreate(0, &semID);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    xfer->callback = I2cTransferDone;
+    xfer->arg = (VOID *)(UINTPTR)semID;
+
+    ret = B91I2cSubmit(xfer);
+    if (ret == LOS_OK) {
+        (VOID)LOS_SemPend(semID, LOS_WAIT_FOREVER);
+        ret = xfer->status;
+    }
+
+    (VOID)LOS_SemDelete(semID);
+
+    return ret;
+}
+
+BOOL B91I2cBusy(VOID)
+{
+    return (g_i2c.head != NULL);
+}
@@ -0,0 +1,172 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#include <string.h>
+
+#include <los_compiler.h>
+
+#include <b91_keymatrix.h>
+
+#define COUNTER_IDLE 0xFFFF
+
+STATIC BOOL KeymatrixSettled(const B91Keymatrix *km)
+{
+    for (UINT32 col = 0; col < km->cols; ++col) {
+        if ((km->stable[col] != 0) || ((km->ct0[col] & km->ct1[col]) != COUNTER_IDLE)) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/* Columns sharing two pressed rows may show a phantom key, keep them as they were */
+STATIC VOID KeymatrixDeghost(B91Keymatrix *km, UINT16 raw[])
+{
+    UINT32 ghost = 0;
+
+    for (UINT32 a = 0; a < km->cols; ++a) {
+        for (UINT32 b = a + 1; b < km->cols; ++b) {
+            UINT16 common = raw[a] & raw[b];
+            if ((common & (common - 1)) != 0) {
+                ghost |= (1U << a) | (1U << b);
+            }
+        }
+    }
+
+    if (ghost == 0) {
+        return;
+    }
+
+    ++km->ghosts;
+    while (ghost != 0) {
+        UINT32 col = __builtin_ctz(ghost);
+        ghost &= ghost - 1;
+        raw[col] = km->stable[col];
+    }
+}
+
+STATIC VOID KeymatrixEventPut(B91Keymatrix *km, UINT32 tick, UINT32 col, UINT32 row, BOOL pressed)
+{
+    UINT32 head = km->head;
+
+    if ((head - km->tail) >= B91_KEYMATRIX_EVENTS) {
+        ++km->lost;
+        return;
+    }
+
+    B91KeyEvent *event = &km->events[head % B91_KEYMATRIX_EVENTS];
+    event->tick = tick;
+    event->col = col;
+    event->row = row;
+    event->pressed = pressed;
+    km->head = head + 1;
+}
+
+UINT32 B91KeymatrixInit(B91Keymatrix *km, const B91KeymatrixIo *io, UINT32 cols, UINT32 rows)
+{
+    if ((km == NULL) || (io == NULL) || (cols == 0) || (cols > B91_KEYMATRIX_MAX_COLS) || (rows == 0) ||
+        (rows > B91_KEYMATRIX_MAX_ROWS)) {
+        return LOS_NOK;
+    }
+
+    (VOID)memset(km, 0, sizeof(*km));
+    (VOID)memset(km->ct0, 0xFF, sizeof(km->ct0));
+    (VOID)memset(km->ct1, 0xFF, sizeof(km->ct1));
+    km->io = io;
+    km->cols = cols;
+    km->rows = rows;
+
+    return LOS_OK;
+}
+
+BOOL B91KeymatrixScan(B91Keymatrix *km, UINT32 tick)
+{
+    const B91KeymatrixIo *io = km->io;
+    UINT16 rowMask = (UINT16)((1U << km->rows) - 1);
+    UINT16 raw[B91_KEYMATRIX_MAX_COLS];
+
+    if (KeymatrixSettled(km)) {
+        io->colSelect(io->arg, B91_KEYMATRIX_COL_ALL);
+        UINT32 any = io->rowRead(io->arg) & rowMask;
+        io->colSelect(io->arg, B91_KEYMATRIX_COL_NONE);
+        if (any == 0) {
+            return FALSE;
+        }
+    }
+
+    for (UINT32 col = 0; col < km->cols; ++col) {
+        io->colSelect(io->arg, col);
+        raw[col] = io->rowRead(io->arg) & rowMask;
+    }
+    io->colSelect(io->arg, B91_KEYMATRIX_COL_NONE);
+
+    KeymatrixDeghost(km, raw);
+
+    /* Two-bit vertical counters: a bit flips after four scans in a row disagree with it */
+    for (UINT32 col = 0; col < km->cols; ++col) {
+        UINT16 changed = km->stable[col] ^ raw[col];
+        km->ct0[col] = ~(km->ct0[col] & changed);
+        km->ct1[col] = km->ct0[col] ^ (km->ct1[col] & changed);
+        changed &= km->ct0[col] & km->ct1[col];
+        km->stable[col] ^= changed;
+
+        while (changed != 0) {
+            UINT32 row = __builtin_ctz(changed);
+            changed &= changed - 1;
+            KeymatrixEventPut(km, tick, col, row, (km->stable[col] & (1U << row)) != 0);
+        }
+    }
+
+    return !KeymatrixSettled(km);
+}
+
+UINT32 B91KeymatrixEventGet(B91Keymatrix *km, B91KeyEvent *event)
+{
+    UINT32 tail = km->tail;
+
+    if (tail == km->head) {
+        return LOS_NOK;
+    }
+
+    *event = km->events[tail % B91_KEYMATRIX_EVENTS];
+    km->tail = tail + 1;
+
+    return LOS_OK;
+}
+
+VOID B91KeymatrixWakeArm(B91Keymatrix *km)
+{
+    const B91KeymatrixIo *io = km->io;
+
+    io->colSelect(io->arg, B91_KEYMATRIX_COL_ALL);
+    if (io->rowWakeSet != NULL) {
+        io->rowWakeSet(io->arg, (1U << km->rows) - 1, TRUE);
+    }
+}
+
+VOID B91KeymatrixWakeDisarm(B91Keymatrix *km)
+{
+    const B91KeymatrixIo *io = km->io;
+
+    if (io->rowWakeSet != NULL) {
+        io->rowWakeSet(io->arg, (1U << km->rows) - 1, FALSE);
+    }
+    io->colSelect(io->arg, B91_KEYMATRIX_COL_NONE);
+}
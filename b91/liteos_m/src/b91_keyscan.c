@@ -0,0 +1,330 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#include <los_interrupt.h>
+#include <los_sem.h>
+
+#include <B91/clock.h>
+#include <B91/gpio.h>
+#include <B91/pm.h>
+#include <B91/stimer.h>
+#include <B91/timer.h>
+
+#include <b91_irq.h>
+#include <b91_keyscan.h>
+
+#if defined(LOSCFG_TELINK_B91_DVFS)
+#include <b91_dvfs.h>
+#endif /* LOSCFG_TELINK_B91_DVFS */
+
+#ifndef LOSCFG_TELINK_B91_KEYSCAN_HZ
+#define LOSCFG_TELINK_B91_KEYSCAN_HZ 1000
+#endif /* LOSCFG_TELINK_B91_KEYSCAN_HZ */
+
+#define KEYSCAN_TIMER     TIMER0
+#define KEYSCAN_TIMER_IRQ IRQ4_TIMER0
+#define KEYSCAN_TIMER_STA TMR_STA_TMR0
+#define KEYSCAN_SETTLE_US 1
+#define KEYSCAN_EDGE_IRQ  IRQ27_GPIO2RISC1
+
+#define GPIO_PORT_NUM 6 /* 6: PA..PF */
+
+#define HZ_IN_MHZ (1000 * 1000)
+
+/* Lines are driven and sensed with one register access per port */
+STATIC struct {
+    const B91KeyscanConfig *config;
+    B91Keymatrix matrix;
+    B91KeymatrixIo io;
+    UINT32 semID;
+    volatile BOOL active;
+    BOOL idle; /* timer stopped, all columns driven and the rows armed for an edge */
+    UINT8 colPortMask[GPIO_PORT_NUM];
+    UINT8 rowPortMask[GPIO_PORT_NUM];
+} g_keyscan;
+
+STATIC INLINE UINT32 PinPort(gpio_pin_e pin)
+{
+    return (UINT32)pin >> 8;
+}
+
+STATIC INLINE gpio_pin_e PortGroup(UINT32 port)
+{
+    return (gpio_pin_e)(port << 8);
+}
+
+_attribute_ram_code_ STATIC VOID KeyscanColSelect(VOID *arg, UINT32 col)
+{
+    (VOID)arg;
+
+    for (UINT32 port = 0; port < GPIO_PORT_NUM; ++port) {
+        UINT8 mask = g_keyscan.colPortMask[port];
+        if (mask == 0) {
+            continue;
+        }
+
+        /* output enable is active low */
+        UINT8 oen = reg_gpio_oen(PortGroup(port)) | mask;
+        if (col == B91_KEYMATRIX_COL_ALL) {
+            oen &= ~mask;
+        } else if ((col != B91_KEYMATRIX_COL_NONE) && (PinPort(g_keyscan.config->cols[col]) == port)) {
+            oen &= ~(UINT8)g_keyscan.config->cols[col];
+        }
+        reg_gpio_oen(PortGroup(port)) = oen;
+    }
+
+    if (col != B91_KEYMATRIX_COL_NONE) {
+        delay_us(KEYSCAN_SETTLE_US);
+    }
+}
+
+_attribute_ram_code_ STATIC UINT32 KeyscanRowRead(VOID *arg)
+{
+    const B91KeyscanConfig *config = g_keyscan.config;
+    UINT8 in[GPIO_PORT_NUM];
+    UINT32 rows = 0;
+
+    (VOID)arg;
+
+    for (UINT32 port = 0; port < GPIO_PORT_NUM; ++port) {
+        if (g_keyscan.rowPortMask[port] != 0) {
+            in[port] = reg_gpio_in(PortGroup(port));
+        }
+    }
+
+    for (UINT32 row = 0; row < config->rowNum; ++row) {
+        gpio_pin_e pin = config->rows[row];
+        if ((in[PinPort(pin)] & (UINT8)pin) == 0) {
+            rows |= BIT(row);
+        }
+    }
+
+    return rows;
+}
+
+STATIC VOID KeyscanRowWakeSet(VOID *arg, UINT32 rows, BOOL enable)
+{
+    const B91KeyscanConfig *config = g_keyscan.config;
+
+    (VOID)arg;
+
+    for (UINT32 row = 0; row < config->rowNum; ++row) {
+        if ((rows & BIT(row)) != 0) {
+            pm_set_gpio_wakeup(config->rows[row], WAKEUP_LEVEL_LOW, enable ? 1 : 0);
+        }
+    }
+}
+
+STATIC VOID KeyscanTimerStart(VOID);
+
+/*
+ * Once all keys are up and settled the timer stops. The columns stay driven and the rows
+ * share gpio2risc1, whose polarity is inverted per row so any press is a rising edge of
+ * their OR. A press that came in before the edge was armed is caught by reading the rows
+ * again afterwards.
+ */
+_attribute_ram_code_ STATIC VOID KeyscanIdleEnter(VOID)
+{
+    const B91KeyscanConfig *config = g_keyscan.config;
+
+    KeyscanColSelect(NULL, B91_KEYMATRIX_COL_ALL);
+    gpio_clr_irq_status(FLD_GPIO_IRQ_GPIO2RISC1_CLR);
+    for (UINT32 row = 0; row < config->rowNum; ++row) {
+        gpio_gpio2risc1_irq_en(config->rows[row]);
+    }
+
+    if (KeyscanRowRead(NULL) != 0) {
+        for (UINT32 row = 0; row < config->rowNum; ++row) {
+            gpio_gpio2risc1_irq_dis(config->rows[row]);
+        }
+        KeyscanColSelect(NULL, B91_KEYMATRIX_COL_NONE);
+        return;
+    }
+
+    timer_stop(KEYSCAN_TIMER);
+    g_keyscan.idle = TRUE;
+    plic_interrupt_enable(KEYSCAN_EDGE_IRQ);
+}
+
+/* Interrupts locked or from an interrupt */
+_attribute_ram_code_ STATIC VOID KeyscanIdleLeave(VOID)
+{
+    const B91KeyscanConfig *config = g_keyscan.config;
+
+    if (!g_keyscan.idle) {
+        return;
+    }
+
+    plic_interrupt_disable(KEYSCAN_EDGE_IRQ);
+    for (UINT32 row = 0; row < config->rowNum; ++row) {
+        gpio_gpio2risc1_irq_dis(config->rows[row]);
+    }
+    gpio_clr_irq_status(FLD_GPIO_IRQ_GPIO2RISC1_CLR);
+    KeyscanColSelect(NULL, B91_KEYMATRIX_COL_NONE);
+
+    g_keyscan.idle = FALSE;
+    g_keyscan.active = TRUE;
+    KeyscanTimerStart();
+}
+
+_attribute_ram_code_ STATIC VOID KeyscanEdgeIrq(VOID)
+{
+    KeyscanIdleLeave();
+}
+
+_attribute_ram_code_ STATIC VOID KeyscanTimerIrq(VOID)
+{
+    timer_clr_irq_status(KEYSCAN_TIMER_STA);
+
+    UINT32 head = g_keyscan.matrix.head;
+    g_keyscan.active = B91KeymatrixScan(&g_keyscan.matrix, stimer_get_tick());
+    if (g_keyscan.matrix.head != head) {
+        (VOID)LOS_SemPost(g_keyscan.semID);
+    }
+
+    if (!g_keyscan.active) {
+        KeyscanIdleEnter();
+    }
+}
+
+STATIC VOID KeyscanTimerStart(VOID)
+{
+    timer_stop(KEYSCAN_TIMER);
+    timer_set_init_tick(KEYSCAN_TIMER, 0);
+    timer_set_cap_tick(KEYSCAN_TIMER, sys_clk.pclk * HZ_IN_MHZ / LOSCFG_TELINK_B91_KEYSCAN_HZ);
+    timer_set_mode(KEYSCAN_TIMER, TIMER_MODE_SYSCLK);
+    timer_start(KEYSCAN_TIMER);
+}
+
+#if defined(LOSCFG_TELINK_B91_DVFS)
+STATIC VOID KeyscanClockChanged(B91DvfsEvent event, VOID *arg)
+{
+    (VOID)arg;
+
+    if (event == B91_DVFS_POST_CHANGE) {
+        UINT32 intSave = LOS_IntLock();
+        if (!g_keyscan.idle) {
+            KeyscanTimerStart();
+        }
+        LOS_IntRestore(intSave);
+    }
+}
+#endif /* LOSCFG_TELINK_B91_DVFS */
+
+UINT32 B91KeyscanInit(const B91KeyscanConfig *config)
+{
+    if ((config == NULL) || (config->cols == NULL) || (config->rows == NULL)) {
+        return LOS_NOK;
+    }
+
+    g_keyscan.config = config;
+    g_keyscan.io.colSelect = KeyscanColSelect;
+    g_keyscan.io.rowRead = KeyscanRowRead;
+    g_keyscan.io.rowWakeSet = KeyscanRowWakeSet;
+    g_keyscan.io.arg = NULL;
+
+    UINT32 ret = B91KeymatrixInit(&g_keyscan.matrix, &g_keyscan.io, config->colNum, config->rowNum);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    ret = LOS_BinarySemCreate(0, &g_keyscan.semID);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    for (UINT32 col = 0; col < config->colNum; ++col) {
+        gpio_pin_e pin = config->cols[col];
+        gpio_function_en(pin);
+        gpio_input_dis(pin);
+        gpio_output_dis(pin);
+        gpio_set_low_level(pin);
+        g_keyscan.colPortMask[PinPort(pin)] |= (UINT8)pin;
+    }
+
+    for (UINT32 row = 0; row < config->rowNum; ++row) {
+        gpio_pin_e pin = config->rows[row];
+        gpio_function_en(pin);
+        gpio_output_dis(pin);
+        gpio_input_en(pin);
+        gpio_set_up_down_res(pin, GPIO_PIN_PULLUP_10K);
+        g_keyscan.rowPortMask[PinPort(pin)] |= (UINT8)pin;
+    }
+
+#if defined(LOSCFG_TELINK_B91_DVFS)
+    if (B91DvfsNotifierRegister(KeyscanClockChanged, NULL) != LOS_OK) {
+        return LOS_NOK;
+    }
+#endif /* LOSCFG_TELINK_B91_DVFS */
+
+    for (UINT32 row = 0; row < config->rowNum; ++row) {
+        gpio_set_gpio2risc1_irq(config->rows[row], INTR_FALLING_EDGE);
+        gpio_gpio2risc1_irq_dis(config->rows[row]);
+    }
+    B91IrqRegister(KEYSCAN_EDGE_IRQ, (HWI_PROC_FUNC)KeyscanEdgeIrq, 0);
+
+    B91IrqRegister(KEYSCAN_TIMER_IRQ, (HWI_PROC_FUNC)KeyscanTimerIrq, 0);
+    plic_interrupt_enable(KEYSCAN_TIMER_IRQ);
+    KeyscanTimerStart();
+
+    return LOS_OK;
+}
+
+UINT32 B91KeyscanEventGet(B91KeyEvent *event, UINT32 timeout)
+{
+    if (event == NULL) {
+        return LOS_NOK;
+    }
+
+    while (B91KeymatrixEventGet(&g_keyscan.matrix, event) != LOS_OK) {
+        if (LOS_SemPend(g_keyscan.semID, timeout) != LOS_OK) {
+            return LOS_NOK;
+        }
+    }
+
+    return LOS_OK;
+}
+
+BOOL B91KeyscanBusy(VOID)
+{
+    return g_keyscan.active;
+}
+
+VOID B91KeyscanWakeArm(VOID)
+{
+    if (g_keyscan.config == NULL) {
+        return;
+    }
+
+    B91KeymatrixWakeArm(&g_keyscan.matrix);
+}
+
+VOID B91KeyscanWakeDisarm(VOID)
+{
+    if (g_keyscan.config == NULL) {
+        return;
+    }
+
+    B91KeymatrixWakeDisarm(&g_keyscan.matrix);
+
+    /* Disarming released the columns, scanning resumes until the matrix settles again */
+    UINT32 intSave = LOS_IntLock();
+    KeyscanIdleLeave();
+    LOS_IntRestore(intSave);
+}
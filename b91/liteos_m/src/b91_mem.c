@@ -0,0 +1,292 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include <los_interrupt.h>
+#include <los_membox.h>
+#include <los_memory.h>
+
+#include <b91_mem.h>
+
+#if (LOSCFG_MEM_MUL_REGIONS != 1)
+#error LOSCFG_TELINK_B91_DLM_HEAP needs LOSCFG_MEM_MUL_REGIONS set to 1 in target_config.h
+#endif
+
+#ifndef LOSCFG_TELINK_B91_DLM_DMA_POOL_SIZE
+#define LOSCFG_TELINK_B91_DLM_DMA_POOL_SIZE 8192
+#endif /* LOSCFG_TELINK_B91_DLM_DMA_POOL_SIZE */
+
+#ifndef LOSCFG_TELINK_B91_SBRK_ARENA_SIZE
+#define LOSCFG_TELINK_B91_SBRK_ARENA_SIZE 1024
+#endif /* LOSCFG_TELINK_B91_SBRK_ARENA_SIZE */
+
+#define DMA_ALIGN 4
+#define PERCENT   100
+
+/*
+ * Small objects come from fixed block pools: O(1) and they never split the TLSF pools.
+ * The block pools are static, so they live in DLM .bss.
+ */
+#define SIZE_CLASS_POOL(blkSize, blkNum)                                                                              \
+    STATIC UINT32 g_sizeClass##blkSize[(LOS_MEMBOX_SIZE(blkSize, blkNum) + sizeof(UINT32) - 1) / sizeof(UINT32)]
+
+#define SIZE_CLASS(blkSize, blkNum)                                                                                   \
+    {                                                                                                                 \
+        blkSize, blkNum, g_sizeClass##blkSize, sizeof(g_sizeClass##blkSize), 0, 0                                     \
+    }
+
+SIZE_CLASS_POOL(16, 64);
+SIZE_CLASS_POOL(32, 32);
+SIZE_CLASS_POOL(64, 16);
+SIZE_CLASS_POOL(128, 8);
+
+typedef struct {
+    UINT32 blkSize;
+    UINT32 blkNum;
+    UINT32 *pool;
+    UINT32 poolSize;
+    UINT32 used;
+    UINT32 peak;
+} SizeClass;
+
+STATIC SizeClass g_sizeClasses[] = {
+    SIZE_CLASS(16, 64),
+    SIZE_CLASS(32, 32),
+    SIZE_CLASS(64, 16),
+    SIZE_CLASS(128, 8),
+};
+
+#define SIZE_CLASS_NUM (sizeof(g_sizeClasses) / sizeof(g_sizeClasses[0]))
+
+/*
+ * The free DLM tail [_end, _heap_end] is split into
+ *   [DMA pool][region added to the system pool][sbrk arena]
+ * so LOS_MemAlloc and malloc, which the kernel's newlib port wraps onto the system pool,
+ * use ILM and DLM alike, while DMA buffers are kept in DLM.
+ */
+extern UINT8 _end[];
+extern UINT8 _heap_end[];
+
+STATIC VOID *g_pools[B91_MEM_REGION_NUM];
+
+STATIC UINT8 *g_sbrkStart;
+STATIC UINT8 *g_sbrkEnd;
+STATIC UINT8 *g_sbrkCur;
+
+STATIC const CHAR *const g_regionNames[B91_MEM_REGION_NUM] = {
+    [B91_MEM_ILM] = "ILM",
+    [B91_MEM_DLM] = "DLM",
+};
+
+STATIC INLINE BOOL AddrInRange(const VOID *ptr, UINTPTR start, UINTPTR end)
+{
+    return ((UINTPTR)ptr >= start) && ((UINTPTR)ptr < end);
+}
+
+VOID B91MemInit(VOID)
+{
+    UINT8 *dlmEnd = (UINT8 *)(((UINTPTR)_heap_end + 1) & ~(UINTPTR)(DMA_ALIGN - 1));
+    UINT8 *dmaEnd = _end + LOSCFG_TELINK_B91_DLM_DMA_POOL_SIZE;
+
+    g_pools[B91_MEM_ILM] = m_aucSysMem0;
+
+    g_sbrkStart = dlmEnd - LOSCFG_TELINK_B91_SBRK_ARENA_SIZE;
+    g_sbrkEnd = dlmEnd;
+    g_sbrkCur = g_sbrkStart;
+
+    if ((dmaEnd > g_sbrkStart) || (LOS_MemInit(_end, LOSCFG_TELINK_B91_DLM_DMA_POOL_SIZE) != LOS_OK)) {
+        printf("DLM DMA pool init failed (%u bytes)\r\n", LOSCFG_TELINK_B91_DLM_DMA_POOL_SIZE);
+        dmaEnd = _end;
+    } else {
+        g_pools[B91_MEM_DLM] = _end;
+    }
+
+    LosMemRegion region = {
+        .startAddress = dmaEnd,
+        .length = (UINT32)(g_sbrkStart - dmaEnd),
+    };
+    if (LOS_MemRegionsAdd(m_aucSysMem0, &region, 1) != LOS_OK) {
+        printf("Adding DLM to the system pool failed (%u bytes)\r\n", region.length);
+    }
+
+    for (UINT32 i = 0; i < SIZE_CLASS_NUM; ++i) {
+        SizeClass *sc = &g_sizeClasses[i];
+        (VOID)LOS_MemboxInit(sc->pool, sc->poolSize, sc->blkSize);
+    }
+}
+
+STATIC VOID *SizeClassAlloc(UINT32 size)
+{
+    for (UINT32 i = 0; i < SIZE_CLASS_NUM; ++i) {
+        SizeClass *sc = &g_sizeClasses[i];
+        if (size > sc->blkSize) {
+            continue;
+        }
+
+        VOID *ptr = LOS_MemboxAlloc(sc->pool);
+        if (ptr != NULL) {
+            UINT32 intSave = LOS_IntLock();
+            if (++sc->used > sc->peak) {
+                sc->peak = sc->used;
+            }
+            LOS_IntRestore(intSave);
+            return ptr;
+        }
+    }
+
+    return NULL;
+}
+
+STATIC VOID *PoolAlloc(B91MemRegion region, UINT32 size, UINT32 align)
+{
+    VOID *pool = g_pools[region];
+
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    return (align != 0) ? LOS_MemAllocAlign(pool, size, align) : LOS_MemAlloc(pool, size);
+}
+
+VOID *B91MemAlloc(B91MemRegion region, UINT32 size)
+{
+    VOID *ptr = NULL;
+
+    if ((region >= B91_MEM_REGION_NUM) || (size == 0)) {
+        return NULL;
+    }
+
+    if (region == B91_MEM_DLM) {
+        ptr = SizeClassAlloc(size);
+    }
+
+    if (ptr == NULL) {
+        ptr = PoolAlloc(region, size, 0);
+    }
+
+    if ((ptr == NULL) && (region == B91_MEM_DLM)) {
+        ptr = PoolAlloc(B91_MEM_ILM, size, 0);
+    }
+
+    return ptr;
+}
+
+VOID *B91MemAllocDma(UINT32 size)
+{
+    VOID *ptr = PoolAlloc(B91_MEM_DLM, size, DMA_ALIGN);
+
+    if (ptr == NULL) {
+        ptr = PoolAlloc(B91_MEM_ILM, size, DMA_ALIGN);
+    }
+
+    return ptr;
+}
+
+VOID B91MemFree(VOID *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+
+    for (UINT32 i = 0; i < SIZE_CLASS_NUM; ++i) {
+        SizeClass *sc = &g_sizeClasses[i];
+        if (AddrInRange(ptr, (UINTPTR)sc->pool, (UINTPTR)sc->pool + sc->poolSize)) {
+            if (LOS_MemboxFree(sc->pool, ptr) == LOS_OK) {
+                UINT32 intSave = LOS_IntLock();
+                --sc->used;
+                LOS_IntRestore(intSave);
+            }
+            return;
+        }
+    }
+
+    if ((g_pools[B91_MEM_DLM] != NULL) &&
+        AddrInRange(ptr, (UINTPTR)_end, (UINTPTR)_end + LOSCFG_TELINK_B91_DLM_DMA_POOL_SIZE)) {
+        (VOID)LOS_MemFree(g_pools[B91_MEM_DLM], ptr);
+    } else {
+        (VOID)LOS_MemFree(m_aucSysMem0, ptr);
+    }
+}
+
+UINT32 B91MemStatsGet(B91MemRegion region, B91MemStats *stats)
+{
+    LOS_MEM_POOL_STATUS status;
+
+    if ((region >= B91_MEM_REGION_NUM) || (stats == NULL) || (g_pools[region] == NULL)) {
+        return LOS_NOK;
+    }
+
+    UINT32 ret = LOS_MemInfoGet(g_pools[region], &status);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    stats->totalSize = LOS_MemPoolSizeGet(g_pools[region]);
+    stats->usedSize = status.totalUsedSize;
+    stats->freeSize = status.totalFreeSize;
+    stats->maxFreeBlock = status.maxFreeNodeSize;
+    stats->fragmentation =
+        (status.totalFreeSize != 0) ? (PERCENT - (status.maxFreeNodeSize * PERCENT / status.totalFreeSize)) : 0;
+
+    return LOS_OK;
+}
+
+VOID B91MemDump(VOID)
+{
+    B91MemStats stats;
+
+    printf("Heap        total     used     free  max free  frag\r\n");
+    for (UINT32 region = 0; region < B91_MEM_REGION_NUM; ++region) {
+        if (B91MemStatsGet(region, &stats) != LOS_OK) {
+            continue;
+        }
+        printf("  %-6s %8u %8u %8u  %8u  %3u%%\r\n", g_regionNames[region], stats.totalSize, stats.usedSize,
+               stats.freeSize, stats.maxFreeBlock, stats.fragmentation);
+    }
+
+    printf("Size class  used  peak  blocks\r\n");
+    for (UINT32 i = 0; i < SIZE_CLASS_NUM; ++i) {
+        const SizeClass *sc = &g_sizeClasses[i];
+        printf("  %6u  %6u %5u  %6u\r\n", sc->blkSize, sc->used, sc->peak, sc->blkNum);
+    }
+}
+
+/*
+ * Overrides the weak _sbrk in main.c, whose arena is the whole DLM tail. malloc, calloc,
+ * realloc and free are wrapped onto the system pool by the kernel's newlib port and never
+ * get here; only newlib code calling sbrk itself does, and it gets the small top arena.
+ */
+void *_sbrk(ptrdiff_t incr)
+{
+    UINT32 intSave = LOS_IntLock();
+    UINT8 *cur = g_sbrkCur;
+
+    if ((cur == NULL) || ((cur + incr) < g_sbrkStart) || ((cur + incr) > g_sbrkEnd)) {
+        LOS_IntRestore(intSave);
+        errno = ENOMEM;
+        return (void *)(-1);
+    }
+
+    g_sbrkCur = cur + incr;
+    LOS_IntRestore(intSave);
+
+    return cur;
+}
@@ -0,0 +1,291 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <hal_file.h>
+
+#include <los_interrupt.h>
+#include <los_membox.h>
+#include <los_memory.h>
+
+#include <stack/ble/ble.h>
+
+#include <b91_pbuf.h>
+
+#ifndef LOSCFG_TELINK_B91_PBUF_SIZE
+#define LOSCFG_TELINK_B91_PBUF_SIZE 256
+#endif /* LOSCFG_TELINK_B91_PBUF_SIZE */
+
+#ifndef LOSCFG_TELINK_B91_PBUF_ILM_NUM
+#define LOSCFG_TELINK_B91_PBUF_ILM_NUM 8
+#endif /* LOSCFG_TELINK_B91_PBUF_ILM_NUM */
+
+#ifndef LOSCFG_TELINK_B91_PBUF_DLM_NUM
+#define LOSCFG_TELINK_B91_PBUF_DLM_NUM 16
+#endif /* LOSCFG_TELINK_B91_PBUF_DLM_NUM */
+
+#define PBUF_PAYLOAD_SIZE ((LOSCFG_TELINK_B91_PBUF_SIZE + 3) & ~3)
+#define PBUF_BLOCK_SIZE   (sizeof(B91Pbuf) + PBUF_PAYLOAD_SIZE)
+#define PBUF_POOL_SIZE(n) LOS_MEMBOX_SIZE(PBUF_BLOCK_SIZE, n)
+
+/* Longest notification the stack takes: ATT_MTU 250 minus opcode and handle */
+#define PBUF_GATT_MAX 247
+
+#define HAL_ERROR -1
+
+/* The DLM pool is static and ends up in DLM .bss, the other one comes from the system pool */
+STATIC UINT32 g_pbufDlmPool[(PBUF_POOL_SIZE(LOSCFG_TELINK_B91_PBUF_DLM_NUM) + 3) / 4];
+
+STATIC VOID *g_pbufPools[B91_MEM_REGION_NUM];
+
+VOID B91PbufInit(VOID)
+{
+    UINT32 ilmSize = PBUF_POOL_SIZE(LOSCFG_TELINK_B91_PBUF_ILM_NUM);
+    VOID *ilmPool = LOS_MemAlloc(m_aucSysMem0, ilmSize);
+
+    if ((ilmPool != NULL) && (LOS_MemboxInit(ilmPool, ilmSize, PBUF_BLOCK_SIZE) == LOS_OK)) {
+        g_pbufPools[B91_MEM_ILM] = ilmPool;
+    } else {
+        printf("ILM pbuf pool init failed (%u bytes)\r\n", ilmSize);
+    }
+
+    if (LOS_MemboxInit(g_pbufDlmPool, sizeof(g_pbufDlmPool), PBUF_BLOCK_SIZE) == LOS_OK) {
+        g_pbufPools[B91_MEM_DLM] = g_pbufDlmPool;
+    }
+}
+
+STATIC B91Pbuf *PbufBlockAlloc(B91MemRegion region)
+{
+    B91Pbuf *p = NULL;
+
+    if (g_pbufPools[region] != NULL) {
+        p = LOS_MemboxAlloc(g_pbufPools[region]);
+    }
+
+    if (p == NULL) {
+        region = (region == B91_MEM_ILM) ? B91_MEM_DLM : B91_MEM_ILM;
+        if (g_pbufPools[region] != NULL) {
+            p = LOS_MemboxAlloc(g_pbufPools[region]);
+        }
+    }
+
+    if (p != NULL) {
+        p->next = NULL;
+        p->payload = (UINT8 *)(p + 1);
+        p->ref = 1;
+        p->region = region;
+    }
+
+    return p;
+}
+
+B91Pbuf *B91PbufAlloc(B91MemRegion region, UINT32 size)
+{
+    B91Pbuf *head = NULL;
+    B91Pbuf **link = &head;
+    UINT32 left = size;
+
+    if ((region >= B91_MEM_REGION_NUM) || (size == 0) || (size > UINT16_MAX)) {
+        return NULL;
+    }
+
+    while (left != 0) {
+        B91Pbuf *p = PbufBlockAlloc(region);
+        if (p == NULL) {
+            B91PbufFree(head);
+            return NULL;
+        }
+
+        p->len = (left > PBUF_PAYLOAD_SIZE) ? PBUF_PAYLOAD_SIZE : left;
+        p->totLen = left;
+        left -= p->len;
+
+        *link = p;
+        link = &p->next;
+    }
+
+    return head;
+}
+
+VOID B91PbufRef(B91Pbuf *p)
+{
+    if (p == NULL) {
+        return;
+    }
+
+    UINT32 intSave = LOS_IntLock();
+    ++p->ref;
+    LOS_IntRestore(intSave);
+}
+
+VOID B91PbufFree(B91Pbuf *p)
+{
+    while (p != NULL) {
+        UINT32 intSave = LOS_IntLock();
+        UINT8 ref = --p->ref;
+        LOS_IntRestore(intSave);
+
+        if (ref != 0) {
+            break;
+        }
+
+        B91Pbuf *next = p->next;
+        (VOID)LOS_MemboxFree(g_pbufPools[p->region], p);
+        p = next;
+    }
+}
+
+UINT32 B91PbufCat(B91Pbuf *head, B91Pbuf *tail)
+{
+    if ((head == NULL) || (tail == NULL) || (((UINT32)head->totLen + tail->totLen) > UINT16_MAX)) {
+        return LOS_NOK;
+    }
+
+    B91Pbuf *p = head;
+    for (; p->next != NULL; p = p->next) {
+        p->totLen += tail->totLen;
+    }
+    p->totLen += tail->totLen;
+    p->next = tail;
+
+    return LOS_OK;
+}
+
+UINT32 B91PbufChain(B91Pbuf *head, B91Pbuf *tail)
+{
+    UINT32 ret = B91PbufCat(head, tail);
+
+    if (ret == LOS_OK) {
+        B91PbufRef(tail);
+    }
+
+    return ret;
+}
+
+VOID B91PbufTrim(B91Pbuf *p, UINT32 len)
+{
+    if ((p == NULL) || (len >= p->totLen)) {
+        return;
+    }
+
+    UINT32 left = len;
+    while ((p->next != NULL) && (left > p->len)) {
+        p->totLen = left;
+        left -= p->len;
+        p = p->next;
+    }
+
+    p->len = left;
+    p->totLen = left;
+    B91PbufFree(p->next);
+    p->next = NULL;
+}
+
+UINT32 B91PbufCopyOut(const B91Pbuf *p, VOID *dst, UINT32 len, UINT32 offset)
+{
+    UINT8 *out = dst;
+    UINT32 done = 0;
+
+    for (; (p != NULL) && (done < len); p = p->next) {
+        if (offset >= p->len) {
+            offset -= p->len;
+            continue;
+        }
+
+        UINT32 n = p->len - offset;
+        if (n > (len - done)) {
+            n = len - done;
+        }
+
+        (VOID)memcpy(&out[done], &p->payload[offset], n);
+        done += n;
+        offset = 0;
+    }
+
+    return done;
+}
+
+UINT32 B91PbufCopyIn(B91Pbuf *p, const VOID *src, UINT32 len, UINT32 offset)
+{
+    const UINT8 *in = src;
+    UINT32 done = 0;
+
+    for (; (p != NULL) && (done < len); p = p->next) {
+        if (offset >= p->len) {
+            offset -= p->len;
+            continue;
+        }
+
+        UINT32 n = p->len - offset;
+        if (n > (len - done)) {
+            n = len - done;
+        }
+
+        (VOID)memcpy(&p->payload[offset], &in[done], n);
+        done += n;
+        offset = 0;
+    }
+
+    return done;
+}
+
+UINT32 B91PbufGattNotify(UINT16 connHandle, UINT16 attHandle, const B91Pbuf *p)
+{
+    UINT8 flat[PBUF_GATT_MAX];
+
+    if (p == NULL) {
+        return GATT_ERR_INVALID_PARAMETER;
+    }
+
+    if (p->next == NULL) {
+        return blc_gatt_pushHandleValueNotify(connHandle, attHandle, p->payload, p->len);
+    }
+
+    if (p->totLen > sizeof(flat)) {
+        return GATT_ERR_DATA_LENGTH_EXCEED_MTU_SIZE;
+    }
+
+    UINT32 len = B91PbufCopyOut(p, flat, p->totLen, 0);
+    return blc_gatt_pushHandleValueNotify(connHandle, attHandle, flat, len);
+}
+
+INT32 B91PbufFileWrite(INT32 fd, const B91Pbuf *p)
+{
+    INT32 done = 0;
+
+    for (; p != NULL; p = p->next) {
+        if (p->len == 0) {
+            continue;
+        }
+
+        INT32 ret = HalFileWrite(fd, (const char *)p->payload, p->len);
+        if (ret < 0) {
+            return HAL_ERROR;
+        }
+
+        done += ret;
+        if (ret != p->len) {
+            break;
+        }
+    }
+
+    return done;
+}
@@ -0,0 +1,275 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <stdint.h>
+
+#include <los_interrupt.h>
+#include <los_pm.h>
+
+#include <B91/core.h>
+#include <B91/stimer.h>
+
+#include <B91/ext_driver/ext_pm.h>
+
+#include <stack/ble/ble.h>
+
+#include <b91_pm.h>
+#include <b91_sleep_policy.h>
+
+#if defined(LOSCFG_TELINK_B91_CONSOLE_DMA)
+#include <b91_console.h>
+#endif /* LOSCFG_TELINK_B91_CONSOLE_DMA */
+
+#if defined(LOSCFG_TELINK_B91_KEYSCAN)
+#include <b91_keyscan.h>
+#endif /* LOSCFG_TELINK_B91_KEYSCAN */
+
+#if defined(LOSCFG_TELINK_B91_SPI)
+#include <b91_spi.h>
+#endif /* LOSCFG_TELINK_B91_SPI */
+
+#if defined(LOSCFG_TELINK_B91_I2C) || defined(LOSCFG_DRIVERS_HDF_PLATFORM_I2C)
+#include <b91_i2c.h>
+#endif /* LOSCFG_TELINK_B91_I2C || LOSCFG_DRIVERS_HDF_PLATFORM_I2C */
+
+#if defined(LOSCFG_TELINK_B91_ADC_STREAM)
+#include <b91_adc.h>
+#endif /* LOSCFG_TELINK_B91_ADC_STREAM */
+
+#if defined(LOSCFG_TELINK_B91_AUDIO_STREAM)
+#include <b91_audio.h>
+#endif /* LOSCFG_TELINK_B91_AUDIO_STREAM */
+
+#if defined(LOSCFG_TELINK_B91_UART_RX) || defined(LOSCFG_DRIVERS_HDF_PLATFORM_UART)
+#include <b91_uart_rx.h>
+#endif /* LOSCFG_TELINK_B91_UART_RX || LOSCFG_DRIVERS_HDF_PLATFORM_UART */
+
+#if defined(LOSCFG_DRIVERS_HDF_PLATFORM_UART)
+#include <b91_uart.h>
+#endif /* LOSCFG_DRIVERS_HDF_PLATFORM_UART */
+
+#ifndef LOSCFG_TELINK_B91_TICKLESS_MIN_SUSPEND_US
+#define LOSCFG_TELINK_B91_TICKLESS_MIN_SUSPEND_US 3000
+#endif /* LOSCFG_TELINK_B91_TICKLESS_MIN_SUSPEND_US */
+
+#define MIE_MTIE BIT(7) /* 7: machine timer interrupt enable */
+
+#define PM_WAKEUP_MARGIN_US 1000
+#define PM_MAX_SLEEP_S      120 /* wakeup ticks are compared as signed 32 bit stimer differences */
+
+STATIC const B91SleepPolicy g_sleepPolicy = {
+    .minSuspendTicks = LOSCFG_TELINK_B91_TICKLESS_MIN_SUSPEND_US * SYSTEM_TIMER_TICK_1US,
+    .wakeupMarginTicks = PM_WAKEUP_MARGIN_US * SYSTEM_TIMER_TICK_1US,
+    .maxSleepTicks = PM_MAX_SLEEP_S * SYSTEM_TIMER_TICK_1S,
+};
+
+STATIC struct {
+    UINT32 sleepStart;
+    UINT32 idleTicks;
+    volatile UINT32 wakeLocks;
+} g_pm;
+
+/*
+ * The kernel stops the tick, hands over the time to the next timer expiry in stimer
+ * ticks, calls lightSuspend and then corrects its time base with the stimer ticks
+ * that actually elapsed. cpu_sleep_wakeup restores the stimer from the 32 kHz timer
+ * on wakeup, so it measures the time spent in suspend too.
+ */
+STATIC VOID PmTimerStart(UINT64 cycles)
+{
+    g_pm.sleepStart = stimer_get_tick();
+    g_pm.idleTicks = (cycles > UINT32_MAX) ? UINT32_MAX : (UINT32)cycles;
+}
+
+STATIC UINT64 PmTimerCycleGet(VOID)
+{
+    return (UINT32)(stimer_get_tick() - g_pm.sleepStart);
+}
+
+STATIC UINT64 PmTimerStop(VOID)
+{
+    return PmTimerCycleGet();
+}
+
+STATIC VOID PmTickLock(VOID)
+{
+    clear_csr(NDS_MIE, MIE_MTIE);
+}
+
+STATIC VOID PmTickUnlock(VOID)
+{
+    set_csr(NDS_MIE, MIE_MTIE);
+}
+
+STATIC BOOL PmBusy(VOID)
+{
+#if defined(LOSCFG_TELINK_B91_KEYSCAN)
+    if (B91KeyscanBusy()) {
+        return TRUE;
+    }
+#endif /* LOSCFG_TELINK_B91_KEYSCAN */
+
+#if defined(LOSCFG_TELINK_B91_SPI)
+    if (B91SpiBusy()) {
+        return TRUE;
+    }
+#endif /* LOSCFG_TELINK_B91_SPI */
+
+#if defined(LOSCFG_TELINK_B91_I2C) || defined(LOSCFG_DRIVERS_HDF_PLATFORM_I2C)
+    if (B91I2cBusy()) {
+        return TRUE;
+    }
+#endif /* LOSCFG_TELINK_B91_I2C || LOSCFG_DRIVERS_HDF_PLATFORM_I2C */
+
+#if defined(LOSCFG_TELINK_B91_ADC_STREAM)
+    if (B91AdcStreamBusy()) {
+        return TRUE;
+    }
+#endif /* LOSCFG_TELINK_B91_ADC_STREAM */
+
+#if defined(LOSCFG_TELINK_B91_AUDIO_STREAM)
+    if (B91AudioStreamBusy()) {
+        return TRUE;
+    }
+#endif /* LOSCFG_TELINK_B91_AUDIO_STREAM */
+
+#if defined(LOSCFG_TELINK_B91_UART_RX) || defined(LOSCFG_DRIVERS_HDF_PLATFORM_UART)
+    if (B91UartRxBusy()) {
+        return TRUE;
+    }
+#endif /* LOSCFG_TELINK_B91_UART_RX || LOSCFG_DRIVERS_HDF_PLATFORM_UART */
+
+#if defined(LOSCFG_DRIVERS_HDF_PLATFORM_UART)
+    if (B91UartTxBusy()) {
+        return TRUE;
+    }
+#endif /* LOSCFG_DRIVERS_HDF_PLATFORM_UART */
+
+#if defined(LOSCFG_TELINK_B91_CONSOLE_DMA)
+    return B91ConsoleBusy();
+#else  /* LOSCFG_TELINK_B91_CONSOLE_DMA */
+    return FALSE;
+#endif /* LOSCFG_TELINK_B91_CONSOLE_DMA */
+}
+
+STATIC VOID PmWaitForTick(VOID)
+{
+    /* Interrupts are locked, a pending tick still ends wfi */
+    set_csr(NDS_MIE, MIE_MTIE);
+    __asm__ volatile("wfi");
+    clear_csr(NDS_MIE, MIE_MTIE);
+}
+
+STATIC UINT32 PmNormalSuspend(VOID)
+{
+    __asm__ volatile("wfi");
+    return LOS_OK;
+}
+
+/* The stack wakes up ahead of its next event, whichever comes first bounds the suspend */
+STATIC UINT32 PmRadioTicks(UINT32 now)
+{
+    UINT8 state = blc_ll_getCurrentState();
+
+    if ((state != BLS_LINK_STATE_ADV) && (state != BLS_LINK_STATE_CONN)) {
+        return B91_SLEEP_RADIO_IDLE;
+    }
+
+    INT32 ticks = (INT32)(bls_pm_getNexteventWakeupTick() - now);
+    INT32 wakeup = (INT32)(bls_pm_getSystemWakeupTick() - now);
+    if ((wakeup > 0) && (wakeup < ticks)) {
+        ticks = wakeup;
+    }
+
+    return (ticks > 0) ? (UINT32)ticks : 0;
+}
+
+STATIC UINT32 PmLightSuspend(VOID)
+{
+    UINT32 wakeTicks = 0;
+    B91SleepState state = {
+        .idleTicks = g_pm.idleTicks,
+        .radioTicks = PmRadioTicks(g_pm.sleepStart),
+        .wakeLocks = g_pm.wakeLocks,
+        .busy = PmBusy(),
+    };
+
+    switch (B91SleepDecide(&g_sleepPolicy, &state, &wakeTicks)) {
+        case B91_SLEEP_SUSPEND:
+#if defined(LOSCFG_TELINK_B91_KEYSCAN)
+            B91KeyscanWakeArm();
+#endif /* LOSCFG_TELINK_B91_KEYSCAN */
+            (VOID)cpu_sleep_wakeup(SUSPEND_MODE, PM_WAKEUP_TIMER | PM_WAKEUP_PAD, g_pm.sleepStart + wakeTicks);
+#if defined(LOSCFG_TELINK_B91_KEYSCAN)
+            B91KeyscanWakeDisarm();
+#endif /* LOSCFG_TELINK_B91_KEYSCAN */
+            break;
+        case B91_SLEEP_WFI:
+            PmWaitForTick();
+            break;
+        default:
+            break;
+    }
+
+    return LOS_OK;
+}
+
+STATIC LosPmTickTimer g_pmTickTimer = {
+    .freq = SYSTEM_TIMER_TICK_1S,
+    .timerStart = PmTimerStart,
+    .timerStop = PmTimerStop,
+    .timerCycleGet = PmTimerCycleGet,
+    .tickLock = PmTickLock,
+    .tickUnlock = PmTickUnlock,
+};
+
+STATIC LosPmSysctrl g_pmSysctrl = {
+    .normalSuspend = PmNormalSuspend,
+    .lightSuspend = PmLightSuspend,
+};
+
+UINT32 B91PmInit(VOID)
+{
+    UINT32 ret = LOS_PmRegister(LOS_PM_TYPE_TICK_TIMER, &g_pmTickTimer);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    ret = LOS_PmRegister(LOS_PM_TYPE_SYSCTRL, &g_pmSysctrl);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    return LOS_PmModeSet(LOS_SYS_LIGHT_SLEEP);
+}
+
+VOID B91PmWakeLock(VOID)
+{
+    UINT32 intSave = LOS_IntLock();
+    ++g_pm.wakeLocks;
+    LOS_IntRestore(intSave);
+}
+
+VOID B91PmWakeUnlock(VOID)
+{
+    UINT32 intSave = LOS_IntLock();
+    if (g_pm.wakeLocks != 0) {
+        --g_pm.wakeLocks;
+    }
+    LOS_IntRestore(intSave);
+}
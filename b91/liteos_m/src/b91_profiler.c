@@ -0,0 +1,155 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <stdio.h>
+
+#include <target_config.h>
+
+#include <los_interrupt.h>
+#include <los_task.h>
+
+#include <B91/clock.h>
+#include <B91/core.h>
+#include <B91/timer.h>
+
+#include <b91_irq.h>
+#include <b91_profiler.h>
+
+#if defined(LOSCFG_TELINK_B91_DVFS)
+#include <b91_dvfs.h>
+#endif /* LOSCFG_TELINK_B91_DVFS */
+
+#ifndef LOSCFG_TELINK_B91_PROFILER_SAMPLES
+#define LOSCFG_TELINK_B91_PROFILER_SAMPLES 1024
+#endif /* LOSCFG_TELINK_B91_PROFILER_SAMPLES */
+
+#define PROFILER_SAMPLES   LOSCFG_TELINK_B91_PROFILER_SAMPLES
+#define PROFILER_TIMER     TIMER1
+#define PROFILER_TIMER_IRQ IRQ3_TIMER1
+#define PROFILER_TIMER_STA TMR_STA_TMR1
+#define PROFILER_HZ_MAX    10000
+
+#define HZ_IN_MHZ (1000 * 1000)
+
+typedef struct {
+    UINT32 pc;
+    UINT32 taskID;
+} ProfilerSample;
+
+/*
+ * Samples are taken with the kernel trap context still live, so mepc is the PC the
+ * timer interrupted. Interrupts do not nest here: time spent in other ISRs or with
+ * interrupts locked is charged to the first instruction after interrupts are re-enabled.
+ */
+STATIC struct {
+    ProfilerSample samples[PROFILER_SAMPLES];
+    volatile UINT32 head;
+    volatile UINT32 tail;
+    UINT32 lost;
+    UINT32 hz;
+    BOOL running;
+} g_profiler;
+
+_attribute_ram_code_ STATIC VOID ProfilerTimerIrq(VOID)
+{
+    timer_clr_irq_status(PROFILER_TIMER_STA);
+
+    UINT32 head = g_profiler.head;
+    if ((head - g_profiler.tail) >= PROFILER_SAMPLES) {
+        ++g_profiler.lost;
+        return;
+    }
+
+    ProfilerSample *sample = &g_profiler.samples[head % PROFILER_SAMPLES];
+    sample->pc = read_csr(NDS_MEPC);
+    sample->taskID = LOS_CurTaskIDGet();
+    g_profiler.head = head + 1;
+}
+
+/* TIMER1 counts pclk, the period has to follow it to keep the sampling rate */
+STATIC VOID ProfilerTimerSet(VOID)
+{
+    timer_stop(PROFILER_TIMER);
+    timer_set_init_tick(PROFILER_TIMER, 0);
+    timer_set_cap_tick(PROFILER_TIMER, sys_clk.pclk * HZ_IN_MHZ / g_profiler.hz);
+    timer_set_mode(PROFILER_TIMER, TIMER_MODE_SYSCLK);
+}
+
+#if defined(LOSCFG_TELINK_B91_DVFS)
+STATIC VOID ProfilerClockChanged(B91DvfsEvent event, VOID *arg)
+{
+    (VOID)arg;
+
+    if ((event == B91_DVFS_POST_CHANGE) && g_profiler.running) {
+        ProfilerTimerSet();
+        timer_start(PROFILER_TIMER);
+    }
+}
+#endif /* LOSCFG_TELINK_B91_DVFS */
+
+UINT32 B91ProfilerStart(UINT32 hz)
+{
+    if ((hz == 0) || (hz > PROFILER_HZ_MAX)) {
+        return LOS_NOK;
+    }
+
+#if defined(LOSCFG_TELINK_B91_DVFS)
+    if (B91DvfsNotifierRegister(ProfilerClockChanged, NULL) != LOS_OK) {
+        return LOS_NOK;
+    }
+#endif /* LOSCFG_TELINK_B91_DVFS */
+
+    g_profiler.hz = hz;
+
+    B91IrqRegister(PROFILER_TIMER_IRQ, (HWI_PROC_FUNC)ProfilerTimerIrq, 0);
+    ProfilerTimerSet();
+    plic_interrupt_enable(PROFILER_TIMER_IRQ);
+    g_profiler.running = TRUE;
+    timer_start(PROFILER_TIMER);
+
+    return LOS_OK;
+}
+
+VOID B91ProfilerStop(VOID)
+{
+    g_profiler.running = FALSE;
+    timer_stop(PROFILER_TIMER);
+    plic_interrupt_disable(PROFILER_TIMER_IRQ);
+    B91IrqRegister(PROFILER_TIMER_IRQ, NULL, 0);
+}
+
+VOID B91ProfilerDump(VOID)
+{
+    TSK_INFO_S info;
+
+    printf("#prof hz=%u lost=%u\r\n", g_profiler.hz, g_profiler.lost);
+
+    for (UINT32 taskID = 0; taskID <= LOSCFG_BASE_CORE_TSK_LIMIT; ++taskID) {
+        if (LOS_TaskInfoGet(taskID, &info) == LOS_OK) {
+            printf("#task %u %s\r\n", taskID, info.acName);
+        }
+    }
+
+    while (g_profiler.tail != g_profiler.head) {
+        const ProfilerSample *sample = &g_profiler.samples[g_profiler.tail % PROFILER_SAMPLES];
+        printf("#s %08x %u\r\n", sample->pc, sample->taskID);
+        ++g_profiler.tail;
+    }
+
+    printf("#end\r\n");
+}
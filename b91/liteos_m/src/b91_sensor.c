@@ -0,0 +1,354 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#include <stdint.h>
+
+#include <target_config.h>
+
+#include <los_mux.h>
+#include <los_sem.h>
+#include <los_task.h>
+
+#include <B91/stimer.h>
+
+#include <stack/ble/ble.h>
+
+#include <b91_sensor.h>
+
+#ifndef LOSCFG_TELINK_B91_SENSOR_TASK_PRIO
+#define LOSCFG_TELINK_B91_SENSOR_TASK_PRIO 6
+#endif /* LOSCFG_TELINK_B91_SENSOR_TASK_PRIO */
+
+#ifndef LOSCFG_TELINK_B91_SENSOR_EVENT_US
+#define LOSCFG_TELINK_B91_SENSOR_EVENT_US 2500
+#endif /* LOSCFG_TELINK_B91_SENSOR_EVENT_US */
+
+#define SENSOR_TASK_STACKSIZE 0x1000
+#define SENSOR_TASK_PRIO      LOSCFG_TELINK_B91_SENSOR_TASK_PRIO
+#define SENSOR_TASK_NAME      "B91Sensor"
+
+#define SENSOR_PERIOD_MAX_US  (100 * 1000 * 1000) /* due ticks are compared as signed 32 bit differences */
+#define SENSOR_EVENT_TICKS    (LOSCFG_TELINK_B91_SENSOR_EVENT_US * SYSTEM_TIMER_TICK_1US)
+#define SENSOR_MARGIN_TICKS   (500 * SYSTEM_TIMER_TICK_1US)
+#define SENSOR_WAKEUP_LEAD    (5 * SYSTEM_TIMER_TICK_1MS) /* longest plausible stack wakeup ahead of its event */
+#define SENSOR_OS_TICK        (SYSTEM_TIMER_TICK_1S / LOSCFG_BASE_CORE_TICK_PER_SECOND)
+#define SENSOR_EVENTS_MAX     64
+#define SENSOR_WAIT_FOREVER   UINT32_MAX
+
+/*
+ * Radio activity as seen by the CPU: busy spans of len ticks starting at first and
+ * repeating every interval ticks during a connection. With slave latency the stack
+ * skips some of the extrapolated events, reads placed after those cost a wakeup of
+ * their own but still keep clear of the radio.
+ */
+typedef struct {
+    BOOL active;
+    UINT32 first;
+    UINT32 len;
+    UINT32 interval; /* 0: a single span */
+} SensorRadio;
+
+STATIC struct {
+    B91Sensor *sensors;
+    UINT32 semID;
+    UINT32 mutex;
+    B91SensorStats stats;
+    BOOL ready;
+} g_sensor;
+
+STATIC INLINE BOOL TickBefore(UINT32 a, UINT32 b)
+{
+    return (INT32)(a - b) < 0;
+}
+
+STATIC VOID SensorRadioGet(SensorRadio *radio, UINT32 now)
+{
+    UINT8 state = blc_ll_getCurrentState();
+
+    radio->active = (state == BLS_LINK_STATE_ADV) || (state == BLS_LINK_STATE_CONN);
+    if (!radio->active) {
+        return;
+    }
+
+    /* The stack leaves suspend ahead of the event, the CPU is taken from that wakeup on */
+    UINT32 event = bls_pm_getNexteventWakeupTick();
+    UINT32 wakeup = bls_pm_getSystemWakeupTick();
+    UINT32 start = event;
+    if (TickBefore(wakeup, event) && TickBefore(event - SENSOR_WAKEUP_LEAD, wakeup)) {
+        start = wakeup;
+    }
+
+    radio->first = start - SENSOR_MARGIN_TICKS;
+    radio->len = (event - radio->first) + SENSOR_EVENT_TICKS;
+    radio->interval = 0;
+
+    if (state == BLS_LINK_STATE_CONN) {
+        radio->interval = bls_ll_getConnectionInterval() * SYSTEM_TIMER_TICK_1250US;
+        /* No gap between events to use */
+        if (radio->interval <= radio->len) {
+            radio->interval = 0;
+        }
+    }
+
+    /* A stale event tick: move to the first span not over yet */
+    if (radio->interval != 0) {
+        for (UINT32 k = 0; (k < SENSOR_EVENTS_MAX) && TickBefore(radio->first + radio->len, now); ++k) {
+            radio->first += radio->interval;
+        }
+    }
+}
+
+/* Find the radio span overlapping [t, t + dur), if any */
+STATIC BOOL SensorRadioOverlap(const SensorRadio *radio, UINT32 t, UINT32 dur, UINT32 *spanStart)
+{
+    UINT32 end = t + dur;
+    UINT32 start = radio->first;
+
+    if (!TickBefore(start, end)) {
+        return FALSE;
+    }
+
+    if (radio->interval != 0) {
+        start += ((end - 1 - start) / radio->interval) * radio->interval;
+    }
+
+    if (TickBefore(t, start + radio->len)) {
+        *spanStart = start;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/*
+ * Choose when to run a batch of dur ticks that may start at from and should start by
+ * deadline. Right after a radio event is preferred, the CPU is awake then anyway.
+ * Otherwise the batch gets its own wakeup at the deadline, moved clear of the radio.
+ */
+STATIC UINT32 SensorSlotFind(const SensorRadio *radio, UINT32 from, UINT32 deadline, UINT32 dur)
+{
+    UINT32 spanStart;
+
+    if (!radio->active) {
+        return deadline;
+    }
+
+    UINT32 spanEnd = radio->first + radio->len;
+    if ((radio->interval != 0) && TickBefore(spanEnd, from)) {
+        spanEnd += ((from - spanEnd + radio->interval - 1) / radio->interval) * radio->interval;
+    }
+
+    for (UINT32 k = 0; (k < SENSOR_EVENTS_MAX) && !TickBefore(deadline, spanEnd); ++k) {
+        if (!TickBefore(spanEnd, from) &&
+            ((radio->interval == 0) || !TickBefore(spanEnd - radio->len + radio->interval, spanEnd + dur))) {
+            return spanEnd;
+        }
+        if (radio->interval == 0) {
+            break;
+        }
+        spanEnd += radio->interval;
+    }
+
+    if (!SensorRadioOverlap(radio, deadline, dur, &spanStart)) {
+        return deadline;
+    }
+
+    if (!TickBefore(spanStart - dur, from)) {
+        return spanStart - dur;
+    }
+
+    return spanStart + radio->len;
+}
+
+STATIC VOID SensorBatchRun(UINT32 now)
+{
+    B91Sensor *sensor = g_sensor.sensors;
+
+    ++g_sensor.stats.batches;
+
+    while (sensor != NULL) {
+        if (!TickBefore(now, sensor->due - (sensor->slackUs * SYSTEM_TIMER_TICK_1US))) {
+            if (TickBefore(sensor->due + SENSOR_OS_TICK, now)) {
+                ++g_sensor.stats.late;
+            }
+            ++g_sensor.stats.reads;
+
+            sensor->due += sensor->periodUs * SYSTEM_TIMER_TICK_1US;
+            if (TickBefore(sensor->due, now)) {
+                sensor->due = now + (sensor->periodUs * SYSTEM_TIMER_TICK_1US);
+            }
+
+            sensor->read(sensor, sensor->arg);
+        }
+
+        /* Read after the callback, it may have removed its successor */
+        sensor = sensor->next;
+    }
+}
+
+/* Run the reads that are due, or return the stimer ticks to wait for the next batch */
+STATIC UINT32 SensorPass(VOID)
+{
+    SensorRadio radio;
+    B91Sensor *sensor = NULL;
+
+    if (g_sensor.sensors == NULL) {
+        return SENSOR_WAIT_FOREVER;
+    }
+
+    UINT32 now = stimer_get_tick();
+    UINT32 deadline = g_sensor.sensors->due;
+    UINT32 eligible = deadline - (g_sensor.sensors->slackUs * SYSTEM_TIMER_TICK_1US);
+    for (sensor = g_sensor.sensors->next; sensor != NULL; sensor = sensor->next) {
+        if (TickBefore(sensor->due, deadline)) {
+            deadline = sensor->due;
+        }
+        if (TickBefore(sensor->due - (sensor->slackUs * SYSTEM_TIMER_TICK_1US), eligible)) {
+            eligible = sensor->due - (sensor->slackUs * SYSTEM_TIMER_TICK_1US);
+        }
+    }
+
+    /* Everything that may join the batch by the deadline has to fit in the slot */
+    UINT32 dur = 0;
+    for (sensor = g_sensor.sensors; sensor != NULL; sensor = sensor->next) {
+        if (!TickBefore(deadline, sensor->due - (sensor->slackUs * SYSTEM_TIMER_TICK_1US))) {
+            dur += sensor->durationUs * SYSTEM_TIMER_TICK_1US;
+        }
+    }
+
+    UINT32 from = TickBefore(eligible, now) ? now : eligible;
+    if (TickBefore(deadline, from)) {
+        deadline = from;
+    }
+
+    SensorRadioGet(&radio, now);
+    UINT32 slot = SensorSlotFind(&radio, from, deadline, dur);
+    if (TickBefore(now, slot)) {
+        return slot - now;
+    }
+
+    SensorBatchRun(now);
+
+    return 0;
+}
+
+STATIC VOID SensorTask(VOID)
+{
+    while (1) {
+        (VOID)LOS_MuxPend(g_sensor.mutex, LOS_WAIT_FOREVER);
+        UINT32 wait = SensorPass();
+        (VOID)LOS_MuxPost(g_sensor.mutex);
+
+        if (wait == SENSOR_WAIT_FOREVER) {
+            (VOID)LOS_SemPend(g_sensor.semID, LOS_WAIT_FOREVER);
+        } else if (wait != 0) {
+            (VOID)LOS_SemPend(g_sensor.semID, (wait + SENSOR_OS_TICK - 1) / SENSOR_OS_TICK);
+        }
+    }
+}
+
+UINT32 B91SensorSchedInit(VOID)
+{
+    UINT32 taskID;
+    TSK_INIT_PARAM_S task = {0};
+
+    UINT32 ret = LOS_BinarySemCreate(0, &g_sensor.semID);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    ret = LOS_MuxCreate(&g_sensor.mutex);
+    if (ret != LOS_OK) {
+        (VOID)LOS_SemDelete(g_sensor.semID);
+        return ret;
+    }
+
+    task.pfnTaskEntry = (TSK_ENTRY_FUNC)SensorTask;
+    task.uwStackSize = SENSOR_TASK_STACKSIZE;
+    task.pcName = SENSOR_TASK_NAME;
+    task.usTaskPrio = SENSOR_TASK_PRIO;
+
+    ret = LOS_TaskCreate(&taskID, &task);
+    if (ret == LOS_OK) {
+        g_sensor.ready = TRUE;
+    }
+
+    return ret;
+}
+
+UINT32 B91SensorAdd(B91Sensor *sensor)
+{
+    if (!g_sensor.ready || (sensor == NULL) || (sensor->read == NULL) || (sensor->periodUs == 0) ||
+        (sensor->periodUs > SENSOR_PERIOD_MAX_US) || (sensor->slackUs > sensor->periodUs)) {
+        return LOS_NOK;
+    }
+
+    (VOID)LOS_MuxPend(g_sensor.mutex, LOS_WAIT_FOREVER);
+
+    for (B91Sensor *it = g_sensor.sensors; it != NULL; it = it->next) {
+        if (it == sensor) {
+            (VOID)LOS_MuxPost(g_sensor.mutex);
+            return LOS_NOK;
+        }
+    }
+
+    sensor->due = stimer_get_tick() + (sensor->periodUs * SYSTEM_TIMER_TICK_1US);
+    sensor->next = g_sensor.sensors;
+    g_sensor.sensors = sensor;
+
+    (VOID)LOS_MuxPost(g_sensor.mutex);
+    (VOID)LOS_SemPost(g_sensor.semID);
+
+    return LOS_OK;
+}
+
+UINT32 B91SensorRemove(B91Sensor *sensor)
+{
+    UINT32 ret = LOS_NOK;
+
+    if (!g_sensor.ready || (sensor == NULL)) {
+        return LOS_NOK;
+    }
+
+    /* The mutex is held across a batch, so removing from a read callback nests */
+    (VOID)LOS_MuxPend(g_sensor.mutex, LOS_WAIT_FOREVER);
+
+    for (B91Sensor **it = &g_sensor.sensors; *it != NULL; it = &(*it)->next) {
+        if (*it == sensor) {
+            *it = sensor->next;
+            ret = LOS_OK;
+            break;
+        }
+    }
+
+    (VOID)LOS_MuxPost(g_sensor.mutex);
+
+    return ret;
+}
+
+VOID B91SensorStatsGet(B91SensorStats *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+
+    (VOID)LOS_MuxPend(g_sensor.mutex, LOS_WAIT_FOREVER);
+    *stats = g_sensor.stats;
+    (VOID)LOS_MuxPost(g_sensor.mutex);
+}
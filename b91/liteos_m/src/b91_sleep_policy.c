@@ -0,0 +1,40 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <b91_sleep_policy.h>
+
+B91SleepMode B91SleepDecide(const B91SleepPolicy *policy, const B91SleepState *state, UINT32 *wakeTicks)
+{
+    if (state->idleTicks == 0) {
+        return B91_SLEEP_NONE;
+    }
+
+    if ((state->wakeLocks != 0) || state->busy) {
+        return B91_SLEEP_WFI;
+    }
+
+    UINT32 idleTicks = (state->radioTicks < state->idleTicks) ? state->radioTicks : state->idleTicks;
+    if ((idleTicks < policy->minSuspendTicks) || (idleTicks <= policy->wakeupMarginTicks)) {
+        return B91_SLEEP_WFI;
+    }
+
+    UINT32 ticks = idleTicks - policy->wakeupMarginTicks;
+    *wakeTicks = (ticks > policy->maxSleepTicks) ? policy->maxSleepTicks : ticks;
+
+    return B91_SLEEP_SUSPEND;
+}
@@ -0,0 +1,513 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#include <los_interrupt.h>
+#include <los_sem.h>
+#include <los_swtmr.h>
+#include <los_task.h>
+#include <los_tick.h>
+
+#include <B91/clock.h>
+#include <B91/plic.h>
+
+#include <b91_dma.h>
+#include <b91_irq.h>
+#include <b91_spi.h>
+
+#if defined(LOSCFG_TELINK_B91_DVFS)
+#include <b91_dvfs.h>
+#endif /* LOSCFG_TELINK_B91_DVFS */
+
+#ifndef LOSCFG_TELINK_B91_SPI_TIMEOUT_MS
+#define LOSCFG_TELINK_B91_SPI_TIMEOUT_MS 1000
+#endif /* LOSCFG_TELINK_B91_SPI_TIMEOUT_MS */
+
+#define SPI_NUM       2
+#define SPI_CS_NONE   0
+#define SPI_LEN_MAX   (1U << 24)
+#define SPI_WORD_MASK 3
+#define SPI_ADDR_MAX  4
+
+#define SPI_WAIT_END BIT(0)
+#define SPI_WAIT_DMA BIT(1)
+
+#define SPI_DIV_MAX 0xFF
+#define HZ_IN_MHZ   (1000 * 1000)
+
+typedef struct {
+    UINT8 clkDiv;
+    BOOL ready;
+    UINT32 csPin;
+    UINT32 maxHz; /* the clock set up at init, DVFS keeps the bus at or below it */
+} SpiBus;
+
+/*
+ * HSPI and PSPI share one DMA channel, so there is a single queue for both. A transaction
+ * is over once the module raised its end interrupt and, for reads, the DMA has drained
+ * the RX FIFO into memory. The next one is started from that interrupt before the
+ * completion callback runs, which keeps the bus busy back-to-back. Every transaction
+ * programs the full module state, so devices with different modes can share a bus.
+ */
+STATIC struct {
+    SpiBus bus[SPI_NUM];
+    B91SpiXfer *head;
+    B91SpiXfer *tail;
+    UINT32 wait;
+    volatile BOOL active; /* head is on the wire */
+    BOOL held;            /* queued transactions wait for a clock change */
+    BOOL dmaReady;
+    UINT64 startTick;
+    UINT32 timerID;
+} g_spi;
+
+STATIC const UINT32 g_spiIrq[SPI_NUM] = {
+    [PSPI_MODULE] = IRQ23_SPI_APB,
+    [HSPI_MODULE] = IRQ22_SPI_AHB,
+};
+
+_attribute_ram_code_ STATIC VOID SpiCsSelect(spi_sel_e spi, UINT32 csPin)
+{
+    SpiBus *bus = &g_spi.bus[spi];
+
+    if (bus->csPin == csPin) {
+        return;
+    }
+
+    if (spi == HSPI_MODULE) {
+        (VOID)hspi_change_csn_pin((hspi_csn_pin_def_e)csPin);
+    } else {
+        (VOID)pspi_change_csn_pin((pspi_csn_pin_def_e)csPin);
+    }
+    bus->csPin = csPin;
+}
+
+_attribute_ram_code_ STATIC VOID SpiHspiPhasesSet(const B91SpiXfer *xfer)
+{
+    if (xfer->flags & B91_SPI_XFER_ADDR) {
+        BM_CLR(reg_hspi_xip_ctrl, FLD_HSPI_ADDR_LEN);
+        hspi_set_addr_len(xfer->addrLen);
+        hspi_set_address(xfer->addr);
+        hspi_addr_en();
+    } else {
+        hspi_addr_dis();
+    }
+
+    if (xfer->flags & B91_SPI_XFER_WIDE) {
+        hspi_cmd_fmt_en();
+        hspi_addr_fmt_en();
+    } else {
+        hspi_cmd_fmt_dis();
+        hspi_addr_fmt_dis();
+    }
+}
+
+_attribute_ram_code_ STATIC spi_tans_mode_e SpiTransMode(const B91SpiXfer *xfer)
+{
+    BOOL dummy = (xfer->dummy != 0);
+
+    if ((xfer->txLen != 0) && (xfer->rxLen != 0)) {
+        return dummy ? SPI_MODE_WRITE_DUMMY_READ : SPI_MODE_WRITE_READ;
+    } else if (xfer->rxLen != 0) {
+        return dummy ? SPI_MODE_DUMMY_READ : SPI_MODE_READ_ONLY;
+    } else if (xfer->txLen != 0) {
+        return dummy ? SPI_MODE_DUMMY_WRITE : SPI_MODE_WRITE_ONLY;
+    }
+
+    return SPI_MODE_NONE_DATA;
+}
+
+STATIC UINT32 SpiModuleHz(spi_sel_e spi)
+{
+    return ((spi == HSPI_MODULE) ? sys_clk.hclk : sys_clk.pclk) * HZ_IN_MHZ;
+}
+
+_attribute_ram_code_ STATIC VOID SpiXferStart(B91SpiXfer *xfer)
+{
+    spi_sel_e spi = xfer->spi;
+
+    g_spi.active = TRUE;
+    g_spi.startTick = LOS_TickCountGet();
+    (VOID)LOS_SwtmrStart(g_spi.timerID);
+
+    SpiCsSelect(spi, xfer->csPin);
+
+    spi_master_init(spi, g_spi.bus[spi].clkDiv, xfer->mode);
+    spi_set_io_mode(spi, xfer->ioMode);
+    if (xfer->flags & B91_SPI_XFER_CMD) {
+        spi_cmd_en(spi);
+    } else {
+        spi_cmd_dis(spi);
+    }
+    if (spi == HSPI_MODULE) {
+        SpiHspiPhasesSet(xfer);
+    }
+    if (xfer->dummy != 0) {
+        spi_set_dummy_cnt(spi, xfer->dummy);
+    }
+    spi_set_transmode(spi, SpiTransMode(xfer));
+
+    spi_tx_fifo_clr(spi);
+    spi_rx_fifo_clr(spi);
+    spi_tx_dma_dis(spi);
+    spi_rx_dma_dis(spi);
+    if (xfer->txLen != 0) {
+        spi_tx_cnt(spi, xfer->txLen);
+    }
+    if (xfer->rxLen != 0) {
+        spi_rx_cnt(spi, xfer->rxLen);
+    }
+
+    dma_chn_dis(B91_DMA_CHN_SPI);
+    dma_clr_tc_irq_status(BIT(B91_DMA_CHN_SPI));
+    spi_clr_irq_status(spi, SPI_END_INT);
+    spi_set_irq_mask(spi, SPI_END_INT_EN);
+    g_spi.wait = SPI_WAIT_END;
+
+    if (xfer->rxLen != 0) {
+        if (spi == HSPI_MODULE) {
+            hspi_set_rx_dma_config(B91_DMA_CHN_SPI);
+        } else {
+            pspi_set_rx_dma_config(B91_DMA_CHN_SPI);
+        }
+        spi_rx_dma_en(spi);
+        spi_set_dma(B91_DMA_CHN_SPI, reg_spi_data_buf_adr(spi), convert_ram_addr_cpu2bus(xfer->rx), xfer->rxLen);
+        g_spi.wait |= SPI_WAIT_DMA;
+    } else if (xfer->txLen != 0) {
+        if (spi == HSPI_MODULE) {
+            hspi_set_tx_dma_config(B91_DMA_CHN_SPI);
+        } else {
+            pspi_set_tx_dma_config(B91_DMA_CHN_SPI);
+        }
+        spi_tx_dma_en(spi);
+        spi_set_dma(B91_DMA_CHN_SPI, convert_ram_addr_cpu2bus(xfer->tx), reg_spi_data_buf_adr(spi), xfer->txLen);
+    }
+
+    /* Writing the command register starts the transaction, with or without a command phase */
+    spi_set_cmd(spi, xfer->cmd);
+
+    /* The header of a read fits in the empty TX FIFO, this never waits */
+    if ((xfer->rxLen != 0) && (xfer->txLen != 0)) {
+        spi_write(spi, (unsigned char *)xfer->tx, xfer->txLen);
+    }
+}
+
+_attribute_ram_code_ STATIC VOID SpiXferComplete(UINT32 status)
+{
+    B91SpiXfer *xfer = g_spi.head;
+
+    (VOID)LOS_SwtmrStop(g_spi.timerID);
+    g_spi.active = FALSE;
+    g_spi.wait = 0;
+    g_spi.head = xfer->next;
+    if (g_spi.head == NULL) {
+        g_spi.tail = NULL;
+    } else if (!g_spi.held) {
+        SpiXferStart(g_spi.head);
+    }
+
+    xfer->next = NULL;
+    xfer->status = status;
+    if (xfer->done != NULL) {
+        xfer->done(xfer, xfer->arg);
+    }
+}
+
+/* A module left waiting for data that will never come is only recovered by a reset */
+_attribute_ram_code_ STATIC VOID SpiXferAbort(VOID)
+{
+    spi_sel_e spi = g_spi.head->spi;
+
+    dma_chn_dis(B91_DMA_CHN_SPI);
+    if (spi == HSPI_MODULE) {
+        hspi_reset();
+    } else {
+        pspi_reset();
+    }
+
+    SpiXferComplete(LOS_NOK);
+}
+
+_attribute_ram_code_ STATIC VOID SpiDmaIrq(VOID *arg, UINT32 events)
+{
+    (VOID)arg;
+
+    if (g_spi.head == NULL) {
+        return;
+    }
+
+    if (events & (B91_DMA_EVENT_ERR | B91_DMA_EVENT_ABT)) {
+        SpiXferAbort();
+        return;
+    }
+
+    /* The terminal count of a write comes before the end interrupt and is not waited for */
+    if ((events & B91_DMA_EVENT_TC) && (g_spi.wait & SPI_WAIT_DMA)) {
+        g_spi.wait &= ~SPI_WAIT_DMA;
+        if (g_spi.wait == 0) {
+            SpiXferComplete(LOS_OK);
+        }
+    }
+}
+
+_attribute_ram_code_ STATIC VOID SpiIrqHandler(VOID *arg)
+{
+    spi_sel_e spi = (spi_sel_e)(UINTPTR)arg;
+
+    if (!spi_get_irq_status(spi, SPI_END_INT)) {
+        return;
+    }
+    spi_clr_irq_status(spi, SPI_END_INT);
+
+    if ((g_spi.head == NULL) || (g_spi.head->spi != spi) || !(g_spi.wait & SPI_WAIT_END)) {
+        return;
+    }
+
+    g_spi.wait &= ~SPI_WAIT_END;
+    if (g_spi.wait == 0) {
+        SpiXferComplete(LOS_OK);
+    }
+}
+
+/* Software timer context: a transaction that started after the timer fired is left alone */
+STATIC VOID SpiTimeout(UINT32 arg)
+{
+    (VOID)arg;
+
+    UINT32 intSave = LOS_IntLock();
+
+    if (g_spi.active &&
+        ((LOS_TickCountGet() - g_spi.startTick) >= LOS_MS2Tick(LOSCFG_TELINK_B91_SPI_TIMEOUT_MS))) {
+        SpiXferAbort();
+    }
+
+    LOS_IntRestore(intSave);
+}
+
+#if defined(LOSCFG_TELINK_B91_DVFS)
+/*
+ * HSPI runs from hclk and PSPI from pclk. The transaction on the wire finishes on the old
+ * clock, the divider of each bus is then picked again so its clock stays at or below the
+ * one it was set up for, and the queue resumes.
+ */
+STATIC VOID SpiClockChanged(B91DvfsEvent event, VOID *arg)
+{
+    (VOID)arg;
+
+    if (event == B91_DVFS_PRE_CHANGE) {
+        g_spi.held = TRUE;
+        while (g_spi.active) {
+            /* the timeout aborts a stuck transaction from the software timer task */
+            (VOID)LOS_TaskDelay(1);
+        }
+        return;
+    }
+
+    UINT32 intSave = LOS_IntLock();
+
+    for (UINT32 spi = 0; spi < SPI_NUM; ++spi) {
+        SpiBus *bus = &g_spi.bus[spi];
+        if (bus->ready) {
+            UINT32 div = (SpiModuleHz((spi_sel_e)spi) + (2 * bus->maxHz) - 1) / (2 * bus->maxHz);
+            bus->clkDiv = (UINT8)((div > (SPI_DIV_MAX + 1)) ? SPI_DIV_MAX : ((div == 0) ? 0 : (div - 1)));
+        }
+    }
+
+    g_spi.held = FALSE;
+    if ((g_spi.head != NULL) && !g_spi.active) {
+        SpiXferStart(g_spi.head);
+    }
+
+    LOS_IntRestore(intSave);
+}
+#endif /* LOSCFG_TELINK_B91_DVFS */
+
+STATIC UINT32 SpiEngineInit(VOID)
+{
+#if (LOSCFG_BASE_CORE_SWTMR_ALIGN == 1)
+    UINT32 ret = LOS_SwtmrCreate(LOS_MS2Tick(LOSCFG_TELINK_B91_SPI_TIMEOUT_MS), LOS_SWTMR_MODE_ONCE, SpiTimeout,
+                                 &g_spi.timerID, 0, OS_SWTMR_ROUSES_ALLOW, OS_SWTMR_ALIGN_INSENSITIVE);
+#else  /* LOSCFG_BASE_CORE_SWTMR_ALIGN */
+    UINT32 ret = LOS_SwtmrCreate(LOS_MS2Tick(LOSCFG_TELINK_B91_SPI_TIMEOUT_MS), LOS_SWTMR_MODE_ONCE, SpiTimeout,
+                                 &g_spi.timerID, 0);
+#endif /* LOSCFG_BASE_CORE_SWTMR_ALIGN */
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    if (B91DmaIrqRegister(B91_DMA_CHN_SPI, SpiDmaIrq, NULL) != LOS_OK) {
+        (VOID)LOS_SwtmrDelete(g_spi.timerID);
+        return LOS_NOK;
+    }
+
+#if defined(LOSCFG_TELINK_B91_DVFS)
+    if (B91DvfsNotifierRegister(SpiClockChanged, NULL) != LOS_OK) {
+        (VOID)LOS_SwtmrDelete(g_spi.timerID);
+        return LOS_NOK;
+    }
+#endif /* LOSCFG_TELINK_B91_DVFS */
+
+    g_spi.dmaReady = TRUE;
+
+    return LOS_OK;
+}
+
+UINT32 B91SpiInit(spi_sel_e spi, UINT8 clkDiv)
+{
+    if (spi >= SPI_NUM) {
+        return LOS_NOK;
+    }
+
+    if (g_spi.head != NULL) {
+        return LOS_NOK;
+    }
+
+    if (!g_spi.dmaReady) {
+        UINT32 ret = SpiEngineInit();
+        if (ret != LOS_OK) {
+            return ret;
+        }
+    }
+
+    UINT32 intSave = LOS_IntLock();
+
+    if (g_spi.head != NULL) {
+        LOS_IntRestore(intSave);
+        return LOS_NOK;
+    }
+
+    SpiBus *bus = &g_spi.bus[spi];
+    bus->clkDiv = clkDiv;
+    bus->maxHz = SpiModuleHz(spi) / ((clkDiv + 1) * 2);
+    bus->csPin = SPI_CS_NONE;
+    bus->ready = TRUE;
+
+    spi_master_init(spi, clkDiv, SPI_MODE0);
+    spi_set_irq_mask(spi, SPI_END_INT_EN);
+    B91IrqRegister(g_spiIrq[spi], (HWI_PROC_FUNC)SpiIrqHandler, (HWI_ARG_T)spi);
+    plic_interrupt_enable(g_spiIrq[spi]);
+
+    LOS_IntRestore(intSave);
+
+    return LOS_OK;
+}
+
+STATIC BOOL SpiXferValid(const B91SpiXfer *xfer)
+{
+    if ((xfer->spi >= SPI_NUM) || !g_spi.bus[xfer->spi].ready) {
+        return FALSE;
+    }
+
+    if ((xfer->txLen >= SPI_LEN_MAX) || (xfer->rxLen >= SPI_LEN_MAX) || ((xfer->txLen != 0) && (xfer->tx == NULL)) ||
+        ((xfer->rxLen != 0) && (xfer->rx == NULL))) {
+        return FALSE;
+    }
+
+    /* Reads and command only transactions are clocked by the command phase */
+    if (!(xfer->flags & B91_SPI_XFER_CMD) && ((xfer->txLen == 0) || (xfer->rxLen != 0))) {
+        return FALSE;
+    }
+
+    if (xfer->rxLen != 0) {
+        if ((xfer->txLen > B91_SPI_HEADER_MAX) || ((UINTPTR)xfer->rx & SPI_WORD_MASK)) {
+            return FALSE;
+        }
+    } else if ((UINTPTR)xfer->tx & SPI_WORD_MASK) {
+        return FALSE;
+    }
+
+    if (xfer->spi == PSPI_MODULE) {
+        return !(xfer->flags & (B91_SPI_XFER_ADDR | B91_SPI_XFER_WIDE)) && (xfer->ioMode != HSPI_QUAD_MODE);
+    }
+
+    return !(xfer->flags & B91_SPI_XFER_ADDR) || ((xfer->addrLen != 0) && (xfer->addrLen <= SPI_ADDR_MAX));
+}
+
+UINT32 B91SpiSubmit(B91SpiXfer *xfer)
+{
+    if ((xfer == NULL) || !SpiXferValid(xfer)) {
+        return LOS_NOK;
+    }
+
+    xfer->next = NULL;
+    xfer->status = LOS_OK;
+
+    UINT32 intSave = LOS_IntLock();
+
+    if (g_spi.tail == NULL) {
+        g_spi.head = xfer;
+        g_spi.tail = xfer;
+        if (!g_spi.held) {
+            SpiXferStart(xfer);
+        }
+    } else {
+        g_spi.tail->next = xfer;
+        g_spi.tail = xfer;
+    }
+
+    LOS_IntRestore(intSave);
+
+    return LOS_OK;
+}
+
+STATIC VOID SpiTransferDone(B91SpiXfer *xfer, VOID *arg)
+{
+    (VOID)xfer;
+    (VOID)LOS_SemPost((UINT32)(UINTPTR)arg);
+}
+
+UINT32 B91SpiTransfer(B91SpiXfer *xfer)
+{
+    UINT32 semID;
+
+    if (xfer == NULL) {
+        return LOS_NOK;
+    }
+
+    UINT32 ret = LOS_BinarySemCreate(0, &semID);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    xfer->done = SpiTransferDone;
+    xfer->arg = (VOID *)(UINTPTR)semID;
+
+    ret = B91SpiSubmit(xfer);
+    if (ret == LOS_OK) {
+        (VOID)LOS_SemPend(semID, LOS_WAIT_FOREVER);
+        ret = xfer->status;
+    }
+
+    (VOID)LOS_SemDelete(semID);
+
+    return ret;
+}
+
+BOOL B91SpiBusy(VOID)
+{
+    return (g_spi.head != NULL);
+}
+
+UINT32 B91SpiClockGet(spi_sel_e spi)
+{
+    if ((spi >= SPI_NUM) || !g_spi.bus[spi].ready) {
+        return 0;
+    }
+
+    return SpiModuleHz(spi) / ((g_spi.bus[spi].clkDiv + 1) * 2);
+}
@@ -0,0 +1,167 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <stdio.h>
+
+#include <target_config.h>
+
+#include <los_task.h>
+#include <los_tick.h>
+
+#include <b91_stack_monitor.h>
+
+#define STACK_MONITOR_TASK_STACKSIZE 0x600
+#define STACK_MONITOR_TASK_PRIO      (OS_TASK_PRIORITY_LOWEST - 1)
+#define STACK_MONITOR_TASK_NAME      "StackMonitor"
+
+/* Usage above this percentage is flagged in the report */
+#define STACK_MONITOR_WARN_PERCENT 90
+#define PERCENT                    100
+
+extern UINT32 __start_and_irq_stack[], __start_and_irq_stack_top[];
+extern UINT32 __except_stack[], __except_stack_top[];
+extern UINT32 __nmi_stack[], __nmi_stack_top[];
+
+STATIC const struct {
+    const CHAR *name;
+    UINT32 *base;
+    UINT32 *top;
+} g_intStacks[B91_INT_STACK_NUM] = {
+    [B91_INT_STACK_START_AND_IRQ] = {"irq", __start_and_irq_stack, __start_and_irq_stack_top},
+    [B91_INT_STACK_EXCEPTION] = {"exc", __except_stack, __except_stack_top},
+    [B91_INT_STACK_NMI] = {"nmi", __nmi_stack, __nmi_stack_top},
+};
+
+STATIC UINT32 g_stackMonitorPeriod;
+
+/*
+ * Stacks grow down, so the untouched part is at the far (low) end.
+ * Count intact magic words from there, a few words per iteration.
+ */
+#define SCAN_UNROLL 4
+
+STATIC const UINT32 *ScanWatermark(const UINT32 *base, const UINT32 *top)
+{
+    const UINT32 *p = base;
+
+    while ((p + SCAN_UNROLL) <= top) {
+        UINT32 diff = (p[0] ^ B91_INT_STACK_MAGIC) | (p[1] ^ B91_INT_STACK_MAGIC) | /* 1: second word */
+                      (p[2] ^ B91_INT_STACK_MAGIC) | (p[3] ^ B91_INT_STACK_MAGIC);  /* 2, 3: third and fourth word */
+        if (diff != 0) {
+            break;
+        }
+        p += SCAN_UNROLL;
+    }
+
+    while ((p < top) && (*p == B91_INT_STACK_MAGIC)) {
+        ++p;
+    }
+
+    return p;
+}
+
+UINT32 B91IntStackUsageGet(B91IntStackId id, B91StackUsage *usage)
+{
+    if ((id >= B91_INT_STACK_NUM) || (usage == NULL)) {
+        return LOS_NOK;
+    }
+
+    const UINT32 *base = g_intStacks[id].base;
+    const UINT32 *top = g_intStacks[id].top;
+
+    usage->size = (UINT32)((UINTPTR)top - (UINTPTR)base);
+    usage->peakUsed = (UINT32)((UINTPTR)top - (UINTPTR)ScanWatermark(base, top));
+
+    return LOS_OK;
+}
+
+UINT32 B91TaskStackUsageGet(UINT32 taskID, B91StackUsage *usage)
+{
+    TSK_INFO_S info;
+
+    if (usage == NULL) {
+        return LOS_NOK;
+    }
+
+    /* The kernel paints task stacks itself and computes the watermark in LOS_TaskInfoGet */
+    UINT32 ret = LOS_TaskInfoGet(taskID, &info);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    usage->size = info.uwStackSize;
+    usage->peakUsed = info.uwPeakUsed;
+
+    return LOS_OK;
+}
+
+STATIC VOID PrintUsage(const CHAR *name, const B91StackUsage *usage)
+{
+    UINT32 percent = (usage->size != 0) ? (usage->peakUsed * PERCENT / usage->size) : 0;
+
+    printf("  %-16s %6u / %6u  %3u%%%s\r\n", name, usage->peakUsed, usage->size, percent,
+           (percent >= STACK_MONITOR_WARN_PERCENT) ? "  <<<" : "");
+}
+
+VOID B91StackMonitorDump(VOID)
+{
+    B91StackUsage usage;
+    TSK_INFO_S info;
+
+    printf("Stack watermark (used / size):\r\n");
+
+    for (UINT32 id = 0; id < B91_INT_STACK_NUM; ++id) {
+        if (B91IntStackUsageGet(id, &usage) == LOS_OK) {
+            PrintUsage(g_intStacks[id].name, &usage);
+        }
+    }
+
+    for (UINT32 taskID = 0; taskID <= LOSCFG_BASE_CORE_TSK_LIMIT; ++taskID) {
+        if (LOS_TaskInfoGet(taskID, &info) != LOS_OK) {
+            continue;
+        }
+        usage.size = info.uwStackSize;
+        usage.peakUsed = info.uwPeakUsed;
+        PrintUsage(info.acName, &usage);
+    }
+}
+
+STATIC VOID StackMonitorTask(VOID)
+{
+    UINT32 ticks = LOS_MS2Tick(g_stackMonitorPeriod);
+
+    while (1) {
+        B91StackMonitorDump();
+        (VOID)LOS_TaskDelay(ticks);
+    }
+}
+
+UINT32 B91StackMonitorStart(UINT32 periodMs)
+{
+    UINT32 taskID;
+    TSK_INIT_PARAM_S task = {0};
+
+    g_stackMonitorPeriod = periodMs;
+
+    task.pfnTaskEntry = (TSK_ENTRY_FUNC)StackMonitorTask;
+    task.uwStackSize = STACK_MONITOR_TASK_STACKSIZE;
+    task.pcName = STACK_MONITOR_TASK_NAME;
+    task.usTaskPrio = STACK_MONITOR_TASK_PRIO;
+
+    return LOS_TaskCreate(&taskID, &task);
+}
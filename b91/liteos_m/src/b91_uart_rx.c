@@ -0,0 +1,417 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#include <string.h>
+
+#include <los_interrupt.h>
+
+#include <B91/plic.h>
+
+#include <b91_dma.h>
+#include <b91_irq.h>
+#include <b91_uart_rx.h>
+
+#define UART_NUM             2
+#define UART_RX_FRAMES       16
+#define UART_RX_FRAME_MASK   (UART_RX_FRAMES - 1)
+#define UART_RX_MIN_SIZE     64
+#define UART_RX_TIMEOUT_BITS 12 /* 12: start, 8 data, parity and 2 stop bits */
+#define UART_RX_WORD_MASK    3
+
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+typedef struct {
+    UINT32 end;  /* index after the last byte of the frame */
+    UINT32 next; /* index of the next frame, the DMA resumes on a word boundary */
+} UartRxFrame;
+
+/*
+ * The DMA runs forever through a descriptor linked to itself, so the ring never needs
+ * to be rearmed by software. Indexes are free running: the write index is rebuilt from
+ * the DMA destination address plus the laps counted by the terminal count interrupt.
+ * An idle timeout closes the frame in progress; the DMA is then restarted on the next
+ * word boundary so the bytes of a partial last word survive.
+ */
+typedef struct {
+    dma_chain_config_t desc __attribute__((aligned(4)));
+    B91UartRxConfig config;
+    uart_num_e uart;
+    dma_chn_e chn;
+    UINT32 mask;
+    UINT32 busBuf; /* bus address of buf, what the DMA destination register counts from */
+    volatile UINT32 laps;
+    UINT32 tail;
+    UINT32 openStart;
+    UartRxFrame frames[UART_RX_FRAMES];
+    UINT32 frameHead;
+    UINT32 frameTail;
+    B91UartRxStats stats;
+    BOOL running;
+} UartRx;
+
+STATIC UartRx g_uartRx[UART_NUM];
+
+STATIC const dma_chn_e g_uartRxChn[UART_NUM] = {B91_DMA_CHN_UART0_RX, B91_DMA_CHN_UART1_RX};
+STATIC const UINT32 g_uartIrq[UART_NUM] = {IRQ19_UART0, IRQ18_UART1};
+
+_attribute_ram_code_ STATIC UINT32 UartRxHead(const UartRx *rx)
+{
+    UINT32 size = rx->config.size;
+    UINT32 laps = rx->laps;
+    UINT32 offset = reg_dma_dst_addr(rx->chn) - rx->busBuf;
+
+    /* A wrap whose terminal count interrupt has not been serviced yet */
+    if (offset >= size) {
+        offset -= size;
+        ++laps;
+    } else if (dma_get_tc_irq_status(BIT(rx->chn))) {
+        ++laps;
+    }
+
+    return laps * size + offset;
+}
+
+_attribute_ram_code_ STATIC VOID UartRxDmaStart(UartRx *rx, UINT32 index)
+{
+    UINT32 offset = index & rx->mask;
+
+    dma_chn_dis(rx->chn);
+    dma_clr_tc_irq_status(BIT(rx->chn));
+    rx->laps = (index - offset) / rx->config.size;
+
+    dma_set_address(rx->chn, reg_uart_data_buf_adr(rx->uart), rx->busBuf + offset);
+    dma_set_size(rx->chn, rx->config.size - offset, DMA_WORD_WIDTH);
+    reg_dma_llp(rx->chn) = (unsigned int)convert_ram_addr_cpu2bus(&rx->desc);
+    dma_chn_en(rx->chn);
+}
+
+/* The writer lapped the reader: whatever was unread is gone */
+_attribute_ram_code_ STATIC VOID UartRxCheckOverrun(UartRx *rx, UINT32 head)
+{
+    if ((head - rx->tail) > rx->config.size) {
+        rx->stats.overrun += head - rx->tail;
+        rx->tail = head;
+        rx->frameTail = rx->frameHead;
+    }
+}
+
+_attribute_ram_code_ STATIC VOID UartRxFrameClose(UartRx *rx, UINT32 end, UINT32 next)
+{
+    if (end == rx->openStart) {
+        return;
+    }
+
+    ++rx->stats.frames;
+
+    if ((rx->frameHead - rx->frameTail) >= UART_RX_FRAMES) {
+        rx->stats.overrun += end - rx->tail;
+        rx->tail = next;
+        rx->frameTail = rx->frameHead;
+    } else {
+        UartRxFrame *frame = &rx->frames[rx->frameHead & UART_RX_FRAME_MASK];
+        frame->end = end;
+        frame->next = next;
+        ++rx->frameHead;
+    }
+
+    rx->openStart = next;
+}
+
+_attribute_ram_code_ STATIC VOID UartRxIrqHandler(VOID *arg)
+{
+    UartRx *rx = (UartRx *)arg;
+    BOOL error = (uart_get_irq_status(rx->uart, UART_RX_ERR) != 0);
+
+    if (!error && (uart_get_irq_status(rx->uart, UART_RXDONE) == 0)) {
+        return;
+    }
+
+    UINT32 end = UartRxHead(rx) + (reg_uart_status1(rx->uart) & FLD_UART_RBCNT);
+    UINT32 next = (end + UART_RX_WORD_MASK) & ~UART_RX_WORD_MASK;
+
+    uart_clr_irq_status(rx->uart, UART_CLR_RX);
+    UartRxDmaStart(rx, next);
+
+    if (error) {
+        ++rx->stats.errors;
+    }
+
+    UartRxCheckOverrun(rx, end);
+    UartRxFrameClose(rx, end, next);
+
+    if (rx->config.notify != NULL) {
+        rx->config.notify(rx->uart, rx->config.arg);
+    }
+}
+
+_attribute_ram_code_ STATIC VOID UartRxDmaDone(VOID *arg, UINT32 events)
+{
+    UartRx *rx = (UartRx *)arg;
+
+    if (events & B91_DMA_EVENT_TC) {
+        ++rx->laps;
+    }
+}
+
+STATIC UartRx *UartRxGet(uart_num_e uart)
+{
+    if ((uart >= UART_NUM) || !g_uartRx[uart].running) {
+        return NULL;
+    }
+
+    return &g_uartRx[uart];
+}
+
+/* End of the readable span at tail, called with interrupts locked */
+STATIC UINT32 UartRxLimit(UartRx *rx, BOOL *closed)
+{
+    UINT32 head = UartRxHead(rx);
+
+    UartRxCheckOverrun(rx, head);
+
+    *closed = (rx->frameTail != rx->frameHead);
+    if (*closed) {
+        return rx->frames[rx->frameTail & UART_RX_FRAME_MASK].end;
+    }
+
+    return head;
+}
+
+UINT32 B91UartRxStart(uart_num_e uart, const B91UartRxConfig *config)
+{
+    if ((uart >= UART_NUM) || (config == NULL) || (config->buf == NULL) ||
+        (((UINTPTR)config->buf & UART_RX_WORD_MASK) != 0) || (config->size < UART_RX_MIN_SIZE) ||
+        ((config->size & (config->size - 1)) != 0)) {
+        return LOS_NOK;
+    }
+
+    B91UartRxStop(uart);
+
+    UartRx *rx = &g_uartRx[uart];
+    (VOID)memset(rx, 0, sizeof(*rx));
+    rx->config = *config;
+    rx->uart = uart;
+    rx->chn = g_uartRxChn[uart];
+    rx->mask = config->size - 1;
+    rx->busBuf = (UINT32)convert_ram_addr_cpu2bus(config->buf);
+
+    if (B91DmaIrqRegister(rx->chn, UartRxDmaDone, rx) != LOS_OK) {
+        return LOS_NOK;
+    }
+
+    uart_set_rx_dma_config(uart, rx->chn);
+
+    rx->desc.dma_chain_ctl = reg_dma_ctrl(rx->chn) | FLD_DMA_CHANNEL_ENABLE;
+    rx->desc.dma_chain_src_addr = reg_uart_data_buf_adr(uart);
+    rx->desc.dma_chain_dst_addr = rx->busBuf;
+    rx->desc.dma_chain_data_len = dma_cal_size(config->size, DMA_WORD_WIDTH);
+    rx->desc.dma_chain_llp_ptr = (unsigned int)convert_ram_addr_cpu2bus(&rx->desc);
+
+    uart_clr_irq_status(uart, UART_CLR_RX);
+    UartRxDmaStart(rx, 0);
+
+    uart_set_dma_rx_timeout(uart, config->bwpc, UART_RX_TIMEOUT_BITS, UART_BW_MUL2);
+    uart_set_irq_mask(uart, UART_RXDONE_MASK | UART_ERR_IRQ_MASK);
+    B91IrqRegister(g_uartIrq[uart], (HWI_PROC_FUNC)UartRxIrqHandler, (HWI_ARG_T)rx);
+    plic_interrupt_enable(g_uartIrq[uart]);
+
+    rx->running = TRUE;
+
+    return LOS_OK;
+}
+
+VOID B91UartRxStop(uart_num_e uart)
+{
+    UartRx *rx = UartRxGet(uart);
+
+    if (rx == NULL) {
+        return;
+    }
+
+    plic_interrupt_disable(g_uartIrq[uart]);
+    uart_clr_irq_mask(uart, UART_RXDONE_MASK | UART_ERR_IRQ_MASK);
+    B91IrqRegister(g_uartIrq[uart], NULL, 0);
+
+    dma_chn_dis(rx->chn);
+    (VOID)B91DmaIrqRegister(rx->chn, NULL, NULL);
+
+    rx->running = FALSE;
+}
+
+UINT32 B91UartRxPeek(uart_num_e uart, const UINT8 **data, BOOL *frameEnd)
+{
+    UartRx *rx = UartRxGet(uart);
+    BOOL closed;
+
+    if ((rx == NULL) || (data == NULL)) {
+        return 0;
+    }
+
+    UINT32 intSave = LOS_IntLock();
+
+    UINT32 limit = UartRxLimit(rx, &closed);
+    UINT32 offset = rx->tail & rx->mask;
+    UINT32 len = MIN(limit - rx->tail, rx->config.size - offset);
+
+    *data = &rx->config.buf[offset];
+    if (frameEnd != NULL) {
+        *frameEnd = closed && ((rx->tail + len) == limit);
+    }
+
+    LOS_IntRestore(intSave);
+
+    return len;
+}
+
+VOID B91UartRxConsume(uart_num_e uart, UINT32 len)
+{
+    UartRx *rx = UartRxGet(uart);
+    BOOL closed;
+
+    if (rx == NULL) {
+        return;
+    }
+
+    UINT32 intSave = LOS_IntLock();
+
+    UINT32 limit = UartRxLimit(rx, &closed);
+    rx->tail += MIN(len, limit - rx->tail);
+    if (closed && (rx->tail == limit)) {
+        rx->tail = rx->frames[rx->frameTail & UART_RX_FRAME_MASK].next;
+        ++rx->frameTail;
+    }
+
+    LOS_IntRestore(intSave);
+}
+
+UINT32 B91UartRxRead(uart_num_e uart, UINT8 *buf, UINT32 size)
+{
+    const UINT8 *data = NULL;
+    UINT32 done = 0;
+
+    if (buf == NULL) {
+        return 0;
+    }
+
+    while (done < size) {
+        UINT32 len = MIN(B91UartRxPeek(uart, &data, NULL), size - done);
+        if (len == 0) {
+            break;
+        }
+
+        (VOID)memcpy(&buf[done], data, len);
+        B91UartRxConsume(uart, len);
+        done += len;
+    }
+
+    return done;
+}
+
+#if defined(LOSCFG_TELINK_B91_PBUF)
+B91Pbuf *B91UartRxReadPbuf(uart_num_e uart, B91MemRegion region, UINT32 size)
+{
+    UartRx *rx = UartRxGet(uart);
+    const UINT8 *data = NULL;
+    BOOL closed;
+
+    if (rx == NULL) {
+        return NULL;
+    }
+
+    UINT32 intSave = LOS_IntLock();
+    UINT32 len = MIN(UartRxLimit(rx, &closed) - rx->tail, size);
+    LOS_IntRestore(intSave);
+
+    if (len == 0) {
+        return NULL;
+    }
+
+    B91Pbuf *p = B91PbufAlloc(region, len);
+    if (p == NULL) {
+        return NULL;
+    }
+
+    /* The ring is the DMA target, this is the only copy the bytes see */
+    UINT32 done = 0;
+    while (done < len) {
+        UINT32 span = MIN(B91UartRxPeek(uart, &data, NULL), len - done);
+        if (span == 0) {
+            break;
+        }
+
+        (VOID)B91PbufCopyIn(p, data, span, done);
+        B91UartRxConsume(uart, span);
+        done += span;
+    }
+
+    /* An overrun in between discarded part of the frame */
+    if (done == 0) {
+        B91PbufFree(p);
+        return NULL;
+    }
+
+    B91PbufTrim(p, done);
+    return p;
+}
+#endif /* LOSCFG_TELINK_B91_PBUF */
+
+UINT32 B91UartRxStatsGet(uart_num_e uart, B91UartRxStats *stats)
+{
+    UartRx *rx = UartRxGet(uart);
+
+    if ((rx == NULL) || (stats == NULL)) {
+        return LOS_NOK;
+    }
+
+    UINT32 intSave = LOS_IntLock();
+    *stats = rx->stats;
+    LOS_IntRestore(intSave);
+
+    return LOS_OK;
+}
+
+VOID B91UartRxBitWidthSet(uart_num_e uart, UINT8 bwpc)
+{
+    UartRx *rx = UartRxGet(uart);
+
+    if (rx == NULL) {
+        return;
+    }
+
+    rx->config.bwpc = bwpc;
+    uart_set_dma_rx_timeout(uart, bwpc, UART_RX_TIMEOUT_BITS, UART_BW_MUL2);
+}
+
+BOOL B91UartRxBusy(VOID)
+{
+    BOOL busy = FALSE;
+    UINT32 intSave = LOS_IntLock();
+
+    for (UINT32 uart = 0; uart < UART_NUM; ++uart) {
+        UartRx *rx = &g_uartRx[uart];
+        if (rx->running && ((UartRxHead(rx) != rx->tail) || ((reg_uart_status1(uart) & FLD_UART_RBCNT) != 0))) {
+            busy = TRUE;
+            break;
+        }
+    }
+
+    LOS_IntRestore(intSave);
+
+    return busy;
+}
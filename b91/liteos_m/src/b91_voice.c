@@ -0,0 +1,262 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <string.h>
+
+#include <los_interrupt.h>
+#include <los_sem.h>
+#include <los_task.h>
+
+#include <stack/ble/ble.h>
+
+#include <b91_audio.h>
+#include <b91_voice.h>
+
+#ifndef LOSCFG_TELINK_B91_VOICE_TASK_PRIO
+#define LOSCFG_TELINK_B91_VOICE_TASK_PRIO 5
+#endif /* LOSCFG_TELINK_B91_VOICE_TASK_PRIO */
+
+#define VOICE_TASK_STACKSIZE  0x800
+#define VOICE_TASK_PRIO       LOSCFG_TELINK_B91_VOICE_TASK_PRIO
+#define VOICE_TASK_NAME       "B91Voice"
+#define VOICE_PERIOD_SAMPLES  256 /* 16 ms at 16 kHz */
+#define VOICE_PERIODS         4
+#define VOICE_FRAME_SIZE      B91_VOICE_FRAME_SIZE(VOICE_PERIOD_SAMPLES)
+#define VOICE_FIFO_SIZE       (VOICE_FRAME_SIZE * 4)
+#define VOICE_ATT_MTU_DEFAULT 23
+#define VOICE_ATT_HDR         3   /* opcode and handle of a notification */
+#define VOICE_NOTIFY_MAX      244 /* largest LL payload minus the L2CAP and ATT headers */
+
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+/*
+ * The DMA interrupt queues the delivered periods and posts the semaphore. The task
+ * encodes them in order and releases each one right after, so it may fall up to three
+ * periods behind. Encoded frames go to a byte FIFO with the voice task as the only
+ * producer; the task running the BLE stack is the only consumer and drains it in
+ * B91VoicePoll as far as the stack takes notifications. A frame that does not fit is
+ * dropped whole.
+ */
+STATIC struct {
+    UINT16 buf[VOICE_PERIODS * VOICE_PERIOD_SAMPLES] __attribute__((aligned(4)));
+    UINT8 frame[VOICE_FRAME_SIZE];
+    UINT8 fifo[VOICE_FIFO_SIZE];
+    UINT8 packet[VOICE_NOTIFY_MAX];
+    UINT32 head;
+    UINT32 tail;
+    INT16 *periods[VOICE_PERIODS];
+    UINT32 periodHead;
+    UINT32 periodTail;
+    B91VoiceEncoder enc;
+    B91VoiceConfig config;
+    UINT32 frames;
+    UINT32 dropped;
+    UINT32 semID;
+    UINT32 taskID;
+    BOOL taskCreated;
+    volatile UINT16 mtu;
+    volatile BOOL running;
+} g_voice = {
+    .mtu = VOICE_ATT_MTU_DEFAULT,
+};
+
+/* At most periods - 1 are held, so the queue cannot overflow; dropped periods never show up */
+STATIC VOID VoicePeriodDone(UINT16 *period, UINT32 samples, VOID *arg)
+{
+    (VOID)samples;
+    (VOID)arg;
+
+    g_voice.periods[g_voice.periodHead % VOICE_PERIODS] = (INT16 *)period;
+    ++g_voice.periodHead;
+    (VOID)LOS_SemPost(g_voice.semID);
+}
+
+STATIC VOID VoiceFifoPush(const UINT8 *data, UINT32 len)
+{
+    UINT32 head = g_voice.head;
+
+    if ((VOICE_FIFO_SIZE - (head - __atomic_load_n(&g_voice.tail, __ATOMIC_ACQUIRE))) < len) {
+        ++g_voice.dropped;
+        return;
+    }
+
+    UINT32 offset = head % VOICE_FIFO_SIZE;
+    UINT32 first = MIN(len, VOICE_FIFO_SIZE - offset);
+    (VOID)memcpy(&g_voice.fifo[offset], data, first);
+    (VOID)memcpy(g_voice.fifo, &data[first], len - first);
+    __atomic_store_n(&g_voice.head, head + len, __ATOMIC_RELEASE);
+}
+
+STATIC VOID VoiceFifoPeek(UINT8 *data, UINT32 len)
+{
+    UINT32 offset = g_voice.tail % VOICE_FIFO_SIZE;
+    UINT32 first = MIN(len, VOICE_FIFO_SIZE - offset);
+    (VOID)memcpy(data, &g_voice.fifo[offset], first);
+    (VOID)memcpy(&data[first], g_voice.fifo, len - first);
+}
+
+STATIC VOID VoiceTask(VOID)
+{
+    for (;;) {
+        (VOID)LOS_SemPend(g_voice.semID, LOS_WAIT_FOREVER);
+        if (!g_voice.running) {
+            continue;
+        }
+
+        INT16 *pcm = g_voice.periods[g_voice.periodTail % VOICE_PERIODS];
+        ++g_voice.periodTail;
+        UINT32 len = B91VoiceEncode(&g_voice.enc, pcm, VOICE_PERIOD_SAMPLES, g_voice.frame);
+        B91AudioStreamRelease(B91_AUDIO_RX);
+        ++g_voice.frames;
+
+        VoiceFifoPush(g_voice.frame, len);
+        if (g_voice.config.ready != NULL) {
+            g_voice.config.ready(g_voice.config.arg);
+        }
+    }
+}
+
+STATIC UINT32 VoiceTaskCreate(VOID)
+{
+    UINT32 ret = LOS_SemCreate(0, &g_voice.semID);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    TSK_INIT_PARAM_S task = {0};
+    task.pfnTaskEntry = (TSK_ENTRY_FUNC)VoiceTask;
+    task.uwStackSize = VOICE_TASK_STACKSIZE;
+    task.pcName = VOICE_TASK_NAME;
+    task.usTaskPrio = VOICE_TASK_PRIO;
+    ret = LOS_TaskCreate(&g_voice.taskID, &task);
+    if (ret != LOS_OK) {
+        (VOID)LOS_SemDelete(g_voice.semID);
+    }
+
+    return ret;
+}
+
+UINT32 B91VoiceStart(const B91VoiceConfig *config)
+{
+    if ((config == NULL) || g_voice.running) {
+        return LOS_NOK;
+    }
+
+    if (!g_voice.taskCreated) {
+        if (VoiceTaskCreate() != LOS_OK) {
+            return LOS_NOK;
+        }
+        g_voice.taskCreated = TRUE;
+    }
+
+    if (B91VoiceEncoderInit(&g_voice.enc, &config->codec) != LOS_OK) {
+        return LOS_NOK;
+    }
+
+    /* Periods left over from the previous run */
+    while (LOS_SemPend(g_voice.semID, 0) == LOS_OK) {
+    }
+
+    g_voice.config = *config;
+    g_voice.head = 0;
+    g_voice.tail = 0;
+    g_voice.periodHead = 0;
+    g_voice.periodTail = 0;
+    g_voice.frames = 0;
+    g_voice.dropped = 0;
+
+    audio_set_dmic_pin(config->dmicPins);
+    audio_init(DMIC_IN_TO_BUF, AUDIO_16K, MONO_BIT_16);
+
+    B91AudioStreamConfig stream = {
+        .buf = g_voice.buf,
+        .periodSamples = VOICE_PERIOD_SAMPLES,
+        .periods = VOICE_PERIODS,
+        .callback = VoicePeriodDone,
+        .arg = NULL,
+    };
+
+    g_voice.running = TRUE;
+
+    UINT32 ret = B91AudioStreamStart(B91_AUDIO_RX, &stream);
+    if (ret != LOS_OK) {
+        B91VoiceStop();
+    }
+
+    return ret;
+}
+
+VOID B91VoiceStop(VOID)
+{
+    if (!g_voice.running) {
+        return;
+    }
+
+    B91AudioStreamStop(B91_AUDIO_RX);
+    audio_codec_adc_power_down();
+    audio_clk_en(0, 0);
+
+    g_voice.running = FALSE;
+}
+
+VOID B91VoicePoll(VOID)
+{
+    UINT32 chunk = MIN((UINT32)g_voice.mtu - VOICE_ATT_HDR, VOICE_NOTIFY_MAX);
+    UINT32 tail = g_voice.tail;
+
+    if (!g_voice.running) {
+        return;
+    }
+
+    for (;;) {
+        UINT32 pending = __atomic_load_n(&g_voice.head, __ATOMIC_ACQUIRE) - tail;
+        if (pending == 0) {
+            break;
+        }
+
+        UINT32 len = MIN(pending, chunk);
+        VoiceFifoPeek(g_voice.packet, len);
+        if (blc_gatt_pushHandleValueNotify(g_voice.config.connHandle, g_voice.config.attHandle, g_voice.packet,
+                                           (int)len) != BLE_SUCCESS) {
+            /* stack TX FIFO full or link gone, retried on the next poll */
+            break;
+        }
+        tail += len;
+        __atomic_store_n(&g_voice.tail, tail, __ATOMIC_RELEASE);
+    }
+}
+
+VOID B91VoiceMtuSet(UINT16 mtu)
+{
+    g_voice.mtu = (mtu < VOICE_ATT_MTU_DEFAULT) ? VOICE_ATT_MTU_DEFAULT : mtu;
+}
+
+UINT32 B91VoiceStatsGet(B91VoiceStats *stats)
+{
+    B91AudioStreamStats audio;
+
+    if ((stats == NULL) || (B91AudioStreamStatsGet(B91_AUDIO_RX, &audio) != LOS_OK)) {
+        return LOS_NOK;
+    }
+
+    stats->frames = g_voice.frames;
+    stats->dropped = g_voice.dropped;
+    stats->overrun = audio.overrun;
+
+    return LOS_OK;
+}
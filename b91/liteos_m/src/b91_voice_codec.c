@@ -0,0 +1,247 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <b91_voice_codec.h>
+
+#define Q15_SHIFT          15
+#define HPF_FRAC           8
+#define AGC_GAIN_SHIFT     16
+#define AGC_APPLY_SHIFT    8 /* the Q16 gain is applied as Q8 to stay within 32 bits */
+#define AGC_GAIN_UNITY     (1U << AGC_GAIN_SHIFT)
+#define AGC_GAIN_MIN       (AGC_GAIN_UNITY / 16)
+#define AGC_MAX_GAIN_SHIFT 8 /* agcMaxGain is Q8 */
+#define AGC_RELEASE_SHIFT  3 /* the envelope decays by 1/8 of the gap per block */
+#define PCM_MAX            32767
+#define PCM_MIN            (-32768)
+#define ADPCM_INDEX_MAX    88
+#define ADPCM_SIGN         8
+#define ADPCM_NIBBLE       4
+#define ADPCM_NIBBLE_MASK  0xF
+#define BYTE_SHIFT         8
+#define BYTE_MASK          0xFF
+
+STATIC const INT16 g_adpcmSteps[ADPCM_INDEX_MAX + 1] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,    25,    28,
+    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,    88,    97,    107,   118,
+    130,   143,   157,   173,   190,   209,   230,   253,   279,   307,   337,   371,   408,   449,   494,
+    544,   598,   658,   724,   796,   876,   963,   1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+    2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,
+    9493,  10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+};
+
+STATIC const INT8 g_adpcmIndexAdjust[ADPCM_NIBBLE_MASK + 1] = {
+    -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8,
+};
+
+STATIC INLINE INT16 Sat16(INT32 v)
+{
+    return (v > PCM_MAX) ? PCM_MAX : ((v < PCM_MIN) ? PCM_MIN : (INT16)v);
+}
+
+UINT32 B91VoiceEncoderInit(B91VoiceEncoder *enc, const B91VoiceCodecConfig *config)
+{
+    if ((enc == NULL) || (config == NULL) ||
+        ((config->agcTarget != 0) && (config->agcMaxGain < (1U << AGC_MAX_GAIN_SHIFT)))) {
+        return LOS_NOK;
+    }
+
+    enc->config = *config;
+    enc->hpfX = 0;
+    enc->hpfY = 0;
+    enc->agcEnv = 0;
+    enc->agcGain = AGC_GAIN_UNITY;
+    enc->adpcm.predictor = 0;
+    enc->adpcm.index = 0;
+    enc->seq = 0;
+
+    return LOS_OK;
+}
+
+/* y[n] = x[n] - x[n - 1] + a * y[n - 1], the output state keeps fractional bits against limit cycles */
+VOID B91VoiceHpf(B91VoiceEncoder *enc, INT16 *pcm, UINT32 samples)
+{
+    INT32 coef = enc->config.hpfCoef;
+    INT32 x1 = enc->hpfX;
+    INT32 y1 = enc->hpfY;
+
+    if (coef == 0) {
+        return;
+    }
+
+    for (UINT32 i = 0; i < samples; ++i) {
+        INT32 x = pcm[i];
+        y1 = ((x - x1) << HPF_FRAC) + (INT32)(((INT64)coef * y1) >> Q15_SHIFT);
+        x1 = x;
+        pcm[i] = Sat16((y1 + (1 << (HPF_FRAC - 1))) >> HPF_FRAC);
+    }
+
+    enc->hpfX = x1;
+    enc->hpfY = y1;
+}
+
+STATIC UINT32 AgcTargetGain(const B91VoiceEncoder *enc)
+{
+    /* Below the noise floor the gain is held, so pauses are not amplified */
+    if ((enc->agcEnv == 0) || (enc->agcEnv < enc->config.agcNoiseFloor)) {
+        return enc->agcGain;
+    }
+
+    UINT32 gain = ((UINT32)enc->config.agcTarget << AGC_GAIN_SHIFT) / enc->agcEnv;
+    UINT32 gainMax = (UINT32)enc->config.agcMaxGain << (AGC_GAIN_SHIFT - AGC_MAX_GAIN_SHIFT);
+
+    return (gain > gainMax) ? gainMax : ((gain < AGC_GAIN_MIN) ? AGC_GAIN_MIN : gain);
+}
+
+VOID B91VoiceAgc(B91VoiceEncoder *enc, INT16 *pcm, UINT32 samples)
+{
+    UINT32 peak = 0;
+
+    if ((enc->config.agcTarget == 0) || (samples == 0)) {
+        return;
+    }
+
+    for (UINT32 i = 0; i < samples; ++i) {
+        UINT32 mag = (pcm[i] < 0) ? (UINT32)(-(INT32)pcm[i]) : (UINT32)pcm[i];
+        peak = (mag > peak) ? mag : peak;
+    }
+
+    if (peak > enc->agcEnv) {
+        enc->agcEnv = peak;
+    } else {
+        enc->agcEnv -= (enc->agcEnv - peak) >> AGC_RELEASE_SHIFT;
+    }
+
+    UINT32 target = AgcTargetGain(enc);
+    INT32 gain = (INT32)enc->agcGain;
+    INT32 step = 0;
+    if (target < enc->agcGain) {
+        gain = (INT32)target;
+    } else {
+        step = (INT32)(target - enc->agcGain) / (INT32)samples;
+    }
+
+    for (UINT32 i = 0; i < samples; ++i) {
+        gain += step;
+        pcm[i] = Sat16((pcm[i] * (gain >> AGC_APPLY_SHIFT)) >> (AGC_GAIN_SHIFT - AGC_APPLY_SHIFT));
+    }
+
+    enc->agcGain = (UINT32)gain;
+}
+
+/* Shared by encoder and decoder so both track the same predictor */
+STATIC INLINE VOID AdpcmUpdate(B91AdpcmState *state, UINT32 code)
+{
+    INT32 step = g_adpcmSteps[state->index];
+    INT32 diff = step >> 3;
+
+    if (code & 4) {
+        diff += step;
+    }
+    if (code & 2) {
+        diff += step >> 1;
+    }
+    if (code & 1) {
+        diff += step >> 2;
+    }
+
+    state->predictor = Sat16(state->predictor + ((code & ADPCM_SIGN) ? -diff : diff));
+
+    INT32 index = (INT32)state->index + g_adpcmIndexAdjust[code];
+    state->index = (index < 0) ? 0 : ((index > ADPCM_INDEX_MAX) ? ADPCM_INDEX_MAX : (UINT8)index);
+}
+
+STATIC INLINE UINT32 AdpcmEncodeSample(B91AdpcmState *state, INT16 sample)
+{
+    INT32 step = g_adpcmSteps[state->index];
+    INT32 diff = (INT32)sample - state->predictor;
+    UINT32 code = 0;
+
+    if (diff < 0) {
+        code = ADPCM_SIGN;
+        diff = -diff;
+    }
+    if (diff >= step) {
+        code |= 4;
+        diff -= step;
+    }
+    if (diff >= (step >> 1)) {
+        code |= 2;
+        diff -= step >> 1;
+    }
+    if (diff >= (step >> 2)) {
+        code |= 1;
+    }
+
+    AdpcmUpdate(state, code);
+
+    return code;
+}
+
+UINT32 B91AdpcmEncode(B91AdpcmState *state, const INT16 *pcm, UINT32 samples, UINT8 *out)
+{
+    UINT32 bytes = 0;
+
+    for (UINT32 i = 0; i < samples; i += 2) {
+        UINT32 code = AdpcmEncodeSample(state, pcm[i]);
+        if ((i + 1) < samples) {
+            code |= AdpcmEncodeSample(state, pcm[i + 1]) << ADPCM_NIBBLE;
+        }
+        out[bytes++] = (UINT8)code;
+    }
+
+    return bytes;
+}
+
+VOID B91AdpcmDecode(B91AdpcmState *state, const UINT8 *in, UINT32 samples, INT16 *pcm)
+{
+    for (UINT32 i = 0; i < samples; ++i) {
+        UINT32 code = (in[i / 2] >> ((i & 1) * ADPCM_NIBBLE)) & ADPCM_NIBBLE_MASK;
+        AdpcmUpdate(state, code);
+        pcm[i] = state->predictor;
+    }
+}
+
+UINT32 B91VoiceEncode(B91VoiceEncoder *enc, INT16 *pcm, UINT32 samples, UINT8 *out)
+{
+    B91VoiceHpf(enc, pcm, samples);
+    B91VoiceAgc(enc, pcm, samples);
+
+    out[0] = enc->seq++;
+    out[1] = (UINT8)((UINT16)enc->adpcm.predictor & BYTE_MASK);
+    out[2] = (UINT8)((UINT16)enc->adpcm.predictor >> BYTE_SHIFT);
+    out[3] = enc->adpcm.index;
+
+    return B91_VOICE_FRAME_HDR + B91AdpcmEncode(&enc->adpcm, pcm, samples, &out[B91_VOICE_FRAME_HDR]);
+}
+
+UINT32 B91VoiceFrameDecode(const UINT8 *frame, UINT32 len, INT16 *pcm)
+{
+    B91AdpcmState state;
+
+    if ((frame == NULL) || (len <= B91_VOICE_FRAME_HDR) || (frame[3] > ADPCM_INDEX_MAX)) {
+        return 0;
+    }
+
+    state.predictor = (INT16)(frame[1] | ((UINT16)frame[2] << BYTE_SHIFT));
+    state.index = frame[3];
+
+    UINT32 samples = (len - B91_VOICE_FRAME_HDR) * 2;
+    B91AdpcmDecode(&state, &frame[B91_VOICE_FRAME_HDR], samples, pcm);
+
+    return samples;
+}
@@ -0,0 +1,197 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <target_config.h>
+
+#include <los_interrupt.h>
+#include <los_sem.h>
+#include <los_task.h>
+
+#include <B91/stimer.h>
+
+#include <b91_work.h>
+
+#ifndef LOSCFG_TELINK_B91_WORK_QUEUE_SIZE
+#define LOSCFG_TELINK_B91_WORK_QUEUE_SIZE 32
+#endif /* LOSCFG_TELINK_B91_WORK_QUEUE_SIZE */
+
+#ifndef LOSCFG_TELINK_B91_WORK_TASK_PRIO
+#define LOSCFG_TELINK_B91_WORK_TASK_PRIO 1
+#endif /* LOSCFG_TELINK_B91_WORK_TASK_PRIO */
+
+#define WORK_QUEUE_SIZE      LOSCFG_TELINK_B91_WORK_QUEUE_SIZE
+#define WORK_QUEUE_MASK      (WORK_QUEUE_SIZE - 1)
+#define WORK_TASK_STACKSIZE  0x800
+#define WORK_TASK_PRIO       LOSCFG_TELINK_B91_WORK_TASK_PRIO
+#define WORK_TASK_NAME       "B91Work"
+
+#if (WORK_QUEUE_SIZE & WORK_QUEUE_MASK) != 0
+#error LOSCFG_TELINK_B91_WORK_QUEUE_SIZE must be a power of two
+#endif
+
+/*
+ * Bounded multi-producer queue with a sequence number per slot. A producer claims a
+ * slot by advancing enqueuePos with a compare-and-swap and publishes it by storing
+ * pos + 1 into the slot sequence; the work task is the only consumer and hands the
+ * slot back by storing pos + WORK_QUEUE_SIZE. Producers never wait for each other,
+ * so an interrupt preempting a task halfway through a post is harmless.
+ */
+typedef struct {
+    UINT32 seq;
+    B91WorkFunc func;
+    UINTPTR arg;
+    UINT32 postTick;
+} WorkSlot;
+
+STATIC struct {
+    WorkSlot slots[WORK_QUEUE_SIZE];
+    UINT32 enqueuePos;
+    UINT32 dequeuePos;
+    UINT32 semID;
+    BOOL ready;
+    UINT32 dropped;
+    UINT32 executed;
+    UINT32 maxDepth;
+    UINT32 maxLatency;
+    UINT64 totalLatency;
+} g_work;
+
+STATIC BOOL WorkTake(WorkSlot *item)
+{
+    UINT32 pos = g_work.dequeuePos;
+    WorkSlot *slot = &g_work.slots[pos & WORK_QUEUE_MASK];
+
+    if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != (pos + 1)) {
+        return FALSE;
+    }
+
+    *item = *slot;
+    __atomic_store_n(&slot->seq, pos + WORK_QUEUE_SIZE, __ATOMIC_RELEASE);
+    g_work.dequeuePos = pos + 1;
+
+    return TRUE;
+}
+
+STATIC VOID WorkAccount(UINT32 postTick)
+{
+    UINT32 latency = stimer_get_tick() - postTick;
+    UINT32 depth = __atomic_load_n(&g_work.enqueuePos, __ATOMIC_RELAXED) - g_work.dequeuePos;
+
+    if (latency > g_work.maxLatency) {
+        g_work.maxLatency = latency;
+    }
+    if (depth > g_work.maxDepth) {
+        g_work.maxDepth = depth;
+    }
+    g_work.totalLatency += latency;
+    ++g_work.executed;
+}
+
+STATIC VOID WorkTask(VOID)
+{
+    WorkSlot item;
+
+    while (1) {
+        (VOID)LOS_SemPend(g_work.semID, LOS_WAIT_FOREVER);
+
+        while (WorkTake(&item)) {
+            WorkAccount(item.postTick);
+            item.func(item.arg);
+        }
+    }
+}
+
+UINT32 B91WorkInit(VOID)
+{
+    UINT32 taskID;
+    TSK_INIT_PARAM_S task = {0};
+
+    for (UINT32 i = 0; i < WORK_QUEUE_SIZE; ++i) {
+        g_work.slots[i].seq = i;
+    }
+
+    UINT32 ret = LOS_BinarySemCreate(0, &g_work.semID);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    task.pfnTaskEntry = (TSK_ENTRY_FUNC)WorkTask;
+    task.uwStackSize = WORK_TASK_STACKSIZE;
+    task.pcName = WORK_TASK_NAME;
+    task.usTaskPrio = WORK_TASK_PRIO;
+
+    ret = LOS_TaskCreate(&taskID, &task);
+    if (ret == LOS_OK) {
+        g_work.ready = TRUE;
+    }
+
+    return ret;
+}
+
+_attribute_ram_code_ UINT32 B91WorkPost(B91WorkFunc func, UINTPTR arg)
+{
+    WorkSlot *slot = NULL;
+    UINT32 pos = __atomic_load_n(&g_work.enqueuePos, __ATOMIC_RELAXED);
+
+    if (!g_work.ready || (func == NULL)) {
+        return LOS_NOK;
+    }
+
+    while (1) {
+        slot = &g_work.slots[pos & WORK_QUEUE_MASK];
+        INT32 diff = (INT32)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&g_work.enqueuePos, &pos, pos + 1, TRUE, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            __atomic_fetch_add(&g_work.dropped, 1, __ATOMIC_RELAXED);
+            return LOS_NOK;
+        } else {
+            pos = __atomic_load_n(&g_work.enqueuePos, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->func = func;
+    slot->arg = arg;
+    slot->postTick = stimer_get_tick();
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+
+    (VOID)LOS_SemPost(g_work.semID);
+
+    return LOS_OK;
+}
+
+VOID B91WorkStatsGet(B91WorkStats *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+
+    UINT32 intSave = LOS_IntLock();
+
+    stats->executed = g_work.executed;
+    stats->dropped = g_work.dropped;
+    stats->maxDepth = g_work.maxDepth;
+    stats->maxLatencyUs = g_work.maxLatency / SYSTEM_TIMER_TICK_1US;
+    stats->avgLatencyUs =
+        (g_work.executed != 0) ? (UINT32)(g_work.totalLatency / g_work.executed / SYSTEM_TIMER_TICK_1US) : 0;
+
+    LOS_IntRestore(intSave);
+}
@@ -0,0 +1,544 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+
+#include <string.h>
+
+#include <los_mux.h>
+#include <los_task.h>
+#include <los_tick.h>
+
+#include <lfs.h>
+
+#include <B91/clock.h>
+
+#include <b91_spi.h>
+#include <b91_xflash.h>
+
+#ifndef LOSCFG_TELINK_B91_XFLASH_SIZE
+#define LOSCFG_TELINK_B91_XFLASH_SIZE 8192
+#endif /* LOSCFG_TELINK_B91_XFLASH_SIZE */
+
+#ifndef LOSCFG_TELINK_B91_XFLASH_CLK_DIV
+#define LOSCFG_TELINK_B91_XFLASH_CLK_DIV 0
+#endif /* LOSCFG_TELINK_B91_XFLASH_CLK_DIV */
+
+#define XFLASH_SIZE       (LOSCFG_TELINK_B91_XFLASH_SIZE * 1024)
+#define XFLASH_ADDR_LEN   3
+#define XFLASH_BOUNCE     256
+#define XFLASH_WORD_MASK  3
+#define XFLASH_SPIN_POLLS 16
+
+/* Both device types */
+#define XFLASH_CMD_RESET_ENABLE 0x66
+#define XFLASH_CMD_RESET        0x99
+
+/* Winbond/GigaDevice command set, quad output read and quad input page program */
+#define NOR_CMD_WRITE_ENABLE  0x06
+#define NOR_CMD_READ_STATUS1  0x05
+#define NOR_CMD_READ_STATUS2  0x35
+#define NOR_CMD_WRITE_STATUS2 0x31
+#define NOR_CMD_READ_ID       0x9F
+#define NOR_CMD_QUAD_READ     0x6B
+#define NOR_CMD_QUAD_PROGRAM  0x32
+#define NOR_CMD_SECTOR_ERASE  0x20
+
+#define NOR_STATUS1_WIP   BIT(0)
+#define NOR_STATUS2_QE    BIT(1)
+#define NOR_READ_DUMMY    8
+#define NOR_PAGE_SIZE     256
+#define NOR_ID_LEN        3
+#define NOR_ID_NONE       0xFFFFFF
+#define NOR_PROG_TIMEOUT  10   /* ms */
+#define NOR_ERASE_TIMEOUT 500  /* ms */
+#define NOR_WRSR_TIMEOUT  50   /* ms */
+
+/* APS6404 style PSRAM, used in QPI mode where every phase runs on four lines */
+#define PSRAM_CMD_ENTER_QUAD   0x35
+#define PSRAM_CMD_EXIT_QUAD    0xF5
+#define PSRAM_CMD_QUAD_READ    0xEB
+#define PSRAM_CMD_QUAD_WRITE   0x38
+#define PSRAM_READ_WAIT        6
+
+/*
+ * CE# may stay low for at most 8 us so the device can refresh. A QPI read takes two
+ * clocks per byte after the command, address and wait cycles. The burst is the largest
+ * power of two that fits at the current HSPI clock, which may drop through DVFS, and
+ * so never crosses the 1 KB wrap boundary either.
+ */
+#define PSRAM_CE_MAX_NS       8000
+#define PSRAM_BURST_OVERHEAD  (2 + 2 * XFLASH_ADDR_LEN + PSRAM_READ_WAIT) /* clocks */
+#define PSRAM_BURST_MAX       1024
+#define PSRAM_CLOCKS_PER_BYTE 2
+
+#define HZ_IN_KHZ  1000
+#define NS_IN_MS   (1000 * 1000)
+
+#if defined(LOSCFG_TELINK_B91_XFLASH_PA_PINS)
+#define XFLASH_CS HSPI_CSN_PA1
+#else /* LOSCFG_TELINK_B91_XFLASH_PA_PINS */
+#define XFLASH_CS HSPI_CSN_PB6
+#endif /* LOSCFG_TELINK_B91_XFLASH_PA_PINS */
+
+#define READ_SIZE      16
+#define PROG_SIZE      16
+#define BLOCK_SIZE     B91_XFLASH_SECTOR_SIZE
+#define BLOCK_COUNT    (XFLASH_SIZE / BLOCK_SIZE)
+#define CACHE_SIZE     512
+#define LOOKAHEAD_SIZE 128
+#if defined(LOSCFG_TELINK_B91_XFLASH_PSRAM)
+#define BLOCK_CYCLES -1
+#else /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+#define BLOCK_CYCLES 500
+#endif /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+STATIC struct {
+    UINT32 mutex;
+    BOOL ready;
+    BOOL qpi;
+    UINT32 reg;                   /* status and ID bytes, word aligned for the DMA */
+    UINT32 bounce[XFLASH_BOUNCE / sizeof(UINT32)]; /* for buffers the DMA cannot reach */
+} g_xflash;
+
+STATIC VOID XflashXferInit(B91SpiXfer *xfer, UINT8 cmd)
+{
+    (VOID)memset(xfer, 0, sizeof(*xfer));
+    xfer->spi = HSPI_MODULE;
+    xfer->csPin = XFLASH_CS;
+    xfer->mode = SPI_MODE0;
+    xfer->cmd = cmd;
+    xfer->flags = B91_SPI_XFER_CMD;
+#if defined(LOSCFG_TELINK_B91_XFLASH_PSRAM)
+    if (g_xflash.qpi) {
+        xfer->ioMode = HSPI_QUAD_MODE;
+        xfer->flags |= B91_SPI_XFER_WIDE;
+    } else {
+        xfer->ioMode = SPI_SINGLE_MODE;
+    }
+#else  /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+    xfer->ioMode = SPI_SINGLE_MODE;
+#endif /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+}
+
+STATIC VOID XflashXferAddr(B91SpiXfer *xfer, UINT32 addr)
+{
+    xfer->flags |= B91_SPI_XFER_ADDR;
+    xfer->addr = addr;
+    xfer->addrLen = XFLASH_ADDR_LEN;
+}
+
+STATIC UINT32 XflashCmd(UINT8 cmd)
+{
+    B91SpiXfer xfer;
+
+    XflashXferInit(&xfer, cmd);
+    return B91SpiTransfer(&xfer);
+}
+
+STATIC UINT32 XflashRegRead(UINT8 cmd, UINT32 len)
+{
+    B91SpiXfer xfer;
+
+    g_xflash.reg = 0;
+    XflashXferInit(&xfer, cmd);
+    xfer.rx = (UINT8 *)&g_xflash.reg;
+    xfer.rxLen = len;
+    return B91SpiTransfer(&xfer);
+}
+
+#if defined(LOSCFG_TELINK_B91_XFLASH_PSRAM)
+STATIC UINT32 PsramBurst(VOID)
+{
+    UINT32 spiKhz = B91SpiClockGet(HSPI_MODULE) / HZ_IN_KHZ;
+    UINT32 clocks = spiKhz * PSRAM_CE_MAX_NS / NS_IN_MS;
+    UINT32 burst = PSRAM_BURST_MAX;
+
+    while ((burst > 1) && ((PSRAM_BURST_OVERHEAD + burst * PSRAM_CLOCKS_PER_BYTE) > clocks)) {
+        burst >>= 1;
+    }
+
+    return burst;
+}
+#endif /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+
+/* Chunk length at addr: PSRAM bursts stop at burst boundaries, NOR programs at pages */
+STATIC UINT32 XflashChunk(UINT32 addr, UINT32 size, BOOL write)
+{
+#if defined(LOSCFG_TELINK_B91_XFLASH_PSRAM)
+    UINT32 burst = PsramBurst();
+
+    (VOID)write;
+    return MIN(size, burst - (addr % burst));
+#else  /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+    return write ? MIN(size, NOR_PAGE_SIZE - (addr % NOR_PAGE_SIZE)) : size;
+#endif /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+}
+
+#if !defined(LOSCFG_TELINK_B91_XFLASH_PSRAM)
+/* Spin on short operations, then give the CPU away between polls */
+STATIC UINT32 XflashWaitReady(UINT32 timeoutMs)
+{
+    UINT64 deadline = LOS_TickCountGet() + LOS_MS2Tick(timeoutMs);
+
+    for (UINT32 polls = 0;; ++polls) {
+        UINT32 ret = XflashRegRead(NOR_CMD_READ_STATUS1, 1);
+        if (ret != LOS_OK) {
+            return ret;
+        }
+        if (!(g_xflash.reg & NOR_STATUS1_WIP)) {
+            return LOS_OK;
+        }
+        if (LOS_TickCountGet() > deadline) {
+            return LOS_NOK;
+        }
+        if (polls >= XFLASH_SPIN_POLLS) {
+            (VOID)LOS_TaskDelay(1);
+        }
+    }
+}
+
+STATIC UINT32 XflashQuadEnable(VOID)
+{
+    B91SpiXfer xfer;
+
+    UINT32 ret = XflashRegRead(NOR_CMD_READ_STATUS2, 1);
+    if ((ret != LOS_OK) || (g_xflash.reg & NOR_STATUS2_QE)) {
+        return ret;
+    }
+
+    ret = XflashCmd(NOR_CMD_WRITE_ENABLE);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    g_xflash.reg |= NOR_STATUS2_QE;
+    XflashXferInit(&xfer, NOR_CMD_WRITE_STATUS2);
+    xfer.tx = (const UINT8 *)&g_xflash.reg;
+    xfer.txLen = 1;
+    ret = B91SpiTransfer(&xfer);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    return XflashWaitReady(NOR_WRSR_TIMEOUT);
+}
+#endif /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+
+STATIC UINT32 XflashDeviceInit(VOID)
+{
+#if defined(LOSCFG_TELINK_B91_XFLASH_PSRAM)
+    /* A PSRAM still in QPI mode from before a warm reset ignores single line commands */
+    g_xflash.qpi = TRUE;
+    (VOID)XflashCmd(PSRAM_CMD_EXIT_QUAD);
+    g_xflash.qpi = FALSE;
+#endif /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+
+    UINT32 ret = XflashCmd(XFLASH_CMD_RESET_ENABLE);
+    if (ret == LOS_OK) {
+        ret = XflashCmd(XFLASH_CMD_RESET);
+    }
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+#if defined(LOSCFG_TELINK_B91_XFLASH_PSRAM)
+    ret = XflashCmd(PSRAM_CMD_ENTER_QUAD);
+    g_xflash.qpi = (ret == LOS_OK);
+    return ret;
+#else  /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+    ret = XflashWaitReady(NOR_WRSR_TIMEOUT);
+    if (ret == LOS_OK) {
+        ret = XflashRegRead(NOR_CMD_READ_ID, NOR_ID_LEN);
+    }
+    if ((ret != LOS_OK) || (g_xflash.reg == 0) || (g_xflash.reg == NOR_ID_NONE)) {
+        return LOS_NOK;
+    }
+
+    return XflashQuadEnable();
+#endif /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+}
+
+UINT32 B91XflashInit(VOID)
+{
+    hspi_pin_config_t pins = {
+#if defined(LOSCFG_TELINK_B91_XFLASH_PA_PINS)
+        .hspi_clk_pin = HSPI_CLK_PA2,
+        .hspi_csn_pin = HSPI_CSN_PA1,
+        .hspi_mosi_io0_pin = HSPI_MOSI_IO0_PA4,
+        .hspi_miso_io1_pin = HSPI_MISO_IO1_PA3,
+#else  /* LOSCFG_TELINK_B91_XFLASH_PA_PINS */
+        .hspi_clk_pin = HSPI_CLK_PB4,
+        .hspi_csn_pin = HSPI_CSN_PB6,
+        .hspi_mosi_io0_pin = HSPI_MOSI_IO0_PB3,
+        .hspi_miso_io1_pin = HSPI_MISO_IO1_PB2,
+#endif /* LOSCFG_TELINK_B91_XFLASH_PA_PINS */
+        .hspi_wp_io2_pin = HSPI_WP_IO2_PB1,
+        .hspi_hold_io3_pin = HSPI_HOLD_IO3_PB0,
+    };
+
+    if (g_xflash.ready) {
+        return LOS_OK;
+    }
+
+    UINT32 ret = LOS_MuxCreate(&g_xflash.mutex);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    hspi_set_pin(&pins);
+    ret = B91SpiInit(HSPI_MODULE, LOSCFG_TELINK_B91_XFLASH_CLK_DIV);
+    if (ret == LOS_OK) {
+        ret = XflashDeviceInit();
+    }
+    if (ret != LOS_OK) {
+        (VOID)LOS_MuxDelete(g_xflash.mutex);
+        return ret;
+    }
+
+    g_xflash.ready = TRUE;
+
+    return LOS_OK;
+}
+
+STATIC UINT32 XflashReadChunk(UINT32 addr, UINT8 *buf, UINT32 len)
+{
+    B91SpiXfer xfer;
+
+#if defined(LOSCFG_TELINK_B91_XFLASH_PSRAM)
+    XflashXferInit(&xfer, PSRAM_CMD_QUAD_READ);
+    xfer.dummy = PSRAM_READ_WAIT;
+#else  /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+    XflashXferInit(&xfer, NOR_CMD_QUAD_READ);
+    xfer.ioMode = HSPI_QUAD_MODE;
+    xfer.dummy = NOR_READ_DUMMY;
+#endif /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+    XflashXferAddr(&xfer, addr);
+    xfer.rx = buf;
+    xfer.rxLen = len;
+
+    return B91SpiTransfer(&xfer);
+}
+
+STATIC UINT32 XflashWriteChunk(UINT32 addr, const UINT8 *buf, UINT32 len)
+{
+    B91SpiXfer xfer;
+
+#if defined(LOSCFG_TELINK_B91_XFLASH_PSRAM)
+    XflashXferInit(&xfer, PSRAM_CMD_QUAD_WRITE);
+#else  /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+    UINT32 ret = XflashCmd(NOR_CMD_WRITE_ENABLE);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    XflashXferInit(&xfer, NOR_CMD_QUAD_PROGRAM);
+    xfer.ioMode = HSPI_QUAD_MODE;
+#endif /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+    XflashXferAddr(&xfer, addr);
+    xfer.tx = buf;
+    xfer.txLen = len;
+
+#if defined(LOSCFG_TELINK_B91_XFLASH_PSRAM)
+    return B91SpiTransfer(&xfer);
+#else  /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+    ret = B91SpiTransfer(&xfer);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    return XflashWaitReady(NOR_PROG_TIMEOUT);
+#endif /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+}
+
+STATIC BOOL XflashRangeValid(UINT32 addr, UINT32 size)
+{
+    return g_xflash.ready && (addr < XFLASH_SIZE) && (size <= (XFLASH_SIZE - addr));
+}
+
+UINT32 B91XflashRead(UINT32 addr, VOID *buf, UINT32 size)
+{
+    UINT8 *out = (UINT8 *)buf;
+    UINT32 ret = LOS_OK;
+
+    if ((buf == NULL) || !XflashRangeValid(addr, size)) {
+        return LOS_NOK;
+    }
+
+    (VOID)LOS_MuxPend(g_xflash.mutex, LOS_WAIT_FOREVER);
+
+    while ((size != 0) && (ret == LOS_OK)) {
+        BOOL bounce = (((UINTPTR)out & XFLASH_WORD_MASK) != 0);
+        UINT32 len = XflashChunk(addr, bounce ? MIN(size, XFLASH_BOUNCE) : size, FALSE);
+
+        ret = XflashReadChunk(addr, bounce ? (UINT8 *)g_xflash.bounce : out, len);
+        if (bounce) {
+            (VOID)memcpy(out, g_xflash.bounce, len);
+        }
+
+        addr += len;
+        out += len;
+        size -= len;
+    }
+
+    (VOID)LOS_MuxPost(g_xflash.mutex);
+
+    return ret;
+}
+
+UINT32 B91XflashWrite(UINT32 addr, const VOID *buf, UINT32 size)
+{
+    const UINT8 *in = (const UINT8 *)buf;
+    UINT32 ret = LOS_OK;
+
+    if ((buf == NULL) || !XflashRangeValid(addr, size)) {
+        return LOS_NOK;
+    }
+
+    (VOID)LOS_MuxPend(g_xflash.mutex, LOS_WAIT_FOREVER);
+
+    while ((size != 0) && (ret == LOS_OK)) {
+        BOOL bounce = (((UINTPTR)in & XFLASH_WORD_MASK) != 0);
+        UINT32 len = XflashChunk(addr, bounce ? MIN(size, XFLASH_BOUNCE) : size, TRUE);
+
+        if (bounce) {
+            (VOID)memcpy(g_xflash.bounce, in, len);
+        }
+        ret = XflashWriteChunk(addr, bounce ? (const UINT8 *)g_xflash.bounce : in, len);
+
+        addr += len;
+        in += len;
+        size -= len;
+    }
+
+    (VOID)LOS_MuxPost(g_xflash.mutex);
+
+    return ret;
+}
+
+UINT32 B91XflashErase(UINT32 addr)
+{
+    if (!XflashRangeValid(addr, 1)) {
+        return LOS_NOK;
+    }
+
+#if defined(LOSCFG_TELINK_B91_XFLASH_PSRAM)
+    return LOS_OK;
+#else  /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+    B91SpiXfer xfer;
+
+    (VOID)LOS_MuxPend(g_xflash.mutex, LOS_WAIT_FOREVER);
+
+    UINT32 ret = XflashCmd(NOR_CMD_WRITE_ENABLE);
+    if (ret == LOS_OK) {
+        XflashXferInit(&xfer, NOR_CMD_SECTOR_ERASE);
+        XflashXferAddr(&xfer, addr & ~(B91_XFLASH_SECTOR_SIZE - 1));
+        ret = B91SpiTransfer(&xfer);
+    }
+    if (ret == LOS_OK) {
+        ret = XflashWaitReady(NOR_ERASE_TIMEOUT);
+    }
+
+    (VOID)LOS_MuxPost(g_xflash.mutex);
+
+    return ret;
+#endif /* LOSCFG_TELINK_B91_XFLASH_PSRAM */
+}
+
+UINT32 B91XflashSizeGet(VOID)
+{
+    return XFLASH_SIZE;
+}
+
+#if defined(LFS_THREADSAFE)
+static uint32_t g_xlfsMutex;
+#endif /* LFS_THREADSAFE */
+
+static int XlfsRead(const struct lfs_config *cfg, lfs_block_t block, lfs_off_t off, void *buffer, lfs_size_t size)
+{
+    uint32_t addr = block * (cfg->block_size) + off;
+
+    return (B91XflashRead(addr, buffer, size) == LOS_OK) ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+static int XlfsProg(const struct lfs_config *cfg, lfs_block_t block, lfs_off_t off, const void *buffer,
+                    lfs_size_t size)
+{
+    uint32_t addr = block * (cfg->block_size) + off;
+
+    return (B91XflashWrite(addr, buffer, size) == LOS_OK) ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+static int XlfsErase(const struct lfs_config *cfg, lfs_block_t block)
+{
+    uint32_t addr = block * (cfg->block_size);
+
+    return (B91XflashErase(addr) == LOS_OK) ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+static int XlfsSync(const struct lfs_config *cfg)
+{
+    (void)cfg;
+    return LFS_ERR_OK;
+}
+
+#if defined(LFS_THREADSAFE)
+static int XlfsLock(const struct lfs_config *conf)
+{
+    (void)conf;
+    (void)LOS_MuxPend(g_xlfsMutex, LOS_WAIT_FOREVER);
+    return LFS_ERR_OK;
+}
+
+static int XlfsUnlock(const struct lfs_config *conf)
+{
+    (void)conf;
+    (void)LOS_MuxPost(g_xlfsMutex);
+    return LFS_ERR_OK;
+}
+#endif /* LFS_THREADSAFE */
+
+static struct lfs_config g_xlfsConfig = {
+    // block device operations
+    .context = NULL,
+    .read = XlfsRead,
+    .prog = XlfsProg,
+    .erase = XlfsErase,
+    .sync = XlfsSync,
+#if defined(LFS_THREADSAFE)
+    .lock = XlfsLock,
+    .unlock = XlfsUnlock,
+#endif /* LFS_THREADSAFE */
+    // block device configuration
+    .read_size = READ_SIZE,
+    .prog_size = PROG_SIZE,
+    .block_size = BLOCK_SIZE,
+    .block_count = BLOCK_COUNT,
+    .cache_size = CACHE_SIZE,
+    .lookahead_size = LOOKAHEAD_SIZE,
+    .block_cycles = BLOCK_CYCLES,
+};
+
+struct lfs_config *B91XflashLfsConfigGet(VOID)
+{
+#if defined(LFS_THREADSAFE)
+    (void)LOS_MuxCreate(&g_xlfsMutex);
+#endif /* LFS_THREADSAFE */
+    return &g_xlfsConfig;
+}
@@ -21,6 +21,8 @@
 #include <nds_intrinsic.h>
 #include <stdint.h>
 
+#include <b91_stack_monitor.h>
+
 #define MCACHE_CTL_ICACHE 1
 #define MCACHE_CTL_DCACHE 2
 
@@ -41,8 +43,6 @@ extern InitFunc __init_array_end[] __attribute__((weak));
 extern InitFunc __fini_array_start[] __attribute__((weak));
 extern InitFunc __fini_array_end[] __attribute__((weak));
 
-#define STACK_MAGIC UINT32_C(0xDEADBEEF)
-
 STATIC VOID BoardConfigInnerSafe(VOID);
 
 #ifdef __GNUC__
@@ -90,7 +90,7 @@ __attribute__((naked)) void BoardConfig(void)
     __asm__ volatile("fence.i");
 
     for (UINT32 *p = __int_stack_start; p < __int_stack_end; ++p) {
-        *p = STACK_MAGIC;
+        *p = B91_INT_STACK_MAGIC;
     }
 
     __asm__ volatile("j BoardConfigInner");
@@ -38,6 +38,46 @@
 #include <b91_irq.h>
 #include <system_b91.h>
 
+#if defined(LOSCFG_TELINK_B91_CONSOLE_DMA)
+#include <b91_console.h>
+#endif /* LOSCFG_TELINK_B91_CONSOLE_DMA */
+
+#if defined(LOSCFG_TELINK_B91_HILOG_BINARY)
+#include <b91_binlog.h>
+#endif /* LOSCFG_TELINK_B91_HILOG_BINARY */
+
+#if defined(LOSCFG_TELINK_B91_STACK_MONITOR)
+#include <b91_stack_monitor.h>
+#endif /* LOSCFG_TELINK_B91_STACK_MONITOR */
+
+#if defined(LOSCFG_TELINK_B91_DLM_HEAP)
+#include <b91_mem.h>
+#endif /* LOSCFG_TELINK_B91_DLM_HEAP */
+
+#if defined(LOSCFG_TELINK_B91_DVFS)
+#include <b91_dvfs.h>
+#endif /* LOSCFG_TELINK_B91_DVFS */
+
+#if defined(LOSCFG_TELINK_B91_TICKLESS)
+#include <b91_pm.h>
+#endif /* LOSCFG_TELINK_B91_TICKLESS */
+
+#if defined(LOSCFG_TELINK_B91_WORK)
+#include <b91_work.h>
+#endif /* LOSCFG_TELINK_B91_WORK */
+
+#if defined(LOSCFG_TELINK_B91_PBUF)
+#include <b91_pbuf.h>
+#endif /* LOSCFG_TELINK_B91_PBUF */
+
+#if defined(LOSCFG_TELINK_B91_XFLASH)
+#include <b91_xflash.h>
+#endif /* LOSCFG_TELINK_B91_XFLASH */
+
+#if defined(LOSCFG_TELINK_B91_SENSOR_SCHED)
+#include <b91_sensor.h>
+#endif /* LOSCFG_TELINK_B91_SENSOR_SCHED */
+
 #include <B91/clock.h>
 #include <B91/gpio.h>
 #include <B91/uart.h>
@@ -88,6 +128,18 @@ STATIC VOID LittlefsInit(VOID)
 
     res = mkdir(DIR_DATA, DIR_PERMISSIONS);
     printf("mkdir = %d\r\n", res);
+
+#if defined(LOSCFG_TELINK_B91_XFLASH)
+#define DIR_XDATA "/xdata"
+
+    if (B91XflashInit() != LOS_OK) {
+        printf("External flash not found\r\n");
+        return;
+    }
+
+    res = mount(PAR_DATA, DIR_XDATA, "littlefs", 0, B91XflashLfsConfigGet());
+    printf("mount %s = %d\r\n", DIR_XDATA, res);
+#endif /* LOSCFG_TELINK_B91_XFLASH */
 }
 
 VOID IoTWatchDogKick(VOID)
@@ -119,6 +171,12 @@ UINT32 LosAppInit(VOID)
         printf("Create Task failed! ERROR: 0x%x\r\n", ret);
     }
 
+#if defined(LOSCFG_TELINK_B91_STACK_MONITOR)
+    if (B91StackMonitorStart(LOSCFG_TELINK_B91_STACK_MONITOR_PERIOD) != LOS_OK) {
+        printf("Create StackMonitor task failed!\r\n");
+    }
+#endif /* LOSCFG_TELINK_B91_STACK_MONITOR */
+
     return ret;
 }
 
@@ -136,6 +194,33 @@ __attribute__((weak)) void *_sbrk(ptrdiff_t incr)
     return (void *)(curbrk - incr);
 }
 
+#if defined(LOSCFG_TELINK_B91_DVFS)
+STATIC VOID UsartClockChanged(B91DvfsEvent event, VOID *arg)
+{
+    unsigned short div;
+    unsigned char bwpc;
+
+    (VOID)arg;
+
+    if (event == B91_DVFS_PRE_CHANGE) {
+#if defined(LOSCFG_TELINK_B91_CONSOLE_DMA)
+        B91ConsoleHold();
+#else  /* LOSCFG_TELINK_B91_CONSOLE_DMA */
+        while (uart_tx_is_busy(DEBUG_UART_PORT)) {
+        }
+#endif /* LOSCFG_TELINK_B91_CONSOLE_DMA */
+        return;
+    }
+
+    uart_cal_div_and_bwpc(DEBUG_UART_BAUDRATE, sys_clk.pclk * HZ_IN_MHZ, &div, &bwpc);
+    telink_b91_uart_init(DEBUG_UART_PORT, div, bwpc, DEBUG_UART_PARITY, DEBUG_UART_STOP_BITS);
+
+#if defined(LOSCFG_TELINK_B91_CONSOLE_DMA)
+    B91ConsoleResume();
+#endif /* LOSCFG_TELINK_B91_CONSOLE_DMA */
+}
+#endif /* LOSCFG_TELINK_B91_DVFS */
+
 VOID UsartInit(VOID)
 {
     unsigned short div;
@@ -146,6 +231,18 @@ VOID UsartInit(VOID)
     uart_cal_div_and_bwpc(DEBUG_UART_BAUDRATE, sys_clk.pclk * HZ_IN_MHZ, &div, &bwpc);
     telink_b91_uart_init(DEBUG_UART_PORT, div, bwpc, DEBUG_UART_PARITY, DEBUG_UART_STOP_BITS);
     uart_rx_irq_trig_level(DEBUG_UART_PORT, 1);
+
+#if defined(LOSCFG_TELINK_B91_CONSOLE_DMA)
+    if (B91ConsoleInit(DEBUG_UART_PORT) != LOS_OK) {
+        printf("B91ConsoleInit failed!\r\n");
+    }
+#endif /* LOSCFG_TELINK_B91_CONSOLE_DMA */
+
+#if defined(LOSCFG_TELINK_B91_DVFS)
+    if (B91DvfsNotifierRegister(UsartClockChanged, NULL) != LOS_OK) {
+        printf("Console UART is not DVFS aware!\r\n");
+    }
+#endif /* LOSCFG_TELINK_B91_DVFS */
 }
 
 int _write(int handle, char *data, int size)
@@ -159,7 +256,11 @@ int _write(int handle, char *data, int size)
     switch (handle) {
         case STDOUT_FILENO:
         case STDERR_FILENO: {
-            uart_send(UART0, (unsigned char *)data, size);
+#if defined(LOSCFG_TELINK_B91_CONSOLE_DMA)
+            (VOID)B91ConsoleWrite(data, size);
+#else  /* LOSCFG_TELINK_B91_CONSOLE_DMA */
+            uart_send(DEBUG_UART_PORT, (unsigned char *)data, size);
+#endif /* LOSCFG_TELINK_B91_CONSOLE_DMA */
             ret = size;
             break;
         }
@@ -174,9 +275,13 @@ int _write(int handle, char *data, int size)
 static boolean hilog(const HiLogContent *hilogContent, uint32 len)
 {
     UNUSED(len);
+#if defined(LOSCFG_TELINK_B91_HILOG_BINARY)
+    (VOID)B91BinLogWrite(hilogContent);
+#else  /* LOSCFG_TELINK_B91_HILOG_BINARY */
     static char buf[256];
     int32 bytes = LogContentFmt(buf, sizeof(buf), (const uint8 *)hilogContent);
     _write(STDOUT_FILENO, buf, bytes);
+#endif /* LOSCFG_TELINK_B91_HILOG_BINARY */
     return TRUE;
 }
 
@@ -184,6 +289,9 @@ __attribute__((noreturn)) void __assert_func(const char *file, int line, const c
 {
     printf("Assertion failed: %s (%s: %s: %d)\r\n", expr, file, func, line);
     fflush(NULL);
+#if defined(LOSCFG_TELINK_B91_CONSOLE_DMA)
+    B91ConsolePanicFlush();
+#endif /* LOSCFG_TELINK_B91_CONSOLE_DMA */
     abort();
 }
 
@@ -221,6 +329,42 @@ STATIC INT32 SafeMain(VOID)
         goto START_FAILED;
     }
 
+#if defined(LOSCFG_TELINK_B91_DVFS)
+    ret = B91DvfsInit();
+    if (ret != LOS_OK) {
+        printf("B91DvfsInit failed! ERROR: 0x%x\r\n", ret);
+    }
+#endif /* LOSCFG_TELINK_B91_DVFS */
+
+#if defined(LOSCFG_TELINK_B91_DLM_HEAP)
+    B91MemInit();
+#endif /* LOSCFG_TELINK_B91_DLM_HEAP */
+
+#if defined(LOSCFG_TELINK_B91_PBUF)
+    B91PbufInit();
+#endif /* LOSCFG_TELINK_B91_PBUF */
+
+#if defined(LOSCFG_TELINK_B91_TICKLESS)
+    ret = B91PmInit();
+    if (ret != LOS_OK) {
+        printf("B91PmInit failed! ERROR: 0x%x\r\n", ret);
+    }
+#endif /* LOSCFG_TELINK_B91_TICKLESS */
+
+#if defined(LOSCFG_TELINK_B91_WORK)
+    ret = B91WorkInit();
+    if (ret != LOS_OK) {
+        printf("B91WorkInit failed! ERROR: 0x%x\r\n", ret);
+    }
+#endif /* LOSCFG_TELINK_B91_WORK */
+
+#if defined(LOSCFG_TELINK_B91_SENSOR_SCHED)
+    ret = B91SensorSchedInit();
+    if (ret != LOS_OK) {
+        printf("B91SensorSchedInit failed! ERROR: 0x%x\r\n", ret);
+    }
+#endif /* LOSCFG_TELINK_B91_SENSOR_SCHED */
+
     if (DeviceManagerStart()) {
         printf("DeviceManagerStart failed!\r\n");
     }
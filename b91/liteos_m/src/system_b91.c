@@ -29,6 +29,8 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#define HZ_IN_MHZ (1000 * 1000)
+
 /* Define 48 MHz and 96 MHz CCLK clock options (not present in HAL) */
 #define CCLK_64M_HCLK_32M_PCLK_16M                                                                                    \
     clock_init(PLL_CLK_192M, PAD_PLL_DIV, PLL_DIV3_TO_CCLK, CCLK_DIV2_TO_HCLK, HCLK_DIV2_TO_PCLK, PLL_DIV4_TO_MSPI_CLK)
@@ -84,3 +86,49 @@ VOID SystemInit(VOID)
     clock_32k_init(CLK_32K_RC);
     clock_cal_32k_rc();
 }
+
+/* The CCLK, HCLK and PCLK dividers of the presets SystemClockSet switches between */
+STATIC const struct {
+    UINT32 cclk;
+    sys_pll_div_to_cclk_e cclkDiv;
+    sys_cclk_div_to_hclk_e hclkDiv;
+    sys_hclk_div_to_pclk_e pclkDiv;
+} g_clockPresets[] = {
+    {16000000, PLL_DIV12_TO_CCLK, CCLK_DIV1_TO_HCLK, HCLK_DIV1_TO_PCLK},
+    {24000000, PLL_DIV8_TO_CCLK, CCLK_DIV1_TO_HCLK, HCLK_DIV1_TO_PCLK},
+    {32000000, PLL_DIV6_TO_CCLK, CCLK_DIV1_TO_HCLK, HCLK_DIV2_TO_PCLK},
+    {48000000, PLL_DIV4_TO_CCLK, CCLK_DIV1_TO_HCLK, HCLK_DIV2_TO_PCLK},
+    {64000000, PLL_DIV3_TO_CCLK, CCLK_DIV2_TO_HCLK, HCLK_DIV2_TO_PCLK},
+    {96000000, PLL_DIV2_TO_CCLK, CCLK_DIV2_TO_HCLK, HCLK_DIV2_TO_PCLK},
+};
+
+#define CLOCK_PRESET_NUM (sizeof(g_clockPresets) / sizeof(g_clockPresets[0]))
+
+UINT32 SystemClockSet(UINT32 cclk)
+{
+    for (UINT32 i = 0; i < CLOCK_PRESET_NUM; ++i) {
+        if (g_clockPresets[i].cclk != cclk) {
+            continue;
+        }
+
+        /*
+         * clock_init writes the HCLK/PCLK dividers before the CCLK divider. That keeps
+         * HCLK <= 48 MHz and PCLK <= 24 MHz only when speeding up: slowing down, e.g.
+         * 96 -> 48 MHz, HCLK would briefly run at 96 MHz. So CCLK is lowered first with
+         * the dividers in use, which can only slow HCLK/PCLK down, then the new dividers
+         * are applied.
+         */
+        if (cclk < (sys_clk.cclk * HZ_IN_MHZ)) {
+            clock_init(PLL_CLK_192M, PAD_PLL_DIV, g_clockPresets[i].cclkDiv,
+                       (sys_cclk_div_to_hclk_e)(sys_clk.cclk / sys_clk.hclk),
+                       (sys_hclk_div_to_pclk_e)(sys_clk.hclk / sys_clk.pclk), PLL_DIV4_TO_MSPI_CLK);
+        }
+
+        clock_init(PLL_CLK_192M, PAD_PLL_DIV, g_clockPresets[i].cclkDiv, g_clockPresets[i].hclkDiv,
+                   g_clockPresets[i].pclkDiv, PLL_DIV4_TO_MSPI_CLK);
+
+        return LOS_OK;
+    }
+
+    return LOS_NOK;
+}
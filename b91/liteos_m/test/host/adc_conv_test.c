@@ -0,0 +1,147 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <b91_adc_conv.h>
+
+#include "host_test.h"
+
+#define CODE_SIGN 0x2000
+#define CODE_MAX  0x1FFF
+
+/* SDK settings: Vref 1175 mV, pre-scale 1/4 and the VBAT divider off */
+#define VREF_MV      1175
+#define PRE_SCALE    4
+#define VBAT_DIVIDER 1
+
+/* adc_calculate_voltage: the product is truncated, not rounded */
+STATIC INT32 ReferenceMv(UINT32 gain, UINT16 code, INT16 offsetMv)
+{
+    return (INT32)((code * gain) >> 13) + offsetMv;
+}
+
+STATIC VOID CalInit(VOID)
+{
+    B91AdcCal cal;
+
+    TEST_ASSERT_EQ(B91AdcCalInit(&cal, VREF_MV, PRE_SCALE, VBAT_DIVIDER, -12), LOS_OK);
+    TEST_ASSERT_EQ(cal.gain, VREF_MV * PRE_SCALE * VBAT_DIVIDER);
+    TEST_ASSERT_EQ(cal.offsetMv, -12);
+
+    TEST_ASSERT_EQ(B91AdcCalInit(&cal, VREF_MV, PRE_SCALE, 0, 0), LOS_NOK);
+    TEST_ASSERT_EQ(B91AdcCalInit(&cal, VREF_MV, 8, 8, 0), LOS_NOK);
+    TEST_ASSERT_EQ(B91AdcCalInit(NULL, VREF_MV, PRE_SCALE, VBAT_DIVIDER, 0), LOS_NOK);
+}
+
+STATIC VOID Mask(VOID)
+{
+    UINT16 codes[] = {0, 1, CODE_MAX, CODE_SIGN, CODE_SIGN | 1, 0xFFFF, 0x4123};
+
+    B91AdcCodesMask(codes, sizeof(codes) / sizeof(codes[0]));
+    TEST_ASSERT_EQ(codes[0], 0);
+    TEST_ASSERT_EQ(codes[1], 1);
+    TEST_ASSERT_EQ(codes[2], CODE_MAX);
+    TEST_ASSERT_EQ(codes[3], 0);
+    TEST_ASSERT_EQ(codes[4], 0);
+    TEST_ASSERT_EQ(codes[5], 0);
+    /* bits above the sign are not part of the code */
+    TEST_ASSERT_EQ(codes[6], 0x0123);
+}
+
+STATIC VOID RoundingMatchesSdk(VOID)
+{
+    STATIC UINT16 codes[CODE_MAX + 1];
+    STATIC UINT16 mv[CODE_MAX + 1];
+    B91AdcCal cal;
+
+    (VOID)B91AdcCalInit(&cal, VREF_MV, PRE_SCALE, VBAT_DIVIDER, 0);
+    for (UINT32 i = 0; i <= CODE_MAX; ++i) {
+        codes[i] = (UINT16)i;
+    }
+
+    B91AdcCodesToMv(&cal, codes, mv, CODE_MAX + 1);
+
+    UINT32 mismatches = 0;
+    for (UINT32 i = 0; i <= CODE_MAX; ++i) {
+        mismatches += (mv[i] != ReferenceMv(cal.gain, (UINT16)i, 0)) ? 1 : 0;
+    }
+    TEST_ASSERT_EQ(mismatches, 0);
+
+    /* 4700 mV per 8192 codes: the fraction is dropped, never rounded up */
+    TEST_ASSERT_EQ(mv[1], 0);
+    TEST_ASSERT_EQ(mv[2], 1);
+    TEST_ASSERT_EQ(mv[CODE_MAX], 4699);
+}
+
+STATIC VOID Saturation(VOID)
+{
+    UINT16 codes[] = {0, 5, CODE_MAX, CODE_SIGN | 100};
+    UINT16 mv[4];
+    B91AdcCal cal;
+
+    /* a negative offset clamps at 0 instead of wrapping */
+    (VOID)B91AdcCalInit(&cal, VREF_MV, PRE_SCALE, VBAT_DIVIDER, -100);
+    B91AdcCodesToMv(&cal, codes, mv, 4);
+    TEST_ASSERT_EQ(mv[0], 0);
+    TEST_ASSERT_EQ(mv[1], 0);
+    TEST_ASSERT_EQ(mv[2], 4599);
+    TEST_ASSERT_EQ(mv[3], 0);
+
+    /* the largest gain plus a positive offset clamps at 65535 */
+    (VOID)B91AdcCalInit(&cal, 0xFFFF, 1, 1, 100);
+    B91AdcCodesToMv(&cal, codes, mv, 4);
+    TEST_ASSERT_EQ(mv[0], 100);
+    TEST_ASSERT_EQ(mv[2], 0xFFFF);
+    /* negative inputs read as 0 V, the offset still applies */
+    TEST_ASSERT_EQ(mv[3], 100);
+}
+
+STATIC VOID InPlace(VOID)
+{
+    UINT16 buf[] = {1000, 2000, CODE_SIGN | 7};
+    B91AdcCal cal;
+
+    (VOID)B91AdcCalInit(&cal, VREF_MV, PRE_SCALE, VBAT_DIVIDER, 0);
+    B91AdcCodesToMv(&cal, buf, buf, 3);
+    TEST_ASSERT_EQ(buf[0], ReferenceMv(cal.gain, 1000, 0));
+    TEST_ASSERT_EQ(buf[1], ReferenceMv(cal.gain, 2000, 0));
+    TEST_ASSERT_EQ(buf[2], 0);
+}
+
+STATIC VOID Temperature(VOID)
+{
+    UINT16 codes[] = {0, 5000, CODE_MAX, CODE_SIGN | 5000};
+    INT16 celsius[4];
+
+    B91AdcCodesToTemp(codes, celsius, 4);
+    /* adc_calculate_temperature: 564 - ((code * 819) >> 13) */
+    TEST_ASSERT_EQ(celsius[0], 564);
+    TEST_ASSERT_EQ(celsius[1], 564 - ((5000 * 819) >> 13));
+    TEST_ASSERT_EQ(celsius[2], 564 - ((CODE_MAX * 819) >> 13));
+    TEST_ASSERT_EQ(celsius[3], 564);
+}
+
+int main(VOID)
+{
+    TEST_RUN(CalInit);
+    TEST_RUN(Mask);
+    TEST_RUN(RoundingMatchesSdk);
+    TEST_RUN(Saturation);
+    TEST_RUN(InPlace);
+    TEST_RUN(Temperature);
+    TEST_EXIT();
+}
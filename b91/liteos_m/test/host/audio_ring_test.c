@@ -0,0 +1,158 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <b91_audio_ring.h>
+
+#include "host_test.h"
+
+#define PERIODS 4
+
+STATIC B91AudioRing g_ring;
+
+/* Drain the ring up to cur, recording what the interrupt handler would see */
+STATIC VOID Complete(UINT32 cur, UINT32 *delivered, UINT32 *dropped, UINT32 *lastPeriod)
+{
+    UINT32 period;
+    B91AudioRingEvent event;
+
+    while ((event = B91AudioRingNext(&g_ring, cur, &period)) != B91_AUDIO_RING_IDLE) {
+        if (event == B91_AUDIO_RING_DELIVER) {
+            ++*delivered;
+        } else {
+            ++*dropped;
+        }
+        *lastPeriod = period;
+    }
+}
+
+STATIC VOID CaughtUp(VOID)
+{
+    UINT32 period = 0xFF;
+
+    B91AudioRingInit(&g_ring, PERIODS);
+    TEST_ASSERT_EQ(B91AudioRingNext(&g_ring, 0, &period), B91_AUDIO_RING_IDLE);
+    TEST_ASSERT_EQ(period, 0xFF);
+    TEST_ASSERT_EQ(g_ring.owned, 0);
+}
+
+STATIC VOID LateInterruptDeliversInOrder(VOID)
+{
+    UINT32 period;
+
+    B91AudioRingInit(&g_ring, PERIODS);
+    for (UINT32 i = 0; i < 3; ++i) {
+        TEST_ASSERT_EQ(B91AudioRingNext(&g_ring, 3, &period), B91_AUDIO_RING_DELIVER);
+        TEST_ASSERT_EQ(period, i);
+    }
+    TEST_ASSERT_EQ(B91AudioRingNext(&g_ring, 3, &period), B91_AUDIO_RING_IDLE);
+    TEST_ASSERT_EQ(g_ring.owned, 3);
+}
+
+STATIC VOID OverrunIsDropped(VOID)
+{
+    UINT32 period;
+
+    B91AudioRingInit(&g_ring, PERIODS);
+    for (UINT32 i = 0; i < (PERIODS - 1); ++i) {
+        TEST_ASSERT_EQ(B91AudioRingNext(&g_ring, PERIODS - 1, &period), B91_AUDIO_RING_DELIVER);
+    }
+
+    /* the application holds all the other periods: period 3 completes and is dropped */
+    TEST_ASSERT_EQ(B91AudioRingNext(&g_ring, 0, &period), B91_AUDIO_RING_DROP);
+    TEST_ASSERT_EQ(period, 3);
+    TEST_ASSERT_EQ(g_ring.owned, PERIODS - 1);
+
+    /* three deliveries, three releases, nothing left over */
+    for (UINT32 i = 0; i < (PERIODS - 1); ++i) {
+        B91AudioRingRelease(&g_ring);
+    }
+    TEST_ASSERT_EQ(g_ring.owned, 0);
+    B91AudioRingRelease(&g_ring);
+    TEST_ASSERT_EQ(g_ring.owned, 0);
+
+    TEST_ASSERT_EQ(B91AudioRingNext(&g_ring, 1, &period), B91_AUDIO_RING_DELIVER);
+    TEST_ASSERT_EQ(period, 0);
+}
+
+STATIC VOID WrapAround(VOID)
+{
+    UINT32 delivered = 0;
+    UINT32 dropped = 0;
+    UINT32 last = 0;
+
+    B91AudioRingInit(&g_ring, PERIODS);
+
+    /* ten laps, one interrupt per period, each period released right away */
+    for (UINT32 n = 1; n <= (10 * PERIODS); ++n) {
+        Complete(n % PERIODS, &delivered, &dropped, &last);
+        TEST_ASSERT_EQ(last, (n - 1) % PERIODS);
+        B91AudioRingRelease(&g_ring);
+    }
+
+    TEST_ASSERT_EQ(delivered, 10 * PERIODS);
+    TEST_ASSERT_EQ(dropped, 0);
+    TEST_ASSERT_EQ(g_ring.owned, 0);
+    TEST_ASSERT_EQ(g_ring.next, 0);
+}
+
+STATIC VOID SlowConsumerAccounting(VOID)
+{
+    UINT32 delivered = 0;
+    UINT32 dropped = 0;
+    UINT32 released = 0;
+    UINT32 last = 0;
+    UINT32 seed = 12345;
+
+    B91AudioRingInit(&g_ring, PERIODS);
+
+    /*
+     * The DMA moves 0 to 3 periods per interrupt across many wraps, the consumer releases
+     * 0 to 2 periods in between: deliveries minus releases always equals what is held.
+     */
+    UINT32 dmaPos = 0;
+    for (UINT32 step = 0; step < 10000; ++step) {
+        seed = seed * 1103515245U + 12345U;
+        dmaPos += (seed >> 16) % 4;
+        Complete(dmaPos % PERIODS, &delivered, &dropped, &last);
+
+        UINT32 release = (seed >> 20) % 3;
+        for (UINT32 i = 0; (i < release) && (g_ring.owned != 0); ++i) {
+            B91AudioRingRelease(&g_ring);
+            ++released;
+        }
+
+        TEST_ASSERT(g_ring.owned <= (PERIODS - 1));
+        TEST_ASSERT_EQ(delivered - released, g_ring.owned);
+        if ((delivered - released) != g_ring.owned) {
+            break;
+        }
+    }
+
+    TEST_ASSERT(dropped != 0);
+    TEST_ASSERT_EQ(delivered + dropped, dmaPos);
+}
+
+int main(VOID)
+{
+    TEST_RUN(CaughtUp);
+    TEST_RUN(LateInterruptDeliversInOrder);
+    TEST_RUN(OverrunIsDropped);
+    TEST_RUN(WrapAround);
+    TEST_RUN(SlowConsumerAccounting);
+    TEST_EXIT();
+}
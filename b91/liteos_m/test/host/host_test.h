@@ -0,0 +1,53 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef _HOST_TEST_H
+#define _HOST_TEST_H
+
+#include <stdio.h>
+
+STATIC UINT32 g_testFailures;
+
+#define TEST_ASSERT(cond)                                                                                             \
+    do {                                                                                                              \
+        if (!(cond)) {                                                                                                \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond);                                                \
+            ++g_testFailures;                                                                                         \
+        }                                                                                                             \
+    } while (0)
+
+#define TEST_ASSERT_EQ(actual, expected)                                                                              \
+    do {                                                                                                              \
+        long long a_ = (long long)(actual);                                                                           \
+        long long e_ = (long long)(expected);                                                                         \
+        if (a_ != e_) {                                                                                               \
+            fprintf(stderr, "%s:%d: %s == %lld, expected %lld\n", __FILE__, __LINE__, #actual, a_, e_);               \
+            ++g_testFailures;                                                                                         \
+        }                                                                                                             \
+    } while (0)
+
+#define TEST_RUN(test)                                                                                                \
+    do {                                                                                                              \
+        UINT32 before_ = g_testFailures;                                                                              \
+        test();                                                                                                       \
+        printf("%-40s %s\n", #test, (g_testFailures == before_) ? "ok" : "FAILED");                                   \
+    } while (0)
+
+#define TEST_EXIT() return (g_testFailures == 0) ? 0 : 1
+
+#endif /* _HOST_TEST_H */
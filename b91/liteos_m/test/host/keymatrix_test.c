@@ -0,0 +1,297 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <string.h>
+
+#include <b91_keymatrix.h>
+
+#include "host_test.h"
+
+#define COLS 4
+#define ROWS 4
+
+/*
+ * Matrix model: a driven column reaches every row connected to it through pressed keys,
+ * including paths over other columns, which is what makes a phantom key appear.
+ */
+STATIC struct {
+    UINT16 pressed[COLS];
+    UINT32 driven;
+    UINT32 wakeRows;
+    UINT32 selects;
+} g_model;
+
+STATIC VOID ModelColSelect(VOID *arg, UINT32 col)
+{
+    (VOID)arg;
+
+    ++g_model.selects;
+    if (col == B91_KEYMATRIX_COL_NONE) {
+        g_model.driven = 0;
+    } else if (col == B91_KEYMATRIX_COL_ALL) {
+        g_model.driven = (1U << COLS) - 1;
+    } else {
+        g_model.driven = 1U << col;
+    }
+}
+
+STATIC UINT32 ModelRowRead(VOID *arg)
+{
+    UINT32 cols = g_model.driven;
+    UINT32 rows = 0;
+    UINT32 last;
+
+    (VOID)arg;
+
+    do {
+        last = rows;
+        for (UINT32 col = 0; col < COLS; ++col) {
+            if (((cols & (1U << col)) != 0) || ((g_model.pressed[col] & rows) != 0)) {
+                cols |= 1U << col;
+                rows |= g_model.pressed[col];
+            }
+        }
+    } while (rows != last);
+
+    return rows;
+}
+
+STATIC VOID ModelRowWakeSet(VOID *arg, UINT32 rows, BOOL enable)
+{
+    (VOID)arg;
+
+    if (enable) {
+        g_model.wakeRows |= rows;
+    } else {
+        g_model.wakeRows &= ~rows;
+    }
+}
+
+STATIC const B91KeymatrixIo g_io = {
+    .colSelect = ModelColSelect,
+    .rowRead = ModelRowRead,
+    .rowWakeSet = ModelRowWakeSet,
+};
+
+STATIC B91Keymatrix g_km;
+
+STATIC VOID Setup(VOID)
+{
+    (VOID)memset(&g_model, 0, sizeof(g_model));
+    (VOID)B91KeymatrixInit(&g_km, &g_io, COLS, ROWS);
+}
+
+STATIC VOID Press(UINT32 col, UINT32 row, BOOL down)
+{
+    if (down) {
+        g_model.pressed[col] |= 1U << row;
+    } else {
+        g_model.pressed[col] &= ~(1U << row);
+    }
+}
+
+STATIC VOID ScanTimes(UINT32 times)
+{
+    for (UINT32 i = 0; i < times; ++i) {
+        (VOID)B91KeymatrixScan(&g_km, i);
+    }
+}
+
+STATIC BOOL ExpectEvent(UINT32 col, UINT32 row, BOOL pressed)
+{
+    B91KeyEvent event;
+
+    if (B91KeymatrixEventGet(&g_km, &event) != LOS_OK) {
+        return FALSE;
+    }
+
+    return (event.col == col) && (event.row == row) && (event.pressed == pressed);
+}
+
+STATIC BOOL NoEvent(VOID)
+{
+    B91KeyEvent event;
+
+    return B91KeymatrixEventGet(&g_km, &event) != LOS_OK;
+}
+
+STATIC VOID InitRejectsBadSize(VOID)
+{
+    B91Keymatrix km;
+
+    TEST_ASSERT_EQ(B91KeymatrixInit(&km, &g_io, 0, ROWS), LOS_NOK);
+    TEST_ASSERT_EQ(B91KeymatrixInit(&km, &g_io, B91_KEYMATRIX_MAX_COLS + 1, ROWS), LOS_NOK);
+    TEST_ASSERT_EQ(B91KeymatrixInit(&km, &g_io, COLS, B91_KEYMATRIX_MAX_ROWS + 1), LOS_NOK);
+    TEST_ASSERT_EQ(B91KeymatrixInit(&km, NULL, COLS, ROWS), LOS_NOK);
+}
+
+STATIC VOID IdleScanIsOneRead(VOID)
+{
+    Setup();
+
+    TEST_ASSERT(!B91KeymatrixScan(&g_km, 0));
+    /* all columns, then none */
+    TEST_ASSERT_EQ(g_model.selects, 2);
+    TEST_ASSERT_EQ(g_model.driven, 0);
+    TEST_ASSERT(NoEvent());
+}
+
+STATIC VOID DebouncePress(VOID)
+{
+    Setup();
+    Press(2, 1, TRUE);
+
+    for (UINT32 i = 0; i < 3; ++i) {
+        TEST_ASSERT(B91KeymatrixScan(&g_km, i));
+        TEST_ASSERT(NoEvent());
+    }
+
+    TEST_ASSERT(B91KeymatrixScan(&g_km, 3));
+    TEST_ASSERT(ExpectEvent(2, 1, TRUE));
+    TEST_ASSERT(NoEvent());
+
+    Press(2, 1, FALSE);
+    ScanTimes(3);
+    TEST_ASSERT(NoEvent());
+    TEST_ASSERT(!B91KeymatrixScan(&g_km, 3));
+    TEST_ASSERT(ExpectEvent(2, 1, FALSE));
+    TEST_ASSERT(NoEvent());
+}
+
+STATIC VOID DebounceBounce(VOID)
+{
+    Setup();
+
+    /* contact bounce shorter than four scans never gets reported */
+    for (UINT32 i = 0; i < 4; ++i) {
+        Press(0, 3, TRUE);
+        ScanTimes(3);
+        Press(0, 3, FALSE);
+        ScanTimes(1);
+    }
+    TEST_ASSERT(NoEvent());
+
+    /* and the counters settle back to idle once the line is quiet */
+    ScanTimes(1);
+    TEST_ASSERT(!B91KeymatrixScan(&g_km, 0));
+    TEST_ASSERT(NoEvent());
+}
+
+STATIC VOID GhostRejected(VOID)
+{
+    Setup();
+    Press(0, 0, TRUE);
+    Press(0, 1, TRUE);
+    ScanTimes(4);
+    TEST_ASSERT(ExpectEvent(0, 0, TRUE));
+    TEST_ASSERT(ExpectEvent(0, 1, TRUE));
+
+    /* the third corner makes (1, 1) look pressed as well */
+    Press(1, 0, TRUE);
+    ScanTimes(8);
+    TEST_ASSERT(NoEvent());
+    TEST_ASSERT(g_km.ghosts != 0);
+
+    /* once the rectangle is broken the real keys come through, the phantom never did */
+    Press(0, 1, FALSE);
+    ScanTimes(4);
+    TEST_ASSERT(ExpectEvent(0, 1, FALSE));
+    TEST_ASSERT(ExpectEvent(1, 0, TRUE));
+    TEST_ASSERT(NoEvent());
+}
+
+STATIC VOID TwoKeysSameRowNoGhost(VOID)
+{
+    Setup();
+    Press(0, 2, TRUE);
+    Press(3, 2, TRUE);
+    ScanTimes(4);
+    TEST_ASSERT(ExpectEvent(0, 2, TRUE));
+    TEST_ASSERT(ExpectEvent(3, 2, TRUE));
+    TEST_ASSERT_EQ(g_km.ghosts, 0);
+}
+
+STATIC VOID EventOverflowCounted(VOID)
+{
+    Setup();
+
+    /* a whole column pressed and released queues two events per row */
+    for (UINT32 col = 0; col < COLS; ++col) {
+        g_model.pressed[col] = (1U << ROWS) - 1;
+        ScanTimes(4);
+        g_model.pressed[col] = 0;
+        ScanTimes(4);
+    }
+
+    TEST_ASSERT_EQ(g_km.lost, 2 * COLS * ROWS - B91_KEYMATRIX_EVENTS);
+    for (UINT32 i = 0; i < B91_KEYMATRIX_EVENTS; ++i) {
+        TEST_ASSERT(!NoEvent());
+    }
+    TEST_ASSERT(NoEvent());
+}
+
+STATIC VOID WakeArming(VOID)
+{
+    Setup();
+
+    B91KeymatrixWakeArm(&g_km);
+    TEST_ASSERT_EQ(g_model.driven, (1U << COLS) - 1);
+    TEST_ASSERT_EQ(g_model.wakeRows, (1U << ROWS) - 1);
+
+    /* any key now pulls its row to the wakeup level */
+    Press(3, 2, TRUE);
+    TEST_ASSERT_EQ(ModelRowRead(NULL) & g_model.wakeRows, 1U << 2);
+
+    B91KeymatrixWakeDisarm(&g_km);
+    TEST_ASSERT_EQ(g_model.driven, 0);
+    TEST_ASSERT_EQ(g_model.wakeRows, 0);
+
+    /* the key that woke the system is reported by the scans that follow */
+    ScanTimes(4);
+    TEST_ASSERT(ExpectEvent(3, 2, TRUE));
+}
+
+STATIC VOID WakeArmingWithoutHook(VOID)
+{
+    STATIC const B91KeymatrixIo io = {
+        .colSelect = ModelColSelect,
+        .rowRead = ModelRowRead,
+    };
+    B91Keymatrix km;
+
+    (VOID)memset(&g_model, 0, sizeof(g_model));
+    (VOID)B91KeymatrixInit(&km, &io, COLS, ROWS);
+    B91KeymatrixWakeArm(&km);
+    TEST_ASSERT_EQ(g_model.driven, (1U << COLS) - 1);
+    B91KeymatrixWakeDisarm(&km);
+    TEST_ASSERT_EQ(g_model.driven, 0);
+}
+
+int main(VOID)
+{
+    TEST_RUN(InitRejectsBadSize);
+    TEST_RUN(IdleScanIsOneRead);
+    TEST_RUN(DebouncePress);
+    TEST_RUN(DebounceBounce);
+    TEST_RUN(GhostRejected);
+    TEST_RUN(TwoKeysSameRowNoGhost);
+    TEST_RUN(EventOverflowCounted);
+    TEST_RUN(WakeArming);
+    TEST_RUN(WakeArmingWithoutHook);
+    TEST_EXIT();
+}
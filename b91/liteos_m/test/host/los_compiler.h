@@ -0,0 +1,52 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#ifndef _LOS_COMPILER_H
+#define _LOS_COMPILER_H
+
+/*
+ * Host stand-in for the kernel los_compiler.h: the scalar types and keywords the
+ * hardware free modules use, so they build with the host compiler unchanged.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned char UINT8;
+typedef unsigned short UINT16;
+typedef unsigned int UINT32;
+typedef unsigned long long UINT64;
+typedef signed char INT8;
+typedef short INT16;
+typedef int INT32;
+typedef long long INT64;
+typedef char CHAR;
+typedef uintptr_t UINTPTR;
+typedef unsigned int BOOL;
+
+#define VOID   void
+#define STATIC static
+#define INLINE inline
+
+#define TRUE  1U
+#define FALSE 0U
+
+#define LOS_OK  0U
+#define LOS_NOK 1U
+
+#endif /* _LOS_COMPILER_H */
@@ -0,0 +1,122 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <b91_sleep_policy.h>
+
+#include "host_test.h"
+
+STATIC const B91SleepPolicy g_policy = {
+    .minSuspendTicks = 1000,
+    .wakeupMarginTicks = 200,
+    .maxSleepTicks = 50000,
+};
+
+STATIC B91SleepMode Decide(UINT32 idleTicks, UINT32 radioTicks, UINT32 wakeLocks, BOOL busy, UINT32 *wakeTicks)
+{
+    B91SleepState state = {
+        .idleTicks = idleTicks,
+        .radioTicks = radioTicks,
+        .wakeLocks = wakeLocks,
+        .busy = busy,
+    };
+
+    *wakeTicks = 0;
+    return B91SleepDecide(&g_policy, &state, wakeTicks);
+}
+
+STATIC VOID TimerDue(VOID)
+{
+    UINT32 wake;
+
+    TEST_ASSERT_EQ(Decide(0, B91_SLEEP_RADIO_IDLE, 0, FALSE, &wake), B91_SLEEP_NONE);
+    TEST_ASSERT_EQ(Decide(0, 10, 1, TRUE, &wake), B91_SLEEP_NONE);
+}
+
+STATIC VOID Threshold(VOID)
+{
+    UINT32 wake;
+
+    TEST_ASSERT_EQ(Decide(999, B91_SLEEP_RADIO_IDLE, 0, FALSE, &wake), B91_SLEEP_WFI);
+    TEST_ASSERT_EQ(wake, 0);
+    TEST_ASSERT_EQ(Decide(1000, B91_SLEEP_RADIO_IDLE, 0, FALSE, &wake), B91_SLEEP_SUSPEND);
+    TEST_ASSERT_EQ(wake, 800);
+}
+
+STATIC VOID MarginAboveThreshold(VOID)
+{
+    STATIC const B91SleepPolicy policy = {
+        .minSuspendTicks = 100,
+        .wakeupMarginTicks = 500,
+        .maxSleepTicks = 50000,
+    };
+    B91SleepState state = { .idleTicks = 500, .radioTicks = B91_SLEEP_RADIO_IDLE };
+    UINT32 wake = 0;
+
+    TEST_ASSERT_EQ(B91SleepDecide(&policy, &state, &wake), B91_SLEEP_WFI);
+    state.idleTicks = 501;
+    TEST_ASSERT_EQ(B91SleepDecide(&policy, &state, &wake), B91_SLEEP_SUSPEND);
+    TEST_ASSERT_EQ(wake, 1);
+}
+
+STATIC VOID MaxSleepClamp(VOID)
+{
+    UINT32 wake;
+
+    TEST_ASSERT_EQ(Decide(0x80000000U, B91_SLEEP_RADIO_IDLE, 0, FALSE, &wake), B91_SLEEP_SUSPEND);
+    TEST_ASSERT_EQ(wake, g_policy.maxSleepTicks);
+}
+
+STATIC VOID WakeLocks(VOID)
+{
+    UINT32 wake;
+
+    TEST_ASSERT_EQ(Decide(20000, B91_SLEEP_RADIO_IDLE, 1, FALSE, &wake), B91_SLEEP_WFI);
+    TEST_ASSERT_EQ(Decide(20000, B91_SLEEP_RADIO_IDLE, 3, FALSE, &wake), B91_SLEEP_WFI);
+    TEST_ASSERT_EQ(Decide(20000, B91_SLEEP_RADIO_IDLE, 0, TRUE, &wake), B91_SLEEP_WFI);
+    TEST_ASSERT_EQ(wake, 0);
+    TEST_ASSERT_EQ(Decide(20000, B91_SLEEP_RADIO_IDLE, 0, FALSE, &wake), B91_SLEEP_SUSPEND);
+    TEST_ASSERT_EQ(wake, 19800);
+}
+
+STATIC VOID RadioBoundsWake(VOID)
+{
+    UINT32 wake;
+
+    /* the next connection event comes before the kernel timer */
+    TEST_ASSERT_EQ(Decide(20000, 5000, 0, FALSE, &wake), B91_SLEEP_SUSPEND);
+    TEST_ASSERT_EQ(wake, 4800);
+
+    /* the kernel timer comes first */
+    TEST_ASSERT_EQ(Decide(3000, 5000, 0, FALSE, &wake), B91_SLEEP_SUSPEND);
+    TEST_ASSERT_EQ(wake, 2800);
+
+    /* an event too close to be worth suspending for */
+    TEST_ASSERT_EQ(Decide(20000, 999, 0, FALSE, &wake), B91_SLEEP_WFI);
+    TEST_ASSERT_EQ(Decide(20000, 0, 0, FALSE, &wake), B91_SLEEP_WFI);
+}
+
+int main(VOID)
+{
+    TEST_RUN(TimerDue);
+    TEST_RUN(Threshold);
+    TEST_RUN(MarginAboveThreshold);
+    TEST_RUN(MaxSleepClamp);
+    TEST_RUN(WakeLocks);
+    TEST_RUN(RadioBoundsWake);
+    TEST_EXIT();
+}
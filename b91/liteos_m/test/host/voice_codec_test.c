@@ -0,0 +1,223 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+#include <string.h>
+
+#include <b91_voice_codec.h>
+
+#include "host_test.h"
+
+#define SAMPLES     256 /* one 16 ms period at 16 kHz */
+#define FRAMES      8
+#define FRAME_BYTES B91_VOICE_FRAME_SIZE(SAMPLES)
+#define COS_PI_8    0.92387953251128674 /* 1 kHz at 16 kHz */
+
+/* IMA/DVI ADPCM decoder as published by the IMA, written independently of the codec */
+STATIC const int g_imaSteps[89] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,    25,    28,
+    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,    88,    97,    107,   118,
+    130,   143,   157,   173,   190,   209,   230,   253,   279,   307,   337,   371,   408,   449,   494,
+    544,   598,   658,   724,   796,   876,   963,   1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+    2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,
+    9493,  10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+};
+
+STATIC const int g_imaIndexTable[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8,
+};
+
+STATIC UINT32 ReferenceFrameDecode(const UINT8 *frame, UINT32 len, INT16 *pcm)
+{
+    int predictor = (INT16)(frame[1] | (frame[2] << 8));
+    int index = frame[3];
+    UINT32 samples = (len - B91_VOICE_FRAME_HDR) * 2;
+
+    for (UINT32 i = 0; i < samples; ++i) {
+        int nibble = (frame[B91_VOICE_FRAME_HDR + (i / 2)] >> ((i % 2) * 4)) & 0xF;
+        int step = g_imaSteps[index];
+        int vpdiff = step >> 3;
+
+        if (nibble & 4) {
+            vpdiff += step;
+        }
+        if (nibble & 2) {
+            vpdiff += step >> 1;
+        }
+        if (nibble & 1) {
+            vpdiff += step >> 2;
+        }
+        predictor += (nibble & 8) ? -vpdiff : vpdiff;
+        if (predictor > 32767) {
+            predictor = 32767;
+        } else if (predictor < -32768) {
+            predictor = -32768;
+        }
+
+        index += g_imaIndexTable[nibble];
+        index = (index < 0) ? 0 : ((index > 88) ? 88 : index);
+        pcm[i] = (INT16)predictor;
+    }
+
+    return samples;
+}
+
+STATIC const B91VoiceCodecConfig g_bypass = {0};
+
+STATIC INT16 g_pcm[FRAMES * SAMPLES];
+STATIC UINT8 g_frames[FRAMES][FRAME_BYTES];
+STATIC UINT32 g_frameLen[FRAMES];
+
+/* 1 kHz tone with a slow amplitude sweep, from a two term recursive oscillator */
+STATIC VOID ToneFill(double amplitude)
+{
+    double y1 = 0.0;
+    double y2 = -amplitude * 0.38268343236508978; /* -A * sin(pi / 8) */
+
+    for (UINT32 i = 0; i < (FRAMES * SAMPLES); ++i) {
+        double y = 2.0 * COS_PI_8 * y1 - y2;
+        double ramp = 0.25 + (0.75 * i) / (FRAMES * SAMPLES);
+        g_pcm[i] = (INT16)(y * ramp);
+        y2 = y1;
+        y1 = y;
+    }
+}
+
+STATIC VOID EncodeAll(VOID)
+{
+    B91VoiceEncoder enc;
+    INT16 block[SAMPLES];
+
+    (VOID)B91VoiceEncoderInit(&enc, &g_bypass);
+    for (UINT32 f = 0; f < FRAMES; ++f) {
+        (VOID)memcpy(block, &g_pcm[f * SAMPLES], sizeof(block));
+        g_frameLen[f] = B91VoiceEncode(&enc, block, SAMPLES, g_frames[f]);
+    }
+}
+
+STATIC VOID KnownVector(VOID)
+{
+    B91AdpcmState state = {0, 0};
+    INT16 pcm[2] = {100, 100};
+    UINT8 out;
+
+    TEST_ASSERT_EQ(B91AdpcmEncode(&state, pcm, 2, &out), 1);
+    /* 100 against step 7: 4 + 2 + 1, the predictor moves by 7 + 3 + 1 + 0 */
+    TEST_ASSERT_EQ(out & 0xF, 7);
+    TEST_ASSERT_EQ(state.index, 8 + 8);
+}
+
+STATIC VOID MatchesReferenceDecode(VOID)
+{
+    INT16 ours[SAMPLES];
+    INT16 ref[SAMPLES];
+    UINT32 mismatches = 0;
+
+    ToneFill(20000.0);
+    EncodeAll();
+
+    for (UINT32 f = 0; f < FRAMES; ++f) {
+        TEST_ASSERT_EQ(g_frameLen[f], FRAME_BYTES);
+        TEST_ASSERT_EQ(g_frames[f][0], f);
+        TEST_ASSERT_EQ(B91VoiceFrameDecode(g_frames[f], g_frameLen[f], ours), SAMPLES);
+        TEST_ASSERT_EQ(ReferenceFrameDecode(g_frames[f], g_frameLen[f], ref), SAMPLES);
+        mismatches += (memcmp(ours, ref, sizeof(ours)) != 0) ? 1 : 0;
+    }
+
+    TEST_ASSERT_EQ(mismatches, 0);
+}
+
+STATIC VOID TracksInput(VOID)
+{
+    INT16 ref[SAMPLES];
+    double signal = 0.0;
+    double noise = 0.0;
+
+    ToneFill(8000.0);
+    EncodeAll();
+
+    /* the first frame is spent on the step size adapting */
+    for (UINT32 f = 1; f < FRAMES; ++f) {
+        (VOID)ReferenceFrameDecode(g_frames[f], g_frameLen[f], ref);
+        for (UINT32 i = 0; i < SAMPLES; ++i) {
+            double x = g_pcm[f * SAMPLES + i];
+            double e = x - ref[i];
+            signal += x * x;
+            noise += e * e;
+        }
+    }
+
+    /* IMA ADPCM gives about 25 dB on a clean tone, ask for more than 20 dB */
+    TEST_ASSERT(signal > (100.0 * noise));
+}
+
+STATIC VOID FramesDecodeOnTheirOwn(VOID)
+{
+    B91AdpcmState state = {0, 0};
+    INT16 stream[SAMPLES];
+    INT16 alone[SAMPLES];
+
+    ToneFill(12000.0);
+    EncodeAll();
+
+    /* decoding the whole stream and decoding frame 5 from its header agree */
+    for (UINT32 f = 0; f <= 5; ++f) {
+        B91AdpcmDecode(&state, &g_frames[f][B91_VOICE_FRAME_HDR], SAMPLES, stream);
+    }
+
+    TEST_ASSERT_EQ(B91VoiceFrameDecode(g_frames[5], g_frameLen[5], alone), SAMPLES);
+    TEST_ASSERT(memcmp(stream, alone, sizeof(alone)) == 0);
+}
+
+STATIC VOID BadFrames(VOID)
+{
+    UINT8 frame[FRAME_BYTES] = {0};
+    INT16 pcm[SAMPLES];
+
+    TEST_ASSERT_EQ(B91VoiceFrameDecode(frame, B91_VOICE_FRAME_HDR, pcm), 0);
+    TEST_ASSERT_EQ(B91VoiceFrameDecode(NULL, FRAME_BYTES, pcm), 0);
+    frame[3] = 89;
+    TEST_ASSERT_EQ(B91VoiceFrameDecode(frame, FRAME_BYTES, pcm), 0);
+}
+
+STATIC VOID HighPassRemovesDc(VOID)
+{
+    B91VoiceCodecConfig config = {.hpfCoef = 31506};
+    B91VoiceEncoder enc;
+    INT16 block[SAMPLES];
+
+    (VOID)B91VoiceEncoderInit(&enc, &config);
+    for (UINT32 f = 0; f < FRAMES; ++f) {
+        for (UINT32 i = 0; i < SAMPLES; ++i) {
+            block[i] = 5000;
+        }
+        B91VoiceHpf(&enc, block, SAMPLES);
+    }
+
+    TEST_ASSERT((block[SAMPLES - 1] > -2) && (block[SAMPLES - 1] < 2));
+}
+
+int main(VOID)
+{
+    TEST_RUN(KnownVector);
+    TEST_RUN(MatchesReferenceDecode);
+    TEST_RUN(TracksInput);
+    TEST_RUN(FramesDecodeOnTheirOwn);
+    TEST_RUN(BadFrames);
+    TEST_RUN(HighPassRemovesDc);
+    TEST_EXIT();
+}
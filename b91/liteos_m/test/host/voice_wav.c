@@ -0,0 +1,259 @@
+/******************************************************************************
+ * Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *****************************************************************************/
+
+/*
+ * Runs a 16 kHz mono 16-bit WAV through the voice encoder and decoder frame by frame and
+ * writes what the receiver would play:
+ *
+ *     voice_wav [-p] in.wav out.wav [min SNR dB]
+ *     voice_wav -t tone.wav
+ *
+ * -p enables the high-pass and the AGC, the SNR is then taken against their output. With
+ * a minimum SNR the exit status tells whether it was reached. -t writes a test tone.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <b91_voice_codec.h>
+
+#define WAV_RATE        16000
+#define WAV_BITS        16
+#define WAV_HDR_SIZE    44
+#define WAV_FMT_PCM     1
+#define WAV_FMT_SIZE    16
+#define FRAME_SAMPLES   256 /* one 16 ms period, as the audio stream delivers it */
+#define FRAME_BYTES     B91_VOICE_FRAME_SIZE(FRAME_SAMPLES)
+#define TONE_SECONDS    2
+#define TONE_HZ         440.0
+#define TONE_AMPLITUDE  12000.0
+
+STATIC const B91VoiceCodecConfig g_bypass = {0};
+
+STATIC const B91VoiceCodecConfig g_voice = {
+    .hpfCoef = 31506,
+    .agcTarget = 16000,
+    .agcMaxGain = 256 * 8,
+    .agcNoiseFloor = 200,
+};
+
+STATIC UINT32 Le16(const UINT8 *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+STATIC UINT32 Le32(const UINT8 *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((UINT32)p[3] << 24);
+}
+
+STATIC VOID PutLe16(UINT8 *p, UINT32 v)
+{
+    p[0] = (UINT8)v;
+    p[1] = (UINT8)(v >> 8);
+}
+
+STATIC VOID PutLe32(UINT8 *p, UINT32 v)
+{
+    PutLe16(p, v);
+    PutLe16(&p[2], v >> 16);
+}
+
+/* Walks the RIFF chunks, so LIST and other chunks before the samples are skipped */
+STATIC INT16 *WavRead(const char *path, UINT32 *samples)
+{
+    UINT8 hdr[8];
+    BOOL fmtOk = FALSE;
+    INT16 *pcm = NULL;
+    FILE *f = fopen(path, "rb");
+
+    if (f == NULL) {
+        perror(path);
+        return NULL;
+    }
+
+    if ((fread(hdr, 1, 8, f) != 8) || (memcmp(hdr, "RIFF", 4) != 0) || (fread(hdr, 1, 4, f) != 4) ||
+        (memcmp(hdr, "WAVE", 4) != 0)) {
+        fprintf(stderr, "%s: not a WAV file\n", path);
+        goto OUT;
+    }
+
+    while (fread(hdr, 1, 8, f) == 8) {
+        UINT32 size = Le32(&hdr[4]);
+
+        if (memcmp(hdr, "fmt ", 4) == 0) {
+            UINT8 fmt[WAV_FMT_SIZE];
+            if ((size < WAV_FMT_SIZE) || (fread(fmt, 1, WAV_FMT_SIZE, f) != WAV_FMT_SIZE)) {
+                break;
+            }
+            fmtOk = (Le16(&fmt[0]) == WAV_FMT_PCM) && (Le16(&fmt[2]) == 1) && (Le32(&fmt[4]) == WAV_RATE) &&
+                    (Le16(&fmt[14]) == WAV_BITS);
+            size -= WAV_FMT_SIZE;
+        } else if (memcmp(hdr, "data", 4) == 0) {
+            if (!fmtOk) {
+                break;
+            }
+            *samples = size / sizeof(INT16);
+            pcm = calloc(*samples + FRAME_SAMPLES, sizeof(INT16));
+            if ((pcm == NULL) || (fread(pcm, sizeof(INT16), *samples, f) != *samples)) {
+                free(pcm);
+                pcm = NULL;
+                fprintf(stderr, "%s: short data chunk\n", path);
+            }
+            for (UINT32 i = 0; (pcm != NULL) && (i < *samples); ++i) {
+                pcm[i] = (INT16)Le16((const UINT8 *)&pcm[i]);
+            }
+            goto OUT;
+        }
+
+        /* chunks are padded to an even length */
+        if (fseek(f, (long)(size + (size & 1)), SEEK_CUR) != 0) {
+            break;
+        }
+    }
+
+    fprintf(stderr, "%s: need 16 kHz mono 16-bit PCM\n", path);
+
+OUT:
+    fclose(f);
+    return pcm;
+}
+
+STATIC INT32 WavWrite(const char *path, const INT16 *pcm, UINT32 samples)
+{
+    UINT8 hdr[WAV_HDR_SIZE];
+    UINT32 dataSize = samples * sizeof(INT16);
+    FILE *f = fopen(path, "wb");
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    (VOID)memcpy(&hdr[0], "RIFF", 4);
+    PutLe32(&hdr[4], WAV_HDR_SIZE - 8 + dataSize);
+    (VOID)memcpy(&hdr[8], "WAVEfmt ", 8);
+    PutLe32(&hdr[16], WAV_FMT_SIZE);
+    PutLe16(&hdr[20], WAV_FMT_PCM);
+    PutLe16(&hdr[22], 1);
+    PutLe32(&hdr[24], WAV_RATE);
+    PutLe32(&hdr[28], WAV_RATE * sizeof(INT16));
+    PutLe16(&hdr[32], sizeof(INT16));
+    PutLe16(&hdr[34], WAV_BITS);
+    (VOID)memcpy(&hdr[36], "data", 4);
+    PutLe32(&hdr[40], dataSize);
+
+    INT32 ret = (fwrite(hdr, 1, sizeof(hdr), f) == sizeof(hdr)) ? 0 : -1;
+    for (UINT32 i = 0; (ret == 0) && (i < samples); ++i) {
+        UINT8 le[sizeof(INT16)];
+        PutLe16(le, (UINT16)pcm[i]);
+        ret = (fwrite(le, 1, sizeof(le), f) == sizeof(le)) ? 0 : -1;
+    }
+
+    if ((fclose(f) != 0) || (ret != 0)) {
+        fprintf(stderr, "%s: write failed\n", path);
+        return -1;
+    }
+
+    return 0;
+}
+
+STATIC INT32 ToneWrite(const char *path)
+{
+    UINT32 samples = TONE_SECONDS * WAV_RATE;
+    INT16 *pcm = malloc(samples * sizeof(INT16));
+
+    if (pcm == NULL) {
+        return -1;
+    }
+
+    for (UINT32 i = 0; i < samples; ++i) {
+        pcm[i] = (INT16)(TONE_AMPLITUDE * sin(2.0 * M_PI * TONE_HZ * i / WAV_RATE));
+    }
+
+    INT32 ret = WavWrite(path, pcm, samples);
+    free(pcm);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    const B91VoiceCodecConfig *config = &g_bypass;
+    B91VoiceEncoder enc;
+    UINT8 frame[FRAME_BYTES];
+    UINT32 samples = 0;
+    double signal = 0.0;
+    double noise = 0.0;
+
+    if ((argc == 3) && (strcmp(argv[1], "-t") == 0)) {
+        return (ToneWrite(argv[2]) == 0) ? 0 : 1;
+    }
+
+    if ((argc > 1) && (strcmp(argv[1], "-p") == 0)) {
+        config = &g_voice;
+        --argc;
+        ++argv;
+    }
+
+    if ((argc != 3) && (argc != 4)) {
+        fprintf(stderr, "usage: voice_wav [-p] in.wav out.wav [min SNR dB]\n       voice_wav -t tone.wav\n");
+        return 1;
+    }
+
+    INT16 *pcm = WavRead(argv[1], &samples);
+    if ((pcm == NULL) || (B91VoiceEncoderInit(&enc, config) != LOS_OK)) {
+        free(pcm);
+        return 1;
+    }
+
+    /* The last block is zero padded by WavRead, the output is cut back to the input length */
+    for (UINT32 off = 0; off < samples; off += FRAME_SAMPLES) {
+        INT16 decoded[FRAME_SAMPLES];
+        INT16 *block = &pcm[off];
+
+        UINT32 len = B91VoiceEncode(&enc, block, FRAME_SAMPLES, frame);
+        if (B91VoiceFrameDecode(frame, len, decoded) != FRAME_SAMPLES) {
+            fprintf(stderr, "frame %u does not decode\n", off / FRAME_SAMPLES);
+            free(pcm);
+            return 1;
+        }
+
+        /* the encoder filtered block in place, that is what the decoder has to reproduce */
+        for (UINT32 i = 0; i < FRAME_SAMPLES; ++i) {
+            double e = (double)block[i] - decoded[i];
+            signal += (double)block[i] * block[i];
+            noise += e * e;
+            block[i] = decoded[i];
+        }
+    }
+
+    double snr = (noise > 0.0) ? (10.0 * log10(signal / noise)) : INFINITY;
+    printf("%s: %u samples, %u frames, SNR %.1f dB\n", argv[1], samples,
+           (samples + FRAME_SAMPLES - 1) / FRAME_SAMPLES, snr);
+
+    INT32 ret = WavWrite(argv[2], pcm, samples);
+    free(pcm);
+
+    if (ret != 0) {
+        return 1;
+    }
+
+    return ((argc == 4) && (snr < atof(argv[3]))) ? 1 : 0;
+}
@@ -0,0 +1,98 @@
+# Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+# All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Minimal little endian ELF32 reader shared by the host tools."""
+
+import bisect
+import struct
+
+SHF_ALLOC = 0x2
+SHT_SYMTAB = 2
+SHT_NOBITS = 8
+STT_FUNC = 2
+SHN_UNDEF = 0
+
+
+class ElfImage:
+    """Gives access to allocated sections by address and to function symbols."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF' or self.data[4] != 1:
+            raise ValueError('%s is not an ELF32 file' % path)
+
+        shoff, = struct.unpack_from('<I', self.data, 0x20)
+        shentsize, shnum = struct.unpack_from('<HH', self.data, 0x2E)
+        self.headers = [struct.unpack_from('<IIIIIIIIII', self.data, shoff + i * shentsize) for i in range(shnum)]
+        self.sections = []
+        for _, sh_type, flags, addr, offset, size, _, _, _, _ in self.headers:
+            if (flags & SHF_ALLOC) and sh_type != SHT_NOBITS and size != 0:
+                self.sections.append((addr, offset, size))
+        self._functions = None
+
+    def section_list(self):
+        """Return allocated sections, including NOBITS ones, as (name, address, size)."""
+        shstrndx, = struct.unpack_from('<H', self.data, 0x32)
+        names = self.headers[shstrndx][4]
+        result = []
+        for name_off, _, flags, addr, _, size, _, _, _, _ in self.headers:
+            if flags & SHF_ALLOC:
+                end = self.data.find(b'\0', names + name_off)
+                result.append((self.data[names + name_off:end].decode('utf-8', 'replace'), addr, size))
+        return result
+
+    def string(self, addr, limit=256):
+        for start, offset, length in self.sections:
+            if start <= addr < start + length:
+                pos = offset + addr - start
+                end = self.data.find(b'\0', pos, offset + length)
+                if end < 0 or end - pos > limit:
+                    end = min(pos + limit, offset + length)
+                return self.data[pos:end].decode('utf-8', 'replace')
+        return None
+
+    def functions(self):
+        """Return function symbols as a sorted list of (address, size, name)."""
+        if self._functions is not None:
+            return self._functions
+
+        result = {}
+        for _, sh_type, _, _, offset, size, link, _, _, entsize in self.headers:
+            if sh_type != SHT_SYMTAB or entsize == 0:
+                continue
+            strtab = self.headers[link][4]
+            for pos in range(offset, offset + size, entsize):
+                name_off, value, sym_size, info, _, shndx = struct.unpack_from('<IIIBBH', self.data, pos)
+                if (info & 0xF) != STT_FUNC or shndx == SHN_UNDEF:
+                    continue
+                end = self.data.find(b'\0', strtab + name_off)
+                name = self.data[strtab + name_off:end].decode('utf-8', 'replace')
+                result[value & ~1] = (sym_size, name)
+
+        self._functions = sorted((addr, sym_size, name) for addr, (sym_size, name) in result.items())
+        self._starts = [f[0] for f in self._functions]
+        return self._functions
+
+    def symbolize(self, addr):
+        """Return the name of the function containing addr or None."""
+        functions = self.functions()
+        index = bisect.bisect_right(self._starts, addr) - 1
+        if index < 0:
+            return None
+        start, size, name = functions[index]
+        if size != 0 and addr >= start + size:
+            return None
+        return name
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+# All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Render binary HiLog records (LOSCFG_TELINK_B91_HILOG_BINARY) captured from the console UART.
+
+Plain text printed by the target is passed through unchanged, binary frames are decoded
+using the format strings stored in the unstripped ELF image.
+
+    stty -F /dev/ttyUSB0 921600 raw && hilog_decoder.py out/.../OHOS_Image < /dev/ttyUSB0
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+from elf32 import ElfImage
+
+SYNC0 = 0xA5
+SYNC1 = 0x91
+FIXED_SIZE = 13
+VALUE_MAX = 6
+
+LEVELS = {1: 'D', 2: 'I', 3: 'W', 4: 'E', 5: 'F'}
+
+SPEC_RE = re.compile(r'%(\{(?:public|private)\})?([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z|j|t)?([diouxXcspf%])')
+
+
+def format_record(elf, fmt_addr, values):
+    fmt = elf.string(fmt_addr)
+    if fmt is None:
+        return '<unknown format 0x%08x> %s' % (fmt_addr, ' '.join('0x%x' % v for v in values))
+
+    args = iter(values)
+
+    def convert(match):
+        flags, length, conv = match.group(2), match.group(3), match.group(4)
+        if conv == '%':
+            return '%'
+        try:
+            value = next(args)
+        except StopIteration:
+            return match.group(0)
+        if conv == 's':
+            text = elf.string(value)
+            return ('%' + flags + 's') % (text if text is not None else '<0x%08x>' % value)
+        if conv == 'p':
+            return '0x%08x' % value
+        if conv in 'di':
+            value = value - (1 << 32) if value & 0x80000000 else value
+        if conv == 'f':
+            value = struct.unpack('<f', struct.pack('<I', value))[0]
+        if length in ('h', 'hh'):
+            value &= 0xFFFF if length == 'h' else 0xFF
+        return ('%' + flags + conv) % value
+
+    return SPEC_RE.sub(convert, fmt)
+
+
+def decode(elf, stream, out):
+    buf = bytearray()
+    while True:
+        chunk = stream.read1(4096)
+        if not chunk:
+            break
+        buf += chunk
+
+        while buf:
+            if buf[0] != SYNC0:
+                end = buf.find(SYNC0)
+                end = len(buf) if end < 0 else end
+                out.write(buf[:end].decode('latin-1'))
+                del buf[:end]
+                continue
+
+            if len(buf) < 3:
+                break
+            length = buf[2]
+            if buf[1] != SYNC1 or length < FIXED_SIZE + 1 or length > FIXED_SIZE + VALUE_MAX * 4 + 1:
+                out.write(chr(buf[0]))
+                del buf[:1]
+                continue
+            if len(buf) < 3 + length:
+                break
+
+            payload = bytes(buf[3:3 + length])
+            if sum(payload[:-1]) & 0xFF != payload[-1]:
+                out.write(chr(buf[0]))
+                del buf[:1]
+                continue
+            del buf[:3 + length]
+
+            module, level, task, milli, seconds, fmt_addr = struct.unpack_from('<BBBHII', payload, 0)
+            count = level >> 4
+            values = struct.unpack_from('<%dI' % count, payload, FIXED_SIZE)
+            text = format_record(elf, fmt_addr, values)
+            out.write('%d.%03d %d %s %d: %s\n' % (seconds, milli, task, LEVELS.get(level & 0x0F, '?'), module,
+                                                  text.rstrip('\r\n')))
+        out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('elf', help='unstripped ELF image the target runs')
+    parser.add_argument('capture', nargs='?', help='raw UART capture, stdin if omitted')
+    args = parser.parse_args()
+
+    elf = ElfImage(args.elf)
+    if args.capture:
+        with open(args.capture, 'rb') as stream:
+            decode(elf, stream, sys.stdout)
+    else:
+        decode(elf, sys.stdin.buffer, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
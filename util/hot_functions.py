@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+# All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Place the hottest flash functions into the ILM .ram_code segment.
+
+liteos.ld includes b91/hot_functions.ld inside .ram_code. This tool regenerates that
+fragment from a B91ProfilerDump capture or from a list of symbols (one per line, hottest
+first), keeping the total size within an ILM budget. Requires -ffunction-sections.
+
+    hot_functions.py generate --budget 8192 --profile console.log OHOS_Image > b91/hot_functions.ld
+    hot_functions.py generate --budget 8192 --symbols hot.txt OHOS_Image > b91/hot_functions.ld
+    hot_functions.py report OHOS_Image
+"""
+
+import argparse
+import collections
+import sys
+
+from elf32 import ElfImage
+from profile_report import parse
+
+FLASH_BASE = 0x20000000
+ILM_BASE = 0x00000000
+ILM_SIZE = 128 * 1024
+
+# Executed from flash before BoardConfigInner has copied .ram_code
+EXCLUDE = {'reset_vector', 'HandleReset', 'BoardConfig', 'BoardConfigInner', 'CopyBuf32'}
+
+
+def ranked_from_profile(elf, path):
+    with open(path, 'r', errors='replace') as stream:
+        _, _, samples = parse(stream)
+    counter = collections.Counter()
+    for pc, _ in samples:
+        name = elf.symbolize(pc)
+        if name is not None:
+            counter[name] += 1
+    return [name for name, _ in counter.most_common()]
+
+
+def ranked_from_list(path):
+    with open(path, 'r') as f:
+        return [line.split('#', 1)[0].strip() for line in f if line.split('#', 1)[0].strip()]
+
+
+def generate(args):
+    elf = ElfImage(args.elf)
+    flash_functions = {}
+    for addr, size, name in elf.functions():
+        if addr >= FLASH_BASE and size != 0:
+            flash_functions[name] = flash_functions.get(name, 0) + size
+
+    ranked = ranked_from_profile(elf, args.profile) if args.profile else ranked_from_list(args.symbols)
+
+    budget = args.budget
+    chosen = []
+    for name in ranked:
+        if name in EXCLUDE or name not in flash_functions:
+            continue
+        size = flash_functions[name]
+        if size > budget:
+            continue
+        budget -= size
+        chosen.append((name, size))
+
+    used = args.budget - budget
+    print('/* Generated by util/hot_functions.py: %d functions, %d of %d bytes. */' %
+          (len(chosen), used, args.budget))
+    for name, size in chosen:
+        print('*(.text.%s) /* %d */' % (name, size))
+    sys.stderr.write('%d functions, %d bytes moved to ILM\n' % (len(chosen), used))
+
+
+def report(args):
+    elf = ElfImage(args.elf)
+    total = 0
+    print('%-16s %10s %8s' % ('section', 'address', 'size'))
+    for name, addr, size in elf.section_list():
+        if ILM_BASE <= addr < ILM_BASE + ILM_SIZE and size != 0 and name != '.heap':
+            print('%-16s 0x%08x %8d' % (name, addr, size))
+            total += size
+    print('ILM used by code and data: %d of %d bytes (%.1f%%), %d left for the heap' %
+          (total, ILM_SIZE, 100.0 * total / ILM_SIZE, ILM_SIZE - total))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest='command', required=True)
+
+    gen = sub.add_parser('generate', help='print a linker script fragment for .ram_code')
+    gen.add_argument('elf', help='unstripped ELF image built without the fragment')
+    gen.add_argument('--budget', type=int, required=True, help='ILM bytes available for hot functions')
+    source = gen.add_mutually_exclusive_group(required=True)
+    source.add_argument('--profile', help='console capture containing a B91ProfilerDump')
+    source.add_argument('--symbols', help='file with one function name per line, hottest first')
+    gen.set_defaults(func=generate)
+
+    rep = sub.add_parser('report', help='print the ILM usage of a linked image')
+    rep.add_argument('elf', help='unstripped ELF image')
+    rep.set_defaults(func=report)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 Telink Semiconductor (Shanghai) Co., Ltd. ("TELINK")
+# All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Symbolize samples printed by B91ProfilerDump (LOSCFG_TELINK_B91_PROFILER).
+
+Prints a flat profile, or folded "task;function count" lines for flamegraph.pl:
+
+    profile_report.py OHOS_Image console.log
+    profile_report.py --folded OHOS_Image console.log | flamegraph.pl > profile.svg
+"""
+
+import argparse
+import collections
+import sys
+
+from elf32 import ElfImage
+
+
+def parse(stream):
+    tasks = {}
+    samples = []
+    header = {}
+    for line in stream:
+        fields = line.strip().split()
+        if not fields:
+            continue
+        if fields[0] == '#prof':
+            header = dict(f.split('=', 1) for f in fields[1:] if '=' in f)
+        elif fields[0] == '#task' and len(fields) >= 3:
+            tasks[int(fields[1])] = ' '.join(fields[2:])
+        elif fields[0] == '#s' and len(fields) == 3:
+            samples.append((int(fields[1], 16), int(fields[2])))
+    return header, tasks, samples
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('elf', help='unstripped ELF image the target runs')
+    parser.add_argument('log', nargs='?', help='console capture, stdin if omitted')
+    parser.add_argument('--folded', action='store_true', help='print folded stacks for flamegraph.pl')
+    parser.add_argument('--top', type=int, default=40, help='number of rows in the flat profile')
+    args = parser.parse_args()
+
+    elf = ElfImage(args.elf)
+    if args.log:
+        with open(args.log, 'r', errors='replace') as stream:
+            header, tasks, samples = parse(stream)
+    else:
+        header, tasks, samples = parse(sys.stdin)
+
+    if not samples:
+        sys.exit('no samples found')
+
+    per_function = collections.Counter()
+    folded = collections.Counter()
+    for pc, task in samples:
+        name = elf.symbolize(pc) or '0x%08x' % pc
+        per_function[name] += 1
+        folded['%s;%s' % (tasks.get(task, 'task%d' % task), name)] += 1
+
+    if args.folded:
+        for stack, count in sorted(folded.items()):
+            print('%s %d' % (stack, count))
+        return
+
+    total = len(samples)
+    print('%d samples at %s Hz, %s lost' % (total, header.get('hz', '?'), header.get('lost', '?')))
+    print('%7s %8s  %s' % ('%', 'samples', 'function'))
+    for name, count in per_function.most_common(args.top):
+        print('%6.2f%% %8d  %s' % (100.0 * count / total, count, name))
+
+    print()
+    print('%7s %8s  %s' % ('%', 'samples', 'task'))
+    for task, count in collections.Counter(t for _, t in samples).most_common():
+        print('%6.2f%% %8d  %s' % (100.0 * count / total, count, tasks.get(task, 'task%d' % task)))
+
+
+if __name__ == '__main__':
+    main()